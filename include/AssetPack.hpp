@@ -0,0 +1,112 @@
+#pragma once
+
+#include <MappedFile.hpp>
+
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/IOStream.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Layout of a .pack file: a PackHeader, the data of every entry at its own alignment, then the index, which is one
+// PackEntry per asset followed by its path. Paths are stored normalised and relative to where the packer ran
+// ("assets/rock/rock.png"), the same way the app spells them.
+inline constexpr char PackMagic[4]{ 'P', 'A', 'C', 'K' };
+inline constexpr std::uint32_t PackVersion{ 1 };
+
+enum PackEntryFlags : std::uint16_t {
+    PACK_COMPRESSED = 1 << 0,
+};
+
+struct PackHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t reserved;
+    std::uint64_t indexOffset;
+    std::uint64_t indexSize;
+};
+
+struct PackEntry {
+    std::uint64_t offset;
+    // Bytes in the pack, smaller than size when the entry is zlib compressed.
+    std::uint64_t storedSize;
+    std::uint64_t size;
+    std::uint32_t pathLength;
+    std::uint16_t flags;
+    std::uint16_t alignmentLog2;
+};
+
+static_assert(sizeof(PackHeader) == 32 && sizeof(PackEntry) == 32, "Pack structs are written to disk as they are");
+
+// A pack mapped into memory. Stored entries are handed out as views straight into the mapping, compressed ones are
+// inflated the first time they are asked for and kept for the lifetime of the pack.
+class AssetPack {
+public:
+    explicit AssetPack(const std::string& path);
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return opened; }
+    [[nodiscard]] const std::vector<std::string>& paths() const { return entryPaths; }
+
+    // Points bytes at the contents of path and returns true, or returns false when the pack doesn't have it.
+    [[nodiscard]] bool find(const std::string& path, std::span<const char>& bytes) const;
+    // Whether the pack has path, without inflating it.
+    [[nodiscard]] bool contains(const std::string& path) const;
+
+private:
+    MappedFile file;
+    bool opened{ false };
+    std::vector<PackEntry> entries;
+    std::vector<std::string> entryPaths;
+    std::unordered_map<std::string, std::size_t> lookup;
+
+    mutable std::mutex inflateMutex;
+    mutable std::unordered_map<std::size_t, std::vector<char>> inflated;
+};
+
+// The loaders look in the mounted pack first and only go to the loose file when it's not there. Nothing is mounted
+// by default, the pack must outlive its mount.
+void mountAssetPack(const AssetPack* pack);
+[[nodiscard]] const AssetPack* mountedAssetPack();
+
+// The path in the form the packer stores it.
+[[nodiscard]] std::string normaliseAssetPath(const std::string& path);
+
+// Looks path up in the mounted pack, false when nothing is mounted or the pack doesn't have it.
+[[nodiscard]] bool findAsset(const std::string& path, std::span<const char>& bytes);
+[[nodiscard]] bool hasAsset(const std::string& path);
+
+// Contents of one asset, from the mounted pack when it's there and from a mapping of the loose file otherwise.
+class AssetFile {
+public:
+    explicit AssetFile(const std::string& path);
+
+    AssetFile(const AssetFile&) = delete;
+    AssetFile& operator=(const AssetFile&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return opened; }
+    [[nodiscard]] const char* begin() const { return bytes.data(); }
+    [[nodiscard]] const char* end() const { return bytes.data() + bytes.size(); }
+    [[nodiscard]] std::size_t size() const { return bytes.size(); }
+
+private:
+    std::unique_ptr<MappedFile> mapped;
+    std::span<const char> bytes;
+    bool opened{ false };
+};
+
+// Lets Assimp read from the mounted pack, anything not packed goes through the default file system.
+class PackIOSystem : public Assimp::DefaultIOSystem {
+public:
+    bool Exists(const char* file) const override;
+    Assimp::IOStream* Open(const char* file, const char* mode = "rb") override;
+};
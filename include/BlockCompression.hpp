@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// The S3TC/RGTC block formats we encode to. Every one stores a 4x4 texel block in 8 or 16 bytes.
+enum class BlockFormat {
+    BC1, // RGB, 4 bits per texel.
+    BC3, // RGBA, BC1 colour plus a BC4 alpha block, 8 bits per texel.
+    BC4, // One channel, taken from red, 4 bits per texel.
+    BC5, // Two channels, red and green each as a BC4 block, 8 bits per texel.
+};
+
+[[nodiscard]] std::size_t blockBytes(BlockFormat format);
+[[nodiscard]] std::size_t compressedSize(BlockFormat format, int width, int height);
+
+// Encodes a tightly packed RGBA8 image. Sizes need not be multiples of 4, edge blocks repeat the last row and column.
+[[nodiscard]] std::vector<unsigned char> compressBlocks(const unsigned char* rgba, int width, int height,
+                                                       BlockFormat format);
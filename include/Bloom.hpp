@@ -0,0 +1,101 @@
+#pragma once
+
+#include <FrameGraph.hpp>
+#include <Shader.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+enum class BloomMode {
+    GAUSSIAN,    // Ten separable Gaussian passes ping-ponging, or five compute dispatches doing two each. At full
+                 // resolution unless GaussianBlurSettings say not.
+    PROGRESSIVE, // A 13-tap downsample chain down to 1/64 resolution, then tent filtered back up adding every level.
+};
+
+struct GaussianBlurSettings {
+    // In texels of the blurred targets, rounded up to one of Bloom::BlurRadii.
+    int radius{ 4 };
+    // Merges neighbouring taps into one bilinear fetch, half as many fetches for the same kernel. Fragment shader blurs
+    // only.
+    bool linearSampling{ true };
+    // Blurs in compute shaders where the context has them. A workgroup fetches a tile of the target and the apron the
+    // kernel reaches into once, into shared memory, then blurs it both ways there and writes the result as an image.
+    // Five dispatches instead of ten passes, and an eighth of the fetches, but llvmpipe runs it at half the speed of
+    // the fragment shaders, so it is off unless asked for.
+    bool compute{ false };
+    // Blurs at 1/downscale of the bright target's size, 1, 2 or 4. A texel then covers downscale pixels, so the same
+    // kernel reaches that much further across the screen. The bright target is brought down to that size by the
+    // progressive bloom's 13-tap downsample first, halving it once per pass.
+    int downscale{ 1 };
+};
+
+// Blurs the bright fragments the scene pass writes, for the tonemap pass to add back onto the scene. The shaders are
+// loaded when it is made. Every call has to be made on the thread that owns the GL context, and the bloom has to go
+// before the context does:
+//     Bloom bloom;
+//     ...
+//     const FrameResource blurred{ bloom.addPasses(frameGraph, brightColour, hdrTarget, BloomMode::PROGRESSIVE) };
+//     // In the tonemap pass:
+//     shaderBloomFinal.setUniformFloat("bloomStrength", Bloom::strength(BloomMode::PROGRESSIVE));
+class Bloom {
+public:
+    // Levels of the progressive chain, each half the size of the one before.
+    static constexpr int ProgressiveLevels{ 6 };
+    static constexpr unsigned int GaussianPasses{ 10 };
+    // The Gaussian kernels blur.fs is built for, with a sigma of half the radius.
+    static constexpr std::array<int, 3> BlurRadii{ 4, 8, 16 };
+    // Texels along a side of the tile a compute blur's workgroup writes, TILE_SIZE in blur.cs.
+    static constexpr int ComputeTileSize{ 16 };
+
+    Bloom();
+    ~Bloom();
+
+    Bloom(const Bloom&) = delete;
+    Bloom& operator=(const Bloom&) = delete;
+
+    // Adds the passes blurring bright, a target of desc, to graph and returns the blurred target. It can be smaller
+    // than desc, it is meant to be sampled with bilinear filtering.
+    [[nodiscard]] FrameResource addPasses(FrameGraph& graph, FrameResource bright, const RenderTargetDesc& desc,
+                                          BloomMode mode);
+    // What the blurred target is scaled by before it is added to the scene. The progressive chain sums a blurred copy
+    // of the bright fragments per level.
+    [[nodiscard]] static float strength(BloomMode mode);
+
+    // How far the progressive upsample's tent reaches at every level, as a fraction of the screen's height. The
+    // bloom's size comes from this and the depth of the chain, not from how many passes it takes.
+    float radius{ .005f };
+    GaussianBlurSettings gaussian;
+
+    // Texture fetches the passes from the last addPasses call make, if none of them are culled.
+    [[nodiscard]] std::size_t fetches() const;
+
+private:
+    struct BlurVariant {
+        Shader shader;
+        int radius;
+        bool linearSampling;
+        bool compute;
+        // Per side, centre included.
+        std::size_t taps;
+    };
+
+    std::vector<BlurVariant> blurVariants;
+    Shader downsample;
+    Shader upsample;
+    unsigned int quadVAO{ 0 };
+    unsigned int quadVBO{ 0 };
+    std::size_t passFetches{ 0 };
+    // What each compute blur pass of the frame being built writes, which only its setup gets to see.
+    std::array<FrameResource, GaussianPasses / 2> computeTargets{};
+
+    void drawQuad() const;
+    [[nodiscard]] bool computeBlur() const;
+    const BlurVariant& blurVariant() const;
+    // Downsamples bright to the size the Gaussian blurs at and returns it, with its desc in scaledDesc.
+    FrameResource addDownscalePasses(FrameGraph& graph, FrameResource bright, const RenderTargetDesc& desc,
+                                     RenderTargetDesc& scaledDesc);
+    FrameResource addGaussianPasses(FrameGraph& graph, FrameResource bright, const RenderTargetDesc& desc);
+    FrameResource addComputeBlurPasses(FrameGraph& graph, FrameResource bright, const RenderTargetDesc& desc);
+    FrameResource addProgressivePasses(FrameGraph& graph, FrameResource bright, const RenderTargetDesc& desc);
+};
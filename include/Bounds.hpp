@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+struct Vertex;
+
+struct AABB {
+    glm::vec3 min{ 0.f };
+    glm::vec3 max{ 0.f };
+
+    [[nodiscard]] glm::vec3 centre() const { return (min + max) * .5f; }
+    [[nodiscard]] glm::vec3 extents() const { return (max - min) * .5f; }
+};
+
+struct BoundingSphere {
+    glm::vec3 centre{ 0.f };
+    float radius{ 0.f };
+};
+
+// Object space extent of a mesh or a whole model. Empty meshes get a zero sized box at the origin.
+struct Bounds {
+    AABB box;
+    BoundingSphere sphere;
+};
+
+// Tight box over the vertex positions, and the sphere around the box centre that just reaches the farthest vertex.
+[[nodiscard]] Bounds computeBounds(const std::vector<Vertex>& vertices);
+
+// Smallest box holding both, with the sphere built around its centre from the two input spheres.
+[[nodiscard]] Bounds mergeBounds(const Bounds& a, const Bounds& b);
+
+// World space versions for a model matrix. The box stays axis aligned (and grows under rotation), the sphere radius is
+// scaled by the largest axis scale.
+[[nodiscard]] AABB transformAABB(const AABB& box, const glm::mat4& transform);
+[[nodiscard]] BoundingSphere transformSphere(const BoundingSphere& sphere, const glm::mat4& transform);
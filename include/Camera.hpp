@@ -4,6 +4,8 @@
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 
+#include <Bounds.hpp>
+
 #include <iostream>
 #include <cmath>
 
@@ -86,8 +88,28 @@ public:
         return rotationMat * translationMat;
     }
 
+    // Roughly how many pixels tall sphere appears on a viewport viewportHeight pixels high, for picking a level of
+    // detail. Uses the distance to the centre rather than the depth, so it doesn't change as the camera turns.
+    float projectedSize(const BoundingSphere& sphere, const float viewportHeight) const {
+        const float distance{ glm::length(sphere.centre - position) };
+        if(distance <= sphere.radius) {
+            return viewportHeight;
+        }
+        return sphere.radius / (distance * std::tan(glm::radians(zoom) * .5f)) * viewportHeight;
+    }
+
+    // Puts the camera exactly where a recording had it, for playback.
+    void setPose(const glm::vec3& aPosition, const float aYaw, const float aPitch, const float aZoom) {
+        position = aPosition;
+        yaw = aYaw;
+        pitch = aPitch;
+        zoom = aZoom;
+
+        updateCameraVectors();
+    }
+
     void processKeyboard(const CameraMovementOptions direction, const float deltaTime) {
-        const static float velocity = movementSpeed * deltaTime;
+        const float velocity{ movementSpeed * deltaTime };
 
         if(direction == CameraMovementOptions::FORWARD) {
             position += front * velocity;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// Where one simulation step left the camera.
+struct CameraSample {
+    glm::vec3 position{ 0.f };
+    float yaw{ 0.f };
+    float pitch{ 0.f };
+    float zoom{ 0.f };
+};
+
+// A flythrough recorded from a live run, one sample per simulation step. Playing it back drives the camera with no
+// input, so perf runs of a scene see exactly the same views every time.
+struct CameraPath {
+    double stepSeconds{ 0.0 };
+    std::vector<CameraSample> samples;
+};
+
+// Little endian: an identifier and version, stepSeconds, the sample count, then six floats per sample.
+[[nodiscard]] bool writeCameraPath(const std::string& path, const CameraPath& cameraPath);
+[[nodiscard]] bool readCameraPath(const std::string& path, CameraPath& cameraPath);
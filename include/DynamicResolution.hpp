@@ -0,0 +1,78 @@
+#pragma once
+
+#include <FrameGraph.hpp>
+#include <FrameTimer.hpp>
+
+#include <array>
+#include <cstddef>
+
+// Over every frame update picked a scale for.
+struct RenderScaleStats {
+    std::size_t frames{ 0 };
+    double scaleSum{ 0.0 };
+    float lowestScale{ 0.f };
+    std::size_t belowFullFrames{ 0 };
+};
+
+// Picks the scale the scene's render targets are drawn at from how long the GPU took over the frames before, so the
+// frame stays within gpuBudgetMs when the load goes up, and returns to full resolution once it comes down. The GPU
+// time of a frame is taken to grow with its pixels, so every measured frame gives an estimate of what a frame at full
+// resolution costs. The median of the last few is used, so a single hitch doesn't move the scale but a heavier load
+// does within a few frames. The scale moves in steps of ScaleStep, down as far as the estimate
+// says it has to at once but up a step at a time, and only once frames drawn at the current scale have been measured.
+// A budget of 0 keeps it at maxScale:
+//     DynamicResolution resolution{ 1000.0 / 60.0 };
+//     while(running) {
+//         frameTimer.beginFrame(inputSampled);
+//         resolution.update(frameTimer);
+//         const RenderTargetDesc sceneTarget{ resolution.scaled({ framebufferWidth, framebufferHeight, GL_RGBA16F }) };
+//         ...
+//         frameTimer.endFrame();
+//     }
+// Distinct scales make distinct render target sizes, which the frame graph pools separately, so stepping keeps the
+// number of them small.
+class DynamicResolution {
+public:
+    static constexpr float ScaleStep{ .05f };
+    // Frames drawn at a new scale that have to be measured before it moves again.
+    static constexpr std::size_t SettleFrames{ 4 };
+
+    explicit DynamicResolution(double gpuBudgetMs, float minScale = .5f, float maxScale = 1.f);
+
+    // Takes the GPU times that have come in since the last call and picks the scale for the frame about to be drawn.
+    // Call once per frame, after timer.beginFrame and before the frame's targets are declared, so the timer's frame
+    // numbers are the frames update picked scales for.
+    float update(const FrameTimer& timer);
+
+    [[nodiscard]] float scale() const;
+    // desc at the current scale, at least a texel across.
+    [[nodiscard]] RenderTargetDesc scaled(const RenderTargetDesc& desc) const;
+    [[nodiscard]] const RenderScaleStats& stats() const;
+
+private:
+    // Frames aim for this much of the budget, so a little more load doesn't go over straight away.
+    static constexpr double TargetFraction{ .9 };
+    // The scale goes up once a frame at it is estimated to take less than this much of the budget.
+    static constexpr double RaiseFraction{ .75 };
+    // Measured frames the median is taken over.
+    static constexpr std::size_t EstimateFrames{ 5 };
+    // Frames whose scales are kept for their GPU times, well past the few FrameTimer has in flight.
+    static constexpr std::size_t RecentFrames{ 16 };
+
+    double budgetMs;
+    int minSteps;
+    int maxSteps;
+    int steps;
+    // The scales of the last RecentFrames frames, by frame number modulo RecentFrames.
+    std::array<float, RecentFrames> recentScales{};
+    RenderScaleStats scaleStats;
+    std::size_t nextTiming{ 0 };
+    // The first frame drawn at the current scale.
+    std::size_t changedAt{ 0 };
+    // What the last EstimateFrames measured frames would have taken at full resolution, oldest overwritten first.
+    std::array<double, EstimateFrames> estimates{};
+    std::size_t estimateCount{ 0 };
+
+    [[nodiscard]] double fullResolutionMs() const;
+    [[nodiscard]] int pickSteps() const;
+};
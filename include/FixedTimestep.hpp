@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Splits real frame time into simulation steps of a fixed length, so the simulation gives the same result at any frame
+// rate and a replayed run steps through exactly what the recorded one did. Time left over after the last whole step
+// carries into the next frame, and rendering blends the last two simulated states by how far into the next step it
+// is (alpha):
+//     const unsigned int steps{ timestep.advance(frameSeconds) };
+//     for(unsigned int i = 0; i < steps; ++i) {
+//         previous = current;
+//         simulate(current, timestep.step());
+//     }
+//     render(mix(previous, current, timestep.alpha()));
+// At most maxStepsPerFrame are simulated per frame. Past that the rest of the frame's time is dropped and the
+// simulation falls behind real time, rather than a slow frame queueing up steps that make the next frame slower still.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double stepLength = 1.0 / 120.0, unsigned int maxStepsPerFrame = 8);
+
+    // Adds frameSeconds of real time and returns how many steps to simulate for it.
+    [[nodiscard]] unsigned int advance(double frameSeconds);
+
+    [[nodiscard]] float step() const;
+    // Where rendering sits between the last two simulated states, 0 at the older and below 1.
+    [[nodiscard]] float alpha() const;
+    // Steps simulated since the start.
+    [[nodiscard]] std::uint64_t stepCount() const;
+    // Seconds of real time dropped by frames that needed more than maxStepsPerFrame.
+    [[nodiscard]] double droppedSeconds() const;
+
+private:
+    double stepSeconds;
+    unsigned int maxSteps;
+    double accumulated{ 0.0 };
+    double dropped{ 0.0 };
+    std::uint64_t steps{ 0 };
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// What a render target is made of. Targets with the same description can share a texture.
+struct RenderTargetDesc {
+    int width{ 0 };
+    int height{ 0 };
+    GLenum internalFormat{ GL_RGBA16F };
+
+    bool operator==(const RenderTargetDesc&) const = default;
+};
+
+// Bytes a target of desc takes on the GPU.
+[[nodiscard]] std::size_t renderTargetBytes(const RenderTargetDesc& desc);
+
+// A render target declared in the frame being built, only meaningful to the graph that handed it out.
+using FrameResource = std::uint32_t;
+
+// What the last execute() saw, for monitoring.
+struct FrameGraphStats {
+    std::size_t passes{ 0 };
+    std::size_t culledPasses{ 0 };
+    std::size_t resources{ 0 };
+    // Render targets the passes left standing declared, what they would take with a texture each, and the textures the
+    // pool actually holds for them.
+    std::size_t transientBytes{ 0 };
+    std::size_t pooledBytes{ 0 };
+    std::size_t peakPooledBytes{ 0 };
+    // The targets passes left standing read, a target read by two passes counted twice. With transientBytes, what the
+    // passes move to and from render targets if every texel is touched once.
+    std::size_t readBytes{ 0 };
+};
+
+class FrameGraph;
+
+// Handed to a pass's setup to declare the targets it renders to and the ones it samples.
+class FramePassBuilder {
+public:
+    // A new target the pass renders to. Colour targets are attached in the order they are created.
+    FrameResource createColour(const std::string& name, const RenderTargetDesc& desc);
+    FrameResource createDepth(const std::string& name, const RenderTargetDesc& desc);
+    // A target an earlier pass created, which this one samples.
+    void read(FrameResource resource);
+    // The pass draws to the default framebuffer. Only passes that do, and the ones they read from, are run.
+    void writeBackbuffer();
+    // The pass writes its colour targets as images from compute shaders instead of drawing to them, so it gets no
+    // framebuffer or viewport. It has to put up its own memory barrier for the passes reading them.
+    void compute();
+
+private:
+    friend class FrameGraph;
+    FramePassBuilder(FrameGraph& owner, std::size_t index);
+
+    FrameGraph& graph;
+    std::size_t pass;
+};
+
+// Handed to a pass when it runs, to look up the textures behind the targets it reads.
+class FramePassResources {
+public:
+    [[nodiscard]] unsigned int texture(FrameResource resource) const;
+
+private:
+    friend class FrameGraph;
+    explicit FramePassResources(const FrameGraph& owner);
+
+    const FrameGraph& graph;
+};
+
+// The frame's render passes, declared every frame with what they read and write, rather than framebuffers set up by
+// hand once. execute() runs them in the order they were added, after it
+//   - culls every pass nothing drawn to the default framebuffer depends on, and skips colour targets nobody reads,
+//   - hands out textures from a pool that outlives the frame, and takes a texture back once the last pass reading it
+//     has run, so a later target with the same description renders into it. Targets whose lifetimes don't overlap
+//     share memory that way,
+//   - binds a framebuffer per set of attachments, cached across frames, and sets the viewport to the targets' size.
+// Pool textures are registered with the active TextureManager. Ones no frame has used for a while are released. Every
+// call has to be made on the thread that owns the GL context, and the graph has to go before the context does:
+//     FrameResource colour{};
+//     frameGraph.addPass("scene", [&](FramePassBuilder& pass) {
+//         colour = pass.createColour("scene colour", { 1920, 1080, GL_RGBA16F });
+//         pass.createDepth("scene depth", { 1920, 1080, GL_DEPTH_COMPONENT24 });
+//     }, [&](const FramePassResources&) { ... draw ... });
+//     frameGraph.addPass("tonemap", [&](FramePassBuilder& pass) {
+//         pass.read(colour);
+//         pass.writeBackbuffer();
+//     }, [&](const FramePassResources& resources) { bindTexture(0, GL_TEXTURE_2D, resources.texture(colour)); ... });
+//     frameGraph.execute();
+class FrameGraph {
+public:
+    FrameGraph() = default;
+    // Deletes the framebuffers and releases every pooled texture.
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    // Runs setup right away, execute during execute() unless the pass is culled. Whatever either captures by reference
+    // has to last until then.
+    void addPass(const std::string& name, const std::function<void(FramePassBuilder&)>& setup,
+                 std::function<void(const FramePassResources&)> execute);
+    // Culls, hands out textures and runs the passes, then forgets them so the next frame can declare its own.
+    void execute();
+
+    // Releases every pooled texture the last execute() didn't use, rather than waiting for them to go unused for a
+    // while. For after the targets change size, when the old ones won't be asked for again soon.
+    void trim();
+
+    [[nodiscard]] const FrameGraphStats& stats() const;
+
+private:
+    friend class FramePassBuilder;
+    friend class FramePassResources;
+
+    static constexpr std::size_t NoIndex{ SIZE_MAX };
+    // Frames a pooled texture may go unused before it is released.
+    static constexpr std::uint64_t UnusedFramesBeforeRelease{ 120 };
+
+    struct Resource {
+        std::string name;
+        RenderTargetDesc desc;
+        bool depth{ false };
+        std::size_t writer{ NoIndex };
+        // Passes left standing that read it, and the last of them.
+        std::size_t readers{ 0 };
+        std::size_t lastReader{ NoIndex };
+        std::size_t pooled{ NoIndex };
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<FrameResource> reads;
+        std::vector<FrameResource> colourWrites;
+        FrameResource depthWrite{ 0 };
+        bool writesDepth{ false };
+        bool writesBackbuffer{ false };
+        bool compute{ false };
+        // Targets it writes that are read, plus one for the backbuffer. Culled when it drops to 0.
+        std::size_t references{ 0 };
+        bool culled{ false };
+        std::function<void(const FramePassResources&)> execute;
+    };
+
+    struct PooledTarget {
+        RenderTargetDesc desc;
+        unsigned int texture{ 0 };
+        bool inUse{ false };
+        std::uint64_t lastUsedFrame{ 0 };
+    };
+
+    std::vector<Pass> passes;
+    std::vector<Resource> resources;
+    std::vector<PooledTarget> pool;
+    // Attached textures, colour then depth with 0 for an empty slot, to the framebuffer they are attached to.
+    std::map<std::vector<unsigned int>, unsigned int> framebuffers;
+    std::uint64_t frameNumber{ 0 };
+    FrameGraphStats frameStats;
+
+    FrameResource createResource(std::size_t pass, const std::string& name, const RenderTargetDesc& desc, bool depth);
+    void cull();
+    // 0 for targets given no memory.
+    [[nodiscard]] unsigned int textureOf(FrameResource resource) const;
+    std::size_t acquire(const RenderTargetDesc& desc);
+    // Releases the pooled textures no frame has used for more than frames frames.
+    void releaseUnused(std::uint64_t frames);
+    unsigned int framebufferFor(const Pass& pass);
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+struct FrameTiming {
+    // From beginFrame to endFrame on the context thread.
+    double cpuMs{ 0.0 };
+    // What the GPU spent on the commands issued in between, negative until it is known.
+    double gpuMs{ -1.0 };
+    // From sampling the input the frame was drawn with to the GPU finishing the frame, swap included. Scanout adds up
+    // to another refresh on top. Negative until it is known.
+    double latencyMs{ -1.0 };
+};
+
+// Sums over every frame timed so far, of the times that are known.
+struct FrameTimingTotals {
+    std::size_t frames{ 0 };
+    double cpuMs{ 0.0 };
+    std::size_t gpuFrames{ 0 };
+    double gpuMs{ 0.0 };
+    std::size_t latencyFrames{ 0 };
+    double latencyMs{ 0.0 };
+    double worstLatencyMs{ 0.0 };
+};
+
+// Times every frame on the CPU, and on the GPU through GL_TIME_ELAPSED queries. A GL_TIMESTAMP query after the swap
+// says when the GPU finished presenting, put on the CPU's clock with an offset measured when the timer is made. Queries
+// are only read back when their slot in the ring comes round again, framesInFlight frames later, by which time the GPU
+// has long finished them, so timing never stalls the frame. Every call has to be made on the thread that owns the GL
+// context, and the timer has to go before the context does.
+// Frames are numbered from 0 in the order they are timed. Only the last RecentFrames are kept, unless keepAllFrames
+// asks for every one, for a run that writes them out at the end. totals() covers every frame either way.
+class FrameTimer {
+public:
+    static constexpr std::size_t RecentFrames{ 256 };
+
+    explicit FrameTimer(std::size_t framesInFlight = 4, bool keepAllFrames = false);
+    ~FrameTimer();
+
+    FrameTimer(const FrameTimer&) = delete;
+    FrameTimer& operator=(const FrameTimer&) = delete;
+
+    // inputSampled is when the input this frame is drawn with was polled.
+    void beginFrame(std::chrono::steady_clock::time_point inputSampled);
+    void endFrame();
+    // Right after the swap of the frame that just ended.
+    void presented();
+    // Waits for the GPU times of the frames still in flight.
+    void finish();
+
+    // Frames that have ended so far.
+    [[nodiscard]] std::size_t frameCount() const;
+    // The oldest frame still kept.
+    [[nodiscard]] std::size_t firstKeptFrame() const;
+    // frame has to be kept, from firstKeptFrame() up to frameCount().
+    [[nodiscard]] const FrameTiming& timing(std::size_t frame) const;
+    [[nodiscard]] const FrameTimingTotals& totals() const;
+
+private:
+    static constexpr std::size_t NoFrame{ SIZE_MAX };
+
+    struct Slot {
+        unsigned int elapsedQuery{ 0 };
+        unsigned int presentQuery{ 0 };
+        // The frame the slot's queries are waiting to be read back for, if any.
+        std::size_t frame{ NoFrame };
+        bool presented{ false };
+        std::chrono::steady_clock::time_point inputSampled;
+    };
+
+    std::vector<Slot> slots;
+    bool keepAll;
+    std::size_t nextSlot{ 0 };
+    std::chrono::steady_clock::time_point frameStart;
+    std::chrono::steady_clock::time_point frameInput;
+    // GPU timestamp minus steady_clock, in nanoseconds.
+    std::int64_t gpuClockOffset{ 0 };
+    std::deque<FrameTiming> frames;
+    std::size_t firstFrame{ 0 };
+    FrameTimingTotals frameTotals;
+
+    void collect(Slot& slot);
+};
+
+// One line per kept frame after a header: frame, cpu_ms, gpu_ms, latency_ms.
+[[nodiscard]] bool writeFrameTimings(const std::string& path, const FrameTimer& timer);
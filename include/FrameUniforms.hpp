@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// The Camera uniform block of the scene shaders, std140.
+struct CameraUniforms {
+    glm::mat4 projection{ 1.f };
+    glm::mat4 view{ 1.f };
+    glm::vec3 viewPosition{ 0.f };
+    float padding{ 0.f };
+};
+
+static constexpr unsigned int CameraUniformBinding{ 0 };
+
+// Per-frame uniforms, written once a frame into a ring of uniform buffer regions, one per frame in flight, and bound to
+// CameraUniformBinding. The camera goes in with a single write right before the frame's draws are issued, rather than
+// through a setMat4 per shader while they are. A region is only written again once the GPU has finished the frame that
+// read it, beginFrame waits for that. With one frame in flight that wait keeps the CPU from running ahead of the GPU,
+// so input sampled after it is never more than a frame old when it is shown. Every call has to be made on the thread
+// that owns the GL context, and the ring has to go before the context does:
+//     frameUniforms.beginFrame();
+//     ... sample input, cull ...
+//     frameUniforms.write(camera);
+//     ... draw ...
+//     glfwSwapBuffers(window);
+//     frameUniforms.endFrame();
+class FrameUniforms {
+public:
+    explicit FrameUniforms(std::size_t framesInFlight = 3);
+    ~FrameUniforms();
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // Waits until the GPU is done with the region this frame writes.
+    void beginFrame();
+    void write(const CameraUniforms& camera);
+    // Fences the frame just submitted.
+    void endFrame();
+
+private:
+    unsigned int buffer{ 0 };
+    std::size_t regionBytes{ 0 };
+    std::vector<GLsync> fences;
+    std::size_t nextRegion{ 0 };
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Bounds.hpp>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Six planes facing inwards as (normal, distance), normalised, so dot(normal, p) + distance is the signed distance of
+// p from the plane. A point is inside the frustum when it is in front of every plane.
+struct Frustum {
+    enum Side { LEFT, RIGHT, BOTTOM, TOP, NEAR, FAR };
+
+    std::array<glm::vec4, 6> planes;
+};
+
+// Gribb and Hartmann: the planes fall out of sums and differences of the rows of projection * view, in world space.
+[[nodiscard]] Frustum extractFrustum(const glm::mat4& viewProjection);
+
+// Conservative tests: anything crossing a plane counts as inside, and so can a box near a corner that only misses the
+// frustum diagonally.
+[[nodiscard]] bool intersects(const Frustum& frustum, const AABB& box);
+[[nodiscard]] bool intersects(const Frustum& frustum, const BoundingSphere& sphere);
+
+// Boxes as centres and half extents in structure of arrays layout, so the culling kernel loads the same component of
+// eight boxes at once.
+struct AABBArray {
+    std::vector<float> centreX, centreY, centreZ;
+    std::vector<float> extentX, extentY, extentZ;
+
+    void push(const AABB& box);
+    void clear();
+    [[nodiscard]] std::size_t size() const { return centreX.size(); }
+};
+
+struct SphereArray {
+    std::vector<float> centreX, centreY, centreZ;
+    std::vector<float> radius;
+
+    void push(const BoundingSphere& sphere);
+    void clear();
+    [[nodiscard]] std::size_t size() const { return centreX.size(); }
+};
+
+// Tests every box or sphere against the frustum, eight per iteration, and writes the indices of the visible ones to
+// visible in order. visible needs room for one index per box, every lane is written whether it is visible or not so the
+// loop never branches on the result. Returns how many are visible. Uses AVX when built with it, SSE otherwise, and
+// agrees with intersects() exactly either way.
+[[nodiscard]] std::size_t cullAABBs(const Frustum& frustum, const AABBArray& boxes, std::uint32_t* visible);
+[[nodiscard]] std::size_t cullSpheres(const Frustum& frustum, const SphereArray& spheres, std::uint32_t* visible);
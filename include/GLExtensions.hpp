@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+// Our glad is generated for the 3.3 core profile without extensions, so enums from extensions we check for at runtime
+// are spelled out here.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_TEXTURE_FETCH_BARRIER_BIT
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#endif
+
+// glTexStorage2D is core from 4.2 and ARB_texture_storage before that. loadGLExtensions leaves it null when the
+// context has neither.
+typedef void (APIENTRYP TexStorage2DProc)(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width,
+                                          GLsizei height);
+extern TexStorage2DProc texStorage2D;
+// glTexStorage3D comes with it, for arrays, and is loaded under the same conditions.
+typedef void (APIENTRYP TexStorage3DProc)(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width,
+                                          GLsizei height, GLsizei depth);
+extern TexStorage3DProc texStorage3D;
+
+// glBufferStorage is core from 4.4 and ARB_buffer_storage before that, null without either. Buffers it creates can stay
+// mapped while the GPU reads from them.
+typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+extern BufferStorageProc bufferStorage;
+
+// Compute shaders and the image load/store they write with. The shaders using them are written for GLSL 4.30, so these
+// are only loaded from a 4.3 context and are null otherwise.
+typedef void (APIENTRYP DispatchComputeProc)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+typedef void (APIENTRYP BindImageTextureProc)(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer,
+                                              GLenum access, GLenum format);
+typedef void (APIENTRYP MemoryBarrierProc)(GLbitfield barriers);
+extern DispatchComputeProc dispatchCompute;
+extern BindImageTextureProc bindImageTexture;
+extern MemoryBarrierProc memoryBarrier;
+
+// Loads the entry points above. Call right after gladLoadGLLoader, with the same loader.
+void loadGLExtensions(GLADloadproc load);
+
+// Whether the current context advertises name. The list is read once, on the first call, which has to be made on the
+// thread that owns the context.
+[[nodiscard]] bool hasGLExtension(const std::string& name);
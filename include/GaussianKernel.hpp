@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// One side of a symmetric blur kernel, centre tap first, offsets in texels. Every tap but the centre is sampled on both
+// sides, so the weights of the centre plus twice the rest sum to 1.
+struct GaussianKernel {
+    std::vector<float> offsets;
+    std::vector<float> weights;
+};
+
+// A tap per texel out to radius, weighted by a Gaussian of sigma and normalised, so no light is lost to the cut off
+// tails.
+[[nodiscard]] GaussianKernel gaussianKernel(float sigma, int radius);
+// The same kernel with every pair of neighbouring taps after the centre merged into one bilinear fetch between them,
+// weighted so the filtering hardware mixes the two texels in the right proportion. Half the fetches for the same
+// result, as long as the texture is sampled with linear filtering.
+[[nodiscard]] GaussianKernel linearSampledKernel(const GaussianKernel& kernel);
+// The kernel as BLUR_TAPS, BLUR_OFFSETS and BLUR_WEIGHTS, for a ShaderDefines to build a blur.fs variant with.
+[[nodiscard]] std::string kernelDefines(const GaussianKernel& kernel);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <AssetPack.hpp>
+
+#include <assimp/IOStream.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+
+// Wall time and heap bytes spent in one stage of a model import. A stage may be entered many times (one per mesh or
+// texture), calls counts how often.
+struct ImportStageStats {
+    std::string name;
+    double seconds{ 0.0 };
+    std::size_t allocatedBytes{ 0 };
+    unsigned int calls{ 0 };
+};
+
+struct ImportProfile {
+    std::string path;
+    double totalSeconds{ 0.0 };
+    std::size_t totalAllocatedBytes{ 0 };
+    // A deque so references handed to nested stages survive new stages being appended.
+    std::deque<ImportStageStats> stages;
+
+    // Returns the stage with that name, appending it the first time so the table keeps pipeline order.
+    ImportStageStats& stage(const std::string& name);
+};
+
+// Profiling is per thread: while a profile is active every ScopedImportStage on the same thread records into it.
+void beginImportProfile(ImportProfile* profile);
+void endImportProfile();
+[[nodiscard]] ImportProfile* activeImportProfile();
+
+// Bytes handed out by operator new on the calling thread since it started. Only binaries linking AllocationCounter.o,
+// which replaces the global operator new to call countThreadAllocation, count anything, the rest always see 0.
+// Allocations made through malloc (stb_image) are not seen here, callers add those explicitly with
+// ScopedImportStage::addBytes.
+void countThreadAllocation(std::size_t bytes);
+[[nodiscard]] std::size_t threadAllocatedBytes();
+
+// Measures the lifetime of the object into the named stage of the active profile. Does nothing when profiling is off,
+// so it can stay in the hot path of Model.
+class ScopedImportStage {
+public:
+    explicit ScopedImportStage(const char* name);
+    ~ScopedImportStage();
+
+    ScopedImportStage(const ScopedImportStage&) = delete;
+    ScopedImportStage& operator=(const ScopedImportStage&) = delete;
+
+    void addBytes(std::size_t bytes);
+
+private:
+    ImportStageStats* stats{ nullptr };
+    std::chrono::steady_clock::time_point start;
+    std::size_t startBytes{ 0 };
+    std::size_t extraBytes{ 0 };
+};
+
+// Wraps the pack aware file system so the time Assimp spends inside file reads can be told apart from parsing.
+class TimedIOSystem : public PackIOSystem {
+public:
+    explicit TimedIOSystem(ImportStageStats& aStats);
+
+    Assimp::IOStream* Open(const char* file, const char* mode = "rb") override;
+    void Close(Assimp::IOStream* file) override;
+
+private:
+    ImportStageStats& stats;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A 2D texture or cube map with its whole mip chain, as stored in a KTX 1.1 file. Block compressed textures have glType
+// and glFormat 0, uncompressed ones the type and format their levels are uploaded with. Uncompressed levels must have
+// rows that are a multiple of 4 bytes, KTX pads them otherwise.
+struct KtxTexture {
+    unsigned int glType{ 0 };
+    unsigned int glFormat{ 0 };
+    unsigned int internalFormat{ 0 };
+    unsigned int baseInternalFormat{ 0 };
+    int width{ 0 };
+    int height{ 0 };
+    // 6 for cube maps, whose levels hold every face one after another in GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order.
+    int faces{ 1 };
+    // Stored under the "encoder" key, lets a cache tell files written by an older encoder apart.
+    std::string encoder;
+    std::vector<std::vector<unsigned char>> levels;
+};
+
+// Both print why and return false on failure. readKtx goes through the mounted asset pack like every other loader.
+// With maxDimension set, levels wider or taller than it are left empty instead of being copied.
+[[nodiscard]] bool writeKtx(const std::string& path, const KtxTexture& texture);
+[[nodiscard]] bool readKtx(const std::string& path, KtxTexture& texture, int maxDimension = 0);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. The mapping lives as long as the object.
+// sequential tells the kernel to read ahead aggressively and drop pages behind us, turn it off for files that are read
+// in pieces.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path, bool sequential = true);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return opened; }
+    [[nodiscard]] const char* begin() const { return data; }
+    [[nodiscard]] const char* end() const { return data + bytes; }
+    [[nodiscard]] std::size_t size() const { return bytes; }
+
+private:
+    const char* data{ nullptr };
+    std::size_t bytes{ 0 };
+    bool opened{ false };
+};
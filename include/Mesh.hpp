@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Shader.hpp>
+#include <Bounds.hpp>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,13 @@ struct Texture {
     unsigned int id;
     TextureType textureType;
     std::string path;
+    // Set by Model::packTextures. id is then a GL_TEXTURE_2D_ARRAY the model binds to unit before drawing, and the
+    // texture is one layer of it, or a rectangle of one layer when it went into an atlas.
+    bool packed{ false };
+    unsigned int unit{ 0 };
+    float layer{ 0.f };
+    // Scale in xy and offset in zw, from the mesh's UVs to the texture's rectangle.
+    glm::vec4 uvTransform{ 1.f, 1.f, 0.f, 0.f };
 };
 
 class Mesh {
@@ -27,11 +35,16 @@ public:
     std::vector<Vertex> vertices;
     std::vector<Texture> textures;
     std::vector<unsigned int> indices;
+    // Object space, computed once when the mesh is built.
+    Bounds bounds;
 
-    explicit Mesh(const std::vector<Vertex>& aVertices, const std::vector<Texture>& aTextures,
-                  const std::vector<unsigned int>& aIndices);
+    explicit Mesh(std::vector<Vertex> aVertices, std::vector<Texture> aTextures, std::vector<unsigned int> aIndices);
 
     void draw(Shader& shader) const;
+    // Draws count copies in one call, each with its own model matrix taken from the instance buffer.
+    void drawInstanced(Shader& shader, unsigned int count) const;
+    // Feeds buffer to the shader as a per-instance mat4 at attribute locations 3 to 6.
+    void setInstanceBuffer(unsigned int buffer);
 
     unsigned int VAO{ 0 };
 private:
@@ -39,4 +52,5 @@ private:
     unsigned int EBO{ 0 };
 
     void setupMesh();
+    void bindTextures(Shader& shader) const;
 };
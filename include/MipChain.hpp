@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// One level of a mip chain, tightly packed RGBA8.
+struct MipLevel {
+    int width{ 0 };
+    int height{ 0 };
+    std::vector<unsigned char> rgba;
+};
+
+struct MipOptions {
+    // Colour channels hold sRGB values. They are filtered in linear space and converted back, alpha is always linear.
+    bool srgb{ false };
+    // When set, alpha is rescaled on every level so the share of texels passing the alpha test stays what it is on
+    // the base level. Without it, cutout foliage thins out and vanishes in the distance.
+    bool preserveAlphaCoverage{ false };
+    // The shader's alpha test threshold, shaderGrass.fs discards at or below 0.1.
+    float alphaCutoff{ 0.1f };
+};
+
+// base followed by every level below it down to 1x1, each a box filter of the one above, over 2x2 texels or up to 3x3
+// where a side is odd. Runs on the worker threads, the SIMD path needs SSE2.
+[[nodiscard]] std::vector<MipLevel> generateMipChain(MipLevel base, const MipOptions& options);
+
+// The six faces of one cube map level in GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order, square and all the same size.
+using CubeLevel = std::array<MipLevel, 6>;
+
+// One face of the level below source, half its size. Every texel is a tent filter over a 4x4 footprint of the level
+// above, and where the footprint runs off the face it carries on over the edge onto the neighbouring face. Filtering
+// each face on its own would leave the faces' edges disagreeing on lower levels, a seam no sampler can hide. Faces of a
+// level only read the level above, so the six can be filtered on different workers.
+[[nodiscard]] MipLevel downsampleCubeFace(const CubeLevel& source, std::size_t face, bool srgb);
+
+// Whether rgba looks like a cutout: nearly every texel fully transparent or fully opaque, with a fair share of
+// transparent ones. Such textures are drawn with an alpha test rather than blended.
+[[nodiscard]] bool isAlphaTested(const std::vector<unsigned char>& rgba);
@@ -2,6 +2,7 @@
 
 #include <Mesh.hpp>
 #include <Shader.hpp>
+#include <Camera.hpp>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -10,19 +11,51 @@
 #include <string>
 #include <vector>
 
+struct ImportProfile;
+
 class Model {
 public:
-    explicit Model(const std::string& path);
+    // When profile is given, the import is broken down into stages and recorded there.
+    explicit Model(const std::string& path, ImportProfile* profile = nullptr);
 
     void draw(Shader& shader) const;
+    // Draws every instance given to setInstanceTransforms in one call per mesh.
+    void drawInstanced(Shader& shader) const;
+    // Uploads one model matrix per instance, shared by all meshes. Calling it again replaces them.
+    void setInstanceTransforms(const std::vector<glm::mat4>& transforms);
+    // Tells the active TextureStreamer how large each mesh is on screen when drawn with transform, so its textures
+    // get the detail they need. Does nothing without a streamer.
+    void requestTextureDetail(const Camera& camera, const glm::mat4& transform, float viewportHeight) const;
+    // Moves the material textures into texture arrays and atlases (see packTextureArrays), so drawing the model binds
+    // a handful of arrays once instead of every mesh binding its own textures. Draw with a shader that samples
+    // sampler2DArrays, like shaders/modelPacked.fs. Packs every texture or none: when one can't be, because a
+    // TextureStreamer owns it, it has no cached chain or it doesn't fit the arrays left, the model is left as it was
+    // and false is returned, so it keeps drawing with the plain shader.
+    [[nodiscard]] bool packTextures();
 
     std::vector<Mesh> meshes;
     std::vector<Texture> texturesLoaded;
+    // Union of the mesh bounds, in model space.
+    Bounds bounds;
 private:
     std::string directory;
+    unsigned int instanceVBO{ 0 };
+    unsigned int instanceCount{ 0 };
+    // Filled by packTextures, bound to consecutive units from PackedTextureUnit on.
+    std::vector<unsigned int> textureArrays;
 
     void loadModel(const std::string& path);
+    void loadAssimpModel(const std::string& path);
+    // Returns false when the native parser can't handle the file and Assimp should take over.
+    bool loadObjModel(const std::string& path);
     void processNode(aiNode* node, const aiScene* const scene);
     Mesh processMesh(aiMesh* mesh, const aiScene* const scene);
     std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type);
+    // Queues file from the model directory, or reuses it if another mesh already did.
+    Texture loadMaterialTexture(const std::string& file, TextureType type);
+    // Decodes every queued texture on the worker pool, uploads them and hands the ids to the meshes.
+    void uploadTextures();
+    // Copies every entry of texturesLoaded into the meshes using it.
+    void updateMeshTextures();
+    void bindTextureArrays() const;
 };
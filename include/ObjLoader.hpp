@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Mesh.hpp>
+
+#include <string>
+#include <vector>
+
+// Texture maps of one MTL material, paths as written in the file (relative to the OBJ directory).
+struct ObjMaterial {
+    std::string name;
+    std::string diffuseMap;
+    std::string specularMap;
+    std::string normalMap;
+};
+
+// All faces using one material, with vertices deduplicated on their position/uv/normal triple.
+struct ObjMesh {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    int material{ -1 };
+};
+
+struct ObjModel {
+    std::vector<ObjMesh> meshes;
+    std::vector<ObjMaterial> materials;
+};
+
+// Wavefront OBJ/MTL loader that skips Assimp for the plain files we ship. The output matches what Model asks Assimp
+// for: triangulated faces, smooth normals where the file has none and flipped V coordinates.
+// threads == 0 picks one per hardware thread, large files are split into chunks parsed concurrently.
+// Returns false, after printing why, when the file cannot be read or is malformed.
+[[nodiscard]] bool loadObj(const std::string& path, ObjModel& model, unsigned int threads = 0);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Camera.hpp>
+#include <Frustum.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// The same fly camera as Camera, driven the same way, with its orientation kept as a quaternion and every matrix
+// cached. Mouse and scroll events only add to yaw, pitch and zoom and mark what they change as dirty. The orientation,
+// view, projection, view-projection and frustum are only worked out again the first time one is asked for after that,
+// so however many events arrive in a frame, each matrix is built at most once and culling and drawing read the same
+// ones. Looks down -Z at the default yaw, like Camera.
+class QuaternionCamera {
+public:
+    explicit QuaternionCamera(const glm::vec3& aPosition = glm::vec3(0.f), float aYaw = Yaw, float aPitch = Pitch,
+                              float aAspect = 16.f / 9.f, float aNear = .1f, float aFar = 100.f);
+
+    void processKeyboard(CameraMovementOptions direction, float deltaTime);
+    void processMouseMovement(float xOffset, float yOffset, bool constrainPitch = true);
+    void processMouseScroll(float yOffset);
+
+    void setPosition(const glm::vec3& aPosition);
+    // Puts the camera exactly where a recording had it, for playback.
+    void setPose(const glm::vec3& aPosition, float aYaw, float aPitch, float aZoom);
+    void setAspect(float aAspect);
+
+    [[nodiscard]] const glm::vec3& position() const { return eye; }
+    [[nodiscard]] float yaw() const { return yawDegrees; }
+    [[nodiscard]] float pitch() const { return pitchDegrees; }
+    [[nodiscard]] float zoom() const { return zoomDegrees; }
+
+    [[nodiscard]] const glm::quat& orientation() const;
+    [[nodiscard]] glm::vec3 front() const;
+    [[nodiscard]] glm::vec3 right() const;
+    [[nodiscard]] glm::vec3 up() const;
+
+    [[nodiscard]] const glm::mat4& view() const;
+    [[nodiscard]] const glm::mat4& projection() const;
+    [[nodiscard]] const glm::mat4& viewProjection() const;
+    // Always extracted from the current viewProjection().
+    [[nodiscard]] const Frustum& frustum() const;
+
+    // Roughly how many pixels tall sphere appears on a viewport viewportHeight pixels high, as Camera::projectedSize.
+    [[nodiscard]] float projectedSize(const BoundingSphere& sphere, float viewportHeight) const;
+
+private:
+    enum Dirty : unsigned int {
+        ORIENTATION = 1u << 0,
+        VIEW = 1u << 1,
+        PROJECTION = 1u << 2,
+        VIEW_PROJECTION = 1u << 3,
+        FRUSTUM = 1u << 4,
+        ALL = ORIENTATION | VIEW | PROJECTION | VIEW_PROJECTION | FRUSTUM,
+    };
+
+    glm::vec3 eye;
+    float yawDegrees;
+    float pitchDegrees;
+    float zoomDegrees{ Zoom };
+    float aspect;
+    float nearPlane;
+    float farPlane;
+    float movementSpeed{ Speed };
+    float mouseSensitivity{ Sensitivity };
+
+    // What has to be worked out again before it is next read.
+    mutable unsigned int dirty{ ALL };
+    mutable glm::quat rotation{ 1.f, 0.f, 0.f, 0.f };
+    mutable glm::mat4 viewMatrix{ 1.f };
+    mutable glm::mat4 projectionMatrix{ 1.f };
+    mutable glm::mat4 viewProjectionMatrix{ 1.f };
+    mutable Frustum viewFrustum{};
+};
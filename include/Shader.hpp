@@ -4,11 +4,19 @@
 
 #include <glm/mat4x4.hpp>
 
+// Lines spliced into both stages' source right after the #version line, mostly #defines picking a variant.
+struct ShaderDefines {
+    std::string lines;
+};
+
 struct Shader {
     unsigned int id;
 
     explicit Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    explicit Shader(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines);
     explicit Shader(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath);
+    // A compute program. Only for contexts loadGLExtensions found compute shaders in.
+    explicit Shader(const std::string& computePath, const ShaderDefines& defines);
 
     void use();
     void setUniformBool(const std::string& name, bool val) const;
@@ -18,4 +26,7 @@ struct Shader {
     void setVec3(const std::string& name, float valX, float valY, float valZ) const;
     void setVec3(const std::string& name, const glm::vec3& val) const;
     void setVec2(const std::string& name, const glm::vec2& val) const;
+    void setVec4(const std::string& name, const glm::vec4& val) const;
+    // Points the uniform block called name at a uniform buffer binding point. Blocks the shader doesn't have are ignored.
+    void bindUniformBlock(const std::string& name, unsigned int binding) const;
 };
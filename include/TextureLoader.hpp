@@ -0,0 +1,144 @@
+#pragma once
+
+#include <KtxFile.hpp>
+#include <TextureManager.hpp>
+#include <TextureUploadQueue.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Pixels as stb_image decoded them, tightly packed rows of components bytes per texel.
+struct DecodedImage {
+    std::string path;
+    unsigned char* pixels{ nullptr };
+    int width{ 0 };
+    int height{ 0 };
+    int components{ 0 };
+};
+
+// What a texture holds, which decides the block format it is compressed to.
+enum class TextureUsage {
+    COLOUR, // BC1, or BC3 when some texel isn't opaque.
+    MASK,   // BC4 when the image is grey and opaque, like specular and AO maps. Treated as COLOUR otherwise.
+    NORMAL, // BC5, only x and y are kept and shaders rebuild z.
+};
+
+// Guesses from the file name: "normal" means NORMAL, "spec", "ao", "disp" or "rough" mean MASK, anything else COLOUR.
+[[nodiscard]] TextureUsage inferTextureUsage(const std::string& path);
+
+// Decodes path from the mounted pack, or the loose file when it isn't packed. Safe to call from any thread.
+// Returns false, after printing why, when the image can't be read.
+[[nodiscard]] bool decodeImage(const std::string& path, DecodedImage& image);
+void freeImage(DecodedImage& image);
+
+// Creates a mipmapped texture in immutable storage from image, leaving the mips to glGenerateMipmap. Must run on the
+// thread that owns the GL context. Batches only fall back to it for images that failed to decode.
+// Every upload below hands its texture to the active TextureManager, to be sampled through sampler.
+[[nodiscard]] unsigned int uploadTexture(const DecodedImage& image, bool gammaCorrection,
+                                         TextureSampler sampler = TextureSampler::REPEAT);
+
+// Builds image's whole mip chain on the CPU, then block compresses every level. Colour that will be sampled as sRGB is
+// filtered in linear space, and cutouts keep their alpha test coverage on every level. BC1 and BC3 need S3TC
+// (s3tcSupported), without it those textures keep uncompressed RGBA8 levels. BC4 and BC5 are core since GL 3.0.
+[[nodiscard]] KtxTexture prepareTexture(const DecodedImage& image, TextureUsage usage, bool gammaCorrection,
+                                        bool s3tcSupported);
+// Uploads every level of a prepared or cached texture into immutable storage when the context has it, no decoding and
+// no mip generation involved.
+[[nodiscard]] unsigned int uploadPreparedTexture(const KtxTexture& texture, bool gammaCorrection,
+                                                 TextureSampler sampler = TextureSampler::REPEAT);
+
+// The format the uploads below allocate texture with: sized, as immutable storage requires, and the sRGB variant when
+// gammaCorrection is set and the format has one.
+[[nodiscard]] unsigned int sizedInternalFormat(const KtxTexture& texture, bool gammaCorrection);
+
+// Level by level versions for textures that gain and lose levels after creation, which immutable storage can't do.
+// uploadMutableTexture creates a texture holding levels from firstLevel down, with GL_TEXTURE_BASE_LEVEL set to it.
+// The other two act on the bound texture: uploadTextureLevel specifies level from texture.levels, releaseTextureLevel
+// frees its memory again. Neither touches the base level.
+[[nodiscard]] unsigned int uploadMutableTexture(const KtxTexture& texture, std::size_t firstLevel, bool gammaCorrection,
+                                                TextureSampler sampler = TextureSampler::REPEAT);
+void uploadTextureLevel(const KtxTexture& texture, std::size_t level, bool gammaCorrection);
+void releaseTextureLevel(const KtxTexture& texture, std::size_t level, bool gammaCorrection);
+// Like uploadTextureLevel, but only allocates the level right away. Its data moves into the returned upload, for a
+// TextureUploadQueue to fill it in later.
+[[nodiscard]] TextureUpload allocateTextureLevel(unsigned int textureId, KtxTexture& texture, std::size_t level,
+                                                 bool gammaCorrection);
+
+// Prepared textures are cached as KTX files under ./cache/, mirroring the path of their source image. A cached file
+// is used as long as it is newer than the source and was written by the current encoder for the same usage, gamma
+// and S3TC support.
+[[nodiscard]] std::string textureCachePath(const std::string& path);
+
+// Decodes a set of images on the worker pool while the caller carries on, then uploads them all from the context
+// thread in one go:
+//     TextureBatch batch;
+//     batch.add("./assets/wood.png", true);
+//     const auto ids = batch.upload();
+// While a TextureStreamer is active, textures only come up with their smallest levels and the streamer owns them.
+class TextureBatch {
+public:
+    TextureBatch() = default;
+    ~TextureBatch();
+
+    TextureBatch(const TextureBatch&) = delete;
+    TextureBatch& operator=(const TextureBatch&) = delete;
+
+    // Starts loading path straight away, returns its index in the ids upload() hands back. Loading means reading the
+    // prepared copy from the cache, or decoding and preparing the image and caching the result.
+    std::size_t add(const std::string& path, bool gammaCorrection = false);
+    std::size_t add(const std::string& path, bool gammaCorrection, TextureUsage usage,
+                    TextureSampler sampler = TextureSampler::REPEAT);
+    // Uploads every image added since the last call, each one as soon as its decode finishes so uploads overlap the
+    // decodes still running. Ids come back in the order the images were added. Images that failed to decode still get
+    // a texture id, like a failed stbi_load did before.
+    [[nodiscard]] std::vector<unsigned int> upload();
+
+private:
+    struct Entry {
+        DecodedImage image;
+        // Filled instead of image once the worker has prepared or read the mip chain.
+        KtxTexture prepared;
+        TextureUsage usage{ TextureUsage::COLOUR };
+        TextureSampler sampler{ TextureSampler::REPEAT };
+        bool gammaCorrection{ false };
+        bool s3tcSupported{ false };
+        // Handed to the active TextureStreamer instead of being uploaded whole.
+        bool streamed{ false };
+        // Set by the worker under mutex once image is ready to upload.
+        bool decoded{ false };
+    };
+
+    // A deque so workers can keep writing into entries while more are added.
+    std::deque<Entry> entries;
+    std::mutex mutex;
+    std::condition_variable imageDecoded;
+    std::size_t remaining{ 0 };
+
+    void waitForDecodes();
+};
+
+// One image through the same cache and compression as a batch, for call sites with nothing to load alongside it.
+[[nodiscard]] unsigned int loadTexture(const std::string& path, bool gammaCorrection = false);
+
+// Six images in GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order: right, left, top, bottom, front, back.
+using CubemapFaces = std::array<std::string, 6>;
+
+// A cube map is cooked into one KTX file named after the directory of its faces, "cache/assets/skybox.ktx" for faces
+// under ./assets/skybox/.
+[[nodiscard]] std::string cubemapCachePath(const CubemapFaces& faces);
+
+// Decodes the six faces on the worker pool at the same time, then builds the mip chain with downsampleCubeFace, the
+// faces of each level on the workers too, and compresses it the way prepareTexture would. Faces have to be square and
+// of one size. Prints why and returns a texture without levels when they aren't or one can't be decoded. Waits on the
+// pool, so it must not be called from a task running on it.
+[[nodiscard]] KtxTexture prepareCubemap(const CubemapFaces& faces, bool gammaCorrection, bool s3tcSupported);
+// Every level of every face into immutable storage when the context has it, sampled through TextureSampler::CUBE_MAP.
+[[nodiscard]] unsigned int uploadPreparedCubemap(const KtxTexture& texture, bool gammaCorrection);
+// Reads the cooked cube map in one go while it is newer than every face and from the current encoder, otherwise
+// prepares it and cooks it for next time. Returns 0 when the faces can't be loaded.
+[[nodiscard]] unsigned int loadCubemap(const CubemapFaces& faces, bool gammaCorrection = false);
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+// Sampling state shared by every texture created with it, one sampler object each.
+enum class TextureSampler {
+    REPEAT,        // Trilinear and tiling, for material textures.
+    CLAMP_TO_EDGE, // Bilinear from level 0 only, for render targets and full screen passes.
+    CUBE_MAP,      // Trilinear and clamped, for mipmapped cube maps.
+};
+
+// What the manager has seen since it was made, for monitoring.
+struct TextureMemoryStats {
+    std::size_t gpuBytes{ 0 };
+    std::size_t peakGpuBytes{ 0 };
+    // Texture data on the CPU on its way to the GPU, as reported by the streamer.
+    std::size_t cpuBytes{ 0 };
+    std::size_t peakCpuBytes{ 0 };
+    // Levels evicted to get back under the GPU budget, and textures evicted down to their last level.
+    std::size_t evictedLevels{ 0 };
+    std::size_t evictedTextures{ 0 };
+    std::size_t evictedBytes{ 0 };
+};
+
+// Owns every texture the app creates: how much GPU memory each one takes, the last frame it was drawn with and which of
+// a few shared sampler objects it is sampled through, so no texture carries sampling state of its own. Loaders register
+// what they create with the active manager (manageTexture), draws bind through it (bindTexture). The manager only
+// holds the memory budgets, the TextureStreamer keeps to them by evicting what was used least recently. Every call has
+// to be made on the thread that owns the GL context, and the manager has to go before the context does:
+//     auto textureManager = std::make_unique<TextureManager>();
+//     setTextureManager(textureManager.get());
+//     textureManager->setBudget(256 * 1024 * 1024, 64 * 1024 * 1024);
+//     ...
+//     // Every frame, after the last draw:
+//     textureManager->nextFrame();
+//     ...
+//     setTextureManager(nullptr);
+//     textureManager.reset();
+//     glfwTerminate();
+class TextureManager {
+public:
+    TextureManager();
+    // Deletes the samplers and every texture still tracked.
+    ~TextureManager();
+
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    // Takes ownership of texture, which holds bytes of GPU memory and is sampled through sampler.
+    void track(unsigned int texture, std::size_t bytes, TextureSampler sampler);
+    // For textures whose storage changes after creation, like streamed ones.
+    void setBytes(unsigned int texture, std::size_t bytes);
+    // Deletes texture. Textures the manager doesn't track are deleted all the same.
+    void release(unsigned int texture);
+    // Stamps texture as used this frame and returns the sampler object it is sampled through, 0 for textures the manager
+    // doesn't track.
+    unsigned int use(unsigned int texture);
+    void nextFrame();
+
+    // GPU memory all textures may take, and CPU memory streamed levels may take on their way up. 0, the default, leaves
+    // either unbounded.
+    void setBudget(std::size_t gpuBytes, std::size_t cpuBytes);
+    // Reported by the TextureStreamer, which is what keeps to the budgets.
+    void setCpuBytes(std::size_t bytes);
+    void recordEviction(std::size_t bytes, std::size_t levels, bool wholeTexture);
+
+    // The sampler object texture is sampled through, 0 for textures the manager doesn't track.
+    [[nodiscard]] unsigned int samplerFor(unsigned int texture) const;
+    [[nodiscard]] std::size_t textureBytes(unsigned int texture) const;
+    [[nodiscard]] std::size_t totalBytes() const;
+    [[nodiscard]] std::size_t textureCount() const;
+    [[nodiscard]] std::uint64_t frame() const;
+    // The frame texture was last bound in, 0 when it never was.
+    [[nodiscard]] std::uint64_t lastUsedFrame(unsigned int texture) const;
+    [[nodiscard]] std::size_t gpuBudget() const;
+    [[nodiscard]] std::size_t cpuBudget() const;
+    [[nodiscard]] const TextureMemoryStats& stats() const;
+
+private:
+    struct Entry {
+        std::size_t bytes{ 0 };
+        TextureSampler sampler{ TextureSampler::REPEAT };
+        std::uint64_t lastUsedFrame{ 0 };
+    };
+
+    std::unordered_map<unsigned int, Entry> textures;
+    std::array<unsigned int, 3> samplers{ 0, 0, 0 };
+    // Starts at 1, so 0 means never used.
+    std::uint64_t frameNumber{ 1 };
+    std::size_t gpuLimit{ 0 };
+    std::size_t cpuLimit{ 0 };
+    TextureMemoryStats memory;
+
+    void setGpuBytes(std::size_t bytes);
+};
+
+// nullptr, the default, leaves textures to carry their own sampling state like they did before samplers.
+void setTextureManager(TextureManager* manager);
+[[nodiscard]] TextureManager* activeTextureManager();
+
+// Hands a texture the loaders just created to the active manager. Without one, the texture bound to target gets
+// sampler's parameters set on it instead.
+void manageTexture(unsigned int texture, unsigned int target, std::size_t bytes, TextureSampler sampler);
+// Binds texture to unit along with its sampler. Textures the manager doesn't track are bound with no sampler, so their
+// own parameters apply again.
+void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+// Deletes texture and drops it from the active manager.
+void releaseTexture(unsigned int texture);
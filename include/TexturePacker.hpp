@@ -0,0 +1,39 @@
+#pragma once
+
+#include <KtxFile.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Where packTextureArrays put one of its input textures.
+struct TexturePlacement {
+    // Index into TexturePacking::arrays, NotPacked when the texture was left alone.
+    std::size_t array{ NotPacked };
+    float layer{ 0.f };
+    // Maps the texture's own UVs into its rectangle of the layer: scale in xy, offset in zw. Identity unless the
+    // texture went into an atlas.
+    glm::vec4 uvTransform{ 1.f, 1.f, 0.f, 0.f };
+
+    static constexpr std::size_t NotPacked{ std::numeric_limits<std::size_t>::max() };
+};
+
+struct TexturePacking {
+    // GL_TEXTURE_2D_ARRAY textures, owned by the caller, or the active TextureManager when there is one.
+    std::vector<unsigned int> arrays;
+    // One per input texture, in the same order.
+    std::vector<TexturePlacement> placements;
+};
+
+// Moves a set of textures into as few GL_TEXTURE_2D_ARRAYs as it can, so draws using any of them need no rebinds:
+// - textures sharing format and size become layers of one array,
+// - the small power of two ones left over are packed into atlas pages per format, with a wrapped gutter around each
+//   rectangle so GL_REPEAT style tiling and filtering still work. Pages keep fewer mips, so the gutter holds up,
+// - anything else gets an array of its own.
+// Textures without levels are skipped, as are groups beyond maxArrays. gammaCorrection holds one flag per texture, as
+// uploadPreparedTexture takes it, and arrays are stored in the same sized formats. Must run on the thread that owns the
+// GL context.
+[[nodiscard]] TexturePacking packTextureArrays(const std::vector<KtxTexture>& textures,
+                                               const std::vector<bool>& gammaCorrection, std::size_t maxArrays);
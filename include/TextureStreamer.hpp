@@ -0,0 +1,113 @@
+#pragma once
+
+#include <KtxFile.hpp>
+#include <TextureManager.hpp>
+#include <TextureUploadQueue.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Levels no larger than this stay resident for as long as their texture lives, everything above is streamed.
+constexpr int StreamedResidentSize{ 64 };
+
+// Keeps only the small end of each texture's mip chain on the GPU until something on screen needs more. Finer levels
+// are read back from the texture cache on the worker pool when requested, uploaded a few per frame through a
+// TextureUploadQueue, and released once nothing has needed them for a while. Every call has to be made on the thread
+// that owns the GL context, and the streamer has to go before the context does.
+//
+// The streamer also keeps to the active TextureManager's budgets. Cache reads only start while the levels on their way
+// up fit the CPU budget. A level that doesn't fit the GPU budget first evicts levels of the streamed textures used
+// least recently, never ones drawn this frame: their streamed levels, then, if that isn't enough, everything but
+// their last level. Evicted levels come back through the usual loads once the texture is drawn or requested again.
+//
+// While a streamer is active (setTextureStreamer), TextureBatch hands it every texture it loads:
+//     TextureStreamer streamer;
+//     setTextureStreamer(&streamer);
+//     Model backpack("./assets/backpack/backpack.obj");
+//     ...
+//     // Every frame:
+//     backpack.requestTextureDetail(camera, transform, viewportHeight);
+//     streamer.update();
+class TextureStreamer {
+public:
+    explicit TextureStreamer(std::size_t uploadBudgetBytes = 4 * 1024 * 1024);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Creates a texture from the levels of texture that hold data, which have to be the end of the chain. The missing
+    // ones are read from cachePath when they are asked for. The active TextureManager is kept up to date with what
+    // the texture takes as levels come and go.
+    [[nodiscard]] unsigned int add(KtxTexture texture, const std::string& cachePath, bool gammaCorrection,
+                                   TextureSampler sampler = TextureSampler::REPEAT);
+    // Asks for enough detail on textureId to cover pixels across on screen this frame, which counts as using it. The
+    // largest request wins, textures nobody asks for drift back to their resident levels. Ids the streamer doesn't own
+    // are ignored.
+    void request(unsigned int textureId, float pixels);
+    // Once per frame, after the requests and draws but before TextureManager::nextFrame: queues levels that finished
+    // loading for upload, up to the budget, releases levels no longer needed and starts loading the ones that are
+    // missing.
+    void update();
+    // Whether textureId is one of the streamer's, which nothing else should delete or respecify.
+    [[nodiscard]] bool owns(unsigned int textureId) const;
+
+    // GPU memory the streamed textures take right now, and what they would take fully resident.
+    [[nodiscard]] std::size_t residentBytes() const;
+    [[nodiscard]] std::size_t fullBytes() const;
+    // CPU memory taken by levels read from the cache and not yet handed to GL, counting reads still running.
+    [[nodiscard]] std::size_t stagedBytes() const;
+
+private:
+    struct Entry {
+        unsigned int id{ 0 };
+        std::string cachePath;
+        bool gammaCorrection{ false };
+        // Format and size of the whole chain. A level only holds data between being loaded and being uploaded.
+        KtxTexture texture;
+        // Finest level that is never released.
+        std::size_t residentLevel{ 0 };
+        // Finest level there is, which only stops being 0 when the cache file can't be read back.
+        std::size_t finestLevel{ 0 };
+        // Finest level on the GPU right now, which is also the texture's base level.
+        std::size_t baseLevel{ 0 };
+        // Finest level handed to the upload queue, baseLevel catches up with it as the queue issues them.
+        std::size_t queuedLevel{ 0 };
+        // Finest level asked for since the last update.
+        std::size_t wantedLevel{ 0 };
+        // Level the texture drifts back to when nothing asks for more: residentLevel, or coarser while it is evicted.
+        std::size_t restingLevel{ 0 };
+        unsigned int framesUnneeded{ 0 };
+        // Set while a worker reads the cache file, loaded is filled by it under mutex.
+        bool loading{ false };
+        bool loadFinished{ false };
+        KtxTexture loaded;
+    };
+
+    std::size_t uploadBudget;
+    TextureUploadQueue uploads;
+    // A deque so workers can keep writing into entries while more are added.
+    std::deque<Entry> entries;
+    std::unordered_map<unsigned int, std::size_t> entryIndex;
+    std::mutex mutex;
+    std::condition_variable loadDone;
+    std::size_t pendingLoads{ 0 };
+
+    void startLoad(Entry& entry);
+    [[nodiscard]] bool roomToLoad(const Entry& entry) const;
+    void release(Entry& entry, std::size_t level);
+    // Whether bytes more GPU memory fit the budget, once what was used least recently has been evicted if needed.
+    [[nodiscard]] bool makeRoom(std::size_t bytes);
+    // False when there wasn't bytes worth to evict. With allOrNothing it then leaves everything as it is, evicting it
+    // all for a level that won't fit anyway would only have it stream back in.
+    bool evict(std::size_t bytes, bool allOrNothing);
+};
+
+// Textures loaded by TextureBatch go through streamer while it is set. nullptr switches streaming off again, for
+// textures loaded after that. The streamer has to outlive every texture it streams.
+void setTextureStreamer(TextureStreamer* streamer);
+[[nodiscard]] TextureStreamer* activeTextureStreamer();
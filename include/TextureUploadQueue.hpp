@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// One level, or one cube map face of one level, of a texture that already has storage for it.
+struct TextureUpload {
+    unsigned int texture{ 0 };
+    // GL_TEXTURE_2D or one of the GL_TEXTURE_CUBE_MAP_* faces.
+    GLenum target{ GL_TEXTURE_2D };
+    int level{ 0 };
+    int width{ 0 };
+    int height{ 0 };
+    // format and type as glTexSubImage2D takes them, or type 0 and the internal format for block compressed data.
+    GLenum format{ 0 };
+    GLenum type{ 0 };
+    // Tightly packed rows, or rows of 4x4 blocks.
+    std::vector<unsigned char> data;
+    // Runs on the context thread once the last of the data has been handed to GL, anything issued after it samples the
+    // new contents.
+    std::function<void()> onIssued;
+};
+
+// Feeds texture uploads to the driver a slice per frame through a ring of pixel unpack buffers, so it can copy them to
+// the GPU asynchronously instead of the context thread blocking in glTexSubImage2D while it copies from client memory.
+// The ring is split into one region per frame in flight. Each update fills the next region with as many rows of the
+// pending uploads as fit, issues glTexSubImage2D from buffer offsets and fences it. A region is only written again once
+// its fence has signalled, if it hasn't the update does nothing rather than wait.
+//
+// The buffer stays mapped for its whole life with glBufferStorage (GL 4.4 or ARB_buffer_storage), without it every
+// region is mapped unsynchronized while it is filled. Every call has to be made on the thread that owns the GL context,
+// and the queue has to go before the context does.
+class TextureUploadQueue {
+public:
+    explicit TextureUploadQueue(std::size_t frameBytes = 4 * 1024 * 1024, std::size_t framesInFlight = 3);
+    ~TextureUploadQueue();
+
+    TextureUploadQueue(const TextureUploadQueue&) = delete;
+    TextureUploadQueue& operator=(const TextureUploadQueue&) = delete;
+
+    void push(TextureUpload upload);
+    // Once per frame: stages and issues up to frameBytes of what is pending.
+    void update();
+    // Keeps updating until everything pending has been issued, waiting on the GPU where it has to.
+    void flush();
+
+    [[nodiscard]] bool idle() const;
+    [[nodiscard]] std::size_t pendingBytes() const;
+    [[nodiscard]] bool persistentlyMapped() const;
+
+private:
+    struct Band {
+        std::size_t offset;
+        int y;
+        int height;
+        std::size_t bytes;
+    };
+
+    std::size_t regionBytes;
+    std::vector<GLsync> fences;
+    std::size_t nextRegion{ 0 };
+    unsigned int buffer{ 0 };
+    unsigned char* mapped{ nullptr };
+
+    std::deque<TextureUpload> pending;
+    // Rows of the front upload already issued, in block rows for compressed data.
+    int rowsIssued{ 0 };
+    std::size_t bytesPending{ 0 };
+
+    // False when the GPU still reads from the next region.
+    bool updateRegion(bool wait);
+    static void issue(const TextureUpload& upload, const Band& band, const void* pixels);
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running queued tasks in submission order. Tasks must not touch GL, the context only
+// lives on the thread that made it current.
+class ThreadPool {
+public:
+    // threads == 0 starts one worker per hardware thread.
+    explicit ThreadPool(unsigned int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // Blocks until every task submitted so far has finished.
+    void wait();
+
+    [[nodiscard]] std::size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    std::size_t pending{ 0 };
+    bool stopping{ false };
+
+    void run();
+};
+
+// Shared by the loaders, started on first use.
+[[nodiscard]] ThreadPool& workerPool();
@@ -16,8 +16,13 @@ struct Light {
     vec3 colour;
 };
 
+layout(std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPosition;
+};
+
 uniform sampler2D diffuseTexture;
-uniform vec3 viewPosition;
 uniform Light lights[LIGHTS_LEN];
 
 void main() {
@@ -10,8 +10,12 @@ out VS_OUT {
     vec2 texCoords;
 } vs_out;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout(std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPosition;
+};
+
 uniform mat4 model;
 
 void main() {
@@ -0,0 +1,35 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+// The next level up, twice the size of the target.
+uniform sampler2D source;
+
+// 13 bilinear taps over a 6x6 texel footprint of source, as five overlapping 4x4 boxes: one in the middle weighted .5
+// and four in the corners weighted .125 each. Filters out the shimmer a plain 2x2 box gives when bright pixels move.
+void main() {
+    vec2 texel = 1.f / textureSize(source, 0);
+
+    vec3 a = texture(source, texCoords + texel * vec2(-2.f,  2.f)).rgb;
+    vec3 b = texture(source, texCoords + texel * vec2( 0.f,  2.f)).rgb;
+    vec3 c = texture(source, texCoords + texel * vec2( 2.f,  2.f)).rgb;
+    vec3 d = texture(source, texCoords + texel * vec2(-2.f,  0.f)).rgb;
+    vec3 e = texture(source, texCoords).rgb;
+    vec3 f = texture(source, texCoords + texel * vec2( 2.f,  0.f)).rgb;
+    vec3 g = texture(source, texCoords + texel * vec2(-2.f, -2.f)).rgb;
+    vec3 h = texture(source, texCoords + texel * vec2( 0.f, -2.f)).rgb;
+    vec3 i = texture(source, texCoords + texel * vec2( 2.f, -2.f)).rgb;
+    vec3 j = texture(source, texCoords + texel * vec2(-1.f,  1.f)).rgb;
+    vec3 k = texture(source, texCoords + texel * vec2( 1.f,  1.f)).rgb;
+    vec3 l = texture(source, texCoords + texel * vec2(-1.f, -1.f)).rgb;
+    vec3 m = texture(source, texCoords + texel * vec2( 1.f, -1.f)).rgb;
+
+    vec3 result = e * .125f;
+    result += (a + c + g + i) * .03125f;
+    result += (b + d + f + h) * .0625f;
+    result += (j + k + l + m) * .125f;
+
+    FragColor = vec4(result, 1.f);
+}
@@ -7,15 +7,37 @@ in vec2 texCoords;
 uniform sampler2D scene;
 uniform sampler2D bloomBlur;
 uniform bool bloom;
+// How much of bloomBlur is added, which depends on how it was blurred.
+uniform float bloomStrength;
 uniform float exposure;
+// How much to sharpen scene by, 0 when it is drawn at the screen's resolution.
+uniform float sharpness;
+
+// scene is upscaled by the bilinear filter. Sharpening takes back some of the detail that softens, pushing each pixel
+// away from its neighbours' average, but no further than the brightest and darkest of them so edges don't ring.
+vec3 upscaledScene() {
+    vec3 centre = texture(scene, texCoords).rgb;
+    if(sharpness <= 0.f) {
+        return centre;
+    }
+    vec2 texel = 1.f / textureSize(scene, 0);
+    vec3 left = texture(scene, texCoords - vec2(texel.x, 0.f)).rgb;
+    vec3 right = texture(scene, texCoords + vec2(texel.x, 0.f)).rgb;
+    vec3 down = texture(scene, texCoords - vec2(0.f, texel.y)).rgb;
+    vec3 up = texture(scene, texCoords + vec2(0.f, texel.y)).rgb;
+    vec3 neighbourhoodMin = min(centre, min(min(left, right), min(down, up)));
+    vec3 neighbourhoodMax = max(centre, max(max(left, right), max(down, up)));
+    vec3 sharpened = centre + (centre - (left + right + down + up) * .25f) * sharpness;
+    return clamp(sharpened, neighbourhoodMin, neighbourhoodMax);
+}
 
 void main() {
     const float gamma = 2.2f;
 
-    vec3 hdrColour = texture(scene, texCoords).rgb;
+    vec3 hdrColour = upscaledScene();
     vec3 bloomColour = texture(bloomBlur, texCoords).rgb;
     if(bloom) {
-        hdrColour += bloomColour;
+        hdrColour += bloomColour * bloomStrength;
     }
 
     // Tone mapping
@@ -0,0 +1,30 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+// The level below, half the size of the target, already upsampled up to there.
+uniform sampler2D lower;
+// The downsampled level the same size as the target.
+uniform sampler2D current;
+// Half the width of the tent, as a fraction of the screen's height whatever the level.
+uniform float filterRadius;
+
+// 3x3 tent filter over lower, added to current, so every level of the chain ends up in the result.
+void main() {
+    vec2 size = textureSize(lower, 0);
+    vec2 offset = vec2(filterRadius * size.y / size.x, filterRadius);
+
+    vec3 result = texture(lower, texCoords).rgb * 4.f;
+    result += (texture(lower, texCoords + vec2(-offset.x, 0.f)).rgb +
+               texture(lower, texCoords + vec2( offset.x, 0.f)).rgb +
+               texture(lower, texCoords + vec2(0.f, -offset.y)).rgb +
+               texture(lower, texCoords + vec2(0.f,  offset.y)).rgb) * 2.f;
+    result += texture(lower, texCoords + vec2(-offset.x, -offset.y)).rgb +
+              texture(lower, texCoords + vec2( offset.x, -offset.y)).rgb +
+              texture(lower, texCoords + vec2(-offset.x,  offset.y)).rgb +
+              texture(lower, texCoords + vec2( offset.x,  offset.y)).rgb;
+
+    FragColor = vec4(texture(current, texCoords).rgb + result / 16.f, 1.f);
+}
@@ -0,0 +1,76 @@
+#version 430 core
+
+// One side of the kernel, centre tap first, taps a texel apart. Without defines it is the 9-tap kernel blur.fs falls
+// back to, Bloom builds variants with kernels from gaussianKernel.
+#ifndef BLUR_TAPS
+#define BLUR_TAPS 5
+#define BLUR_OFFSETS 0.f, 1.f, 2.f, 3.f, 4.f
+#define BLUR_WEIGHTS 0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162
+#endif
+
+#define TILE_SIZE 16
+// Texels either side of the tile the kernel reaches.
+#define APRON (BLUR_TAPS - 1)
+#define CACHED_SIZE (TILE_SIZE + 2 * APRON)
+
+layout(local_size_x = TILE_SIZE, local_size_y = TILE_SIZE) in;
+
+uniform sampler2D image;
+layout(rgba16f, binding = 0) uniform writeonly image2D blurred;
+
+const float weight[BLUR_TAPS] = float[] (BLUR_WEIGHTS);
+
+// The tile and its apron, packed into half floats. The targets are half floats already, so packing loses nothing, and
+// it keeps the widest kernel well inside the 32KiB of shared memory every context has.
+shared uvec2 cached[CACHED_SIZE][CACHED_SIZE];
+// Every cached row blurred horizontally, only the tile's columns.
+shared uvec2 horizontal[CACHED_SIZE][TILE_SIZE];
+
+uvec2 packColour(vec3 colour) {
+    return uvec2(packHalf2x16(colour.rg), packHalf2x16(vec2(colour.b, 0.f)));
+}
+
+vec3 unpackColour(uvec2 halves) {
+    return vec3(unpackHalf2x16(halves.x), unpackHalf2x16(halves.y).x);
+}
+
+// Both directions of a blur pass in one go. Each texel is fetched once per workgroup instead of once per tap.
+void main() {
+    ivec2 size = imageSize(blurred);
+    ivec2 cachedOrigin = ivec2(gl_WorkGroupID.xy) * TILE_SIZE - APRON;
+    uint invocations = gl_WorkGroupSize.x * gl_WorkGroupSize.y;
+
+    for(uint i = gl_LocalInvocationIndex; i < CACHED_SIZE * CACHED_SIZE; i += invocations) {
+        ivec2 texel = ivec2(i % CACHED_SIZE, i / CACHED_SIZE);
+        // The centre of the texel in blurred, image is the same size.
+        vec2 texCoords = (vec2(cachedOrigin + texel) + .5f) / vec2(size);
+        cached[texel.y][texel.x] = packColour(textureLod(image, texCoords, 0.f).rgb);
+    }
+    memoryBarrierShared();
+    barrier();
+
+    for(uint i = gl_LocalInvocationIndex; i < CACHED_SIZE * TILE_SIZE; i += invocations) {
+        int row = int(i / TILE_SIZE);
+        int column = int(i % TILE_SIZE);
+        vec3 result = unpackColour(cached[row][column + APRON]) * weight[0];
+        for(int tap = 1; tap < BLUR_TAPS; ++tap) {
+            result += unpackColour(cached[row][column + APRON + tap]) * weight[tap];
+            result += unpackColour(cached[row][column + APRON - tap]) * weight[tap];
+        }
+        horizontal[row][column] = packColour(result);
+    }
+    memoryBarrierShared();
+    barrier();
+
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+    vec3 result = unpackColour(horizontal[local.y + APRON][local.x]) * weight[0];
+    for(int tap = 1; tap < BLUR_TAPS; ++tap) {
+        result += unpackColour(horizontal[local.y + APRON + tap][local.x]) * weight[tap];
+        result += unpackColour(horizontal[local.y + APRON - tap][local.x]) * weight[tap];
+    }
+
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if(all(lessThan(texel, size))) {
+        imageStore(blurred, texel, vec4(result, 1.f));
+    }
+}
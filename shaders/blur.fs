@@ -7,24 +7,27 @@ in vec2 texCoords;
 uniform bool horizontal;
 uniform sampler2D image;
 
-const float weight[5] = float[] (0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162);
+// One side of the kernel, centre tap first, offsets in texels of image. Without defines it is the 9-tap kernel the
+// blur has always had, Bloom builds variants with kernels from gaussianKernel and linearSampledKernel.
+#ifndef BLUR_TAPS
+#define BLUR_TAPS 5
+#define BLUR_OFFSETS 0.f, 1.f, 2.f, 3.f, 4.f
+#define BLUR_WEIGHTS 0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162
+#endif
+
+const float offsets[BLUR_TAPS] = float[] (BLUR_OFFSETS);
+const float weight[BLUR_TAPS] = float[] (BLUR_WEIGHTS);
 
 void main() {
     vec2 texOffset = 1.f / textureSize(image, 0); // Get size of one texel
+    vec2 direction = horizontal ? vec2(texOffset.x, 0.f) : vec2(0.f, texOffset.y);
 
     vec3 result = texture(image, texCoords).rgb * weight[0]; // Contribution of the first texel (the one on the center)
 
-    if(horizontal) {
-        for(int x = 1; x < 5; ++x) {
-            // Go both directions.
-            result += texture(image, texCoords + vec2(texOffset.x * x, 0.f)).rgb * weight[x];
-            result += texture(image, texCoords - vec2(texOffset.x * x, 0.f)).rgb * weight[x];
-        }
-    } else {
-        for(int y = 1; y < 5; ++y) {
-            result += texture(image, texCoords + vec2(0.f, texOffset.y * y)).rgb * weight[y];
-            result += texture(image, texCoords - vec2(0.f, texOffset.y * y)).rgb * weight[y];
-        }
+    for(int i = 1; i < BLUR_TAPS; ++i) {
+        // Go both directions. Offsets between two texels get both, mixed by the bilinear filter.
+        result += texture(image, texCoords + direction * offsets[i]).rgb * weight[i];
+        result += texture(image, texCoords - direction * offsets[i]).rgb * weight[i];
     }
 
     FragColor = vec4(result, 1.f);
@@ -28,11 +28,12 @@ void main() {
         discard;
     }
 
-    // Get normal from normal map, range [0, 1]
-    vec3 normal = texture(normalTexture, texCoords).rgb;
+    // Get normal from normal map, range [0, 1]. Normal maps are compressed to two channels (BC5), so z is rebuilt
+    // from x and y, tangent space normals always point out of the surface.
+    vec2 normalXY = texture(normalTexture, texCoords).rg * 2.f - 1.f;
 
     // Transform normal vector to range [-1, 1]
-    normal = normalize(normal * 2.f - 1.f);
+    vec3 normal = normalize(vec3(normalXY, sqrt(max(1.f - dot(normalXY, normalXY), 0.f))));
 
     vec3 colour = texture(diffuseTexture, texCoords).rgb;
 
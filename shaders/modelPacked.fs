@@ -0,0 +1,76 @@
+#version 330 core
+
+in vec2 TexCoords;
+// UNLIT only takes the diffuse colour, for vertex shaders that don't pass the rest on.
+#ifndef UNLIT
+in vec3 FragmentWorldSpaceCoordinates;
+in vec3 Normal;
+#endif
+
+out vec4 FragColor;
+
+struct DirectionalLight {
+    vec3 position;
+    vec3 colour;
+    vec3 ambient;
+    vec3 specular;
+    vec3 diffuse;
+};
+
+// Model::packTextures moves textures into arrays, each one a layer or a rectangle of an atlas layer.
+uniform sampler2DArray texture_diffuse0;
+uniform float texture_diffuse0Layer;
+uniform vec4 texture_diffuse0Transform;
+uniform sampler2DArray texture_specular0;
+uniform float texture_specular0Layer;
+uniform vec4 texture_specular0Transform;
+
+vec4 samplePacked(sampler2DArray textureArray, float layer, vec4 transform);
+
+#ifdef UNLIT
+void main() {
+    FragColor = samplePacked(texture_diffuse0, texture_diffuse0Layer, texture_diffuse0Transform);
+}
+#else
+uniform DirectionalLight directionalLight;
+
+uniform vec3 viewerPosition;
+
+vec3 gNormal = normalize(Normal);
+
+vec3 computeDirectionalLight(DirectionalLight light);
+
+void main() {
+    vec3 result = computeDirectionalLight(directionalLight);
+
+    FragColor = vec4(result, 1.0);
+}
+#endif
+
+// Tiling has to happen before the offset into the atlas, and the fract would break the derivatives at every seam, so
+// they come from the unwrapped coordinates.
+vec4 samplePacked(sampler2DArray textureArray, float layer, vec4 transform) {
+    vec2 uv = TexCoords * transform.xy;
+    return textureGrad(textureArray, vec3(fract(TexCoords) * transform.xy + transform.zw, layer), dFdx(uv), dFdy(uv));
+}
+
+#ifndef UNLIT
+vec3 computeDirectionalLight(DirectionalLight light) {
+    vec3 diffuseColour = vec3(samplePacked(texture_diffuse0, texture_diffuse0Layer, texture_diffuse0Transform));
+    vec3 specularColour = vec3(samplePacked(texture_specular0, texture_specular0Layer, texture_specular0Transform));
+
+    vec3 ambient = (light.ambient * light.colour) * diffuseColour;
+
+    vec3 lightDirection = normalize(light.position - FragmentWorldSpaceCoordinates);
+    float diffuseFactor = max(dot(gNormal, lightDirection), 0.0);
+
+    vec3 diffuse = (light.diffuse * light.colour) * diffuseFactor * diffuseColour;
+
+    vec3 reflectionDirection = reflect(-lightDirection, gNormal);
+    vec3 viewerDirection = normalize(viewerPosition - FragmentWorldSpaceCoordinates);
+    float specularFactor = pow(max(dot(viewerDirection, reflectionDirection), 0.0), 32);
+    vec3 specular = (light.specular * light.colour) * specularFactor * specularColour;
+
+    return ambient + diffuse + specular;
+}
+#endif
@@ -1,6 +1,7 @@
 
 #version 330 core
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 BrightColor;
 
 in vec3 TexCoords;
 
@@ -8,5 +9,7 @@ uniform samplerCube skybox;
 
 void main() {
     FragColor = texture(skybox, TexCoords);
+    // The sky never blooms.
+    BrightColor = vec4(vec3(0.f), 1.f);
 }
 
@@ -0,0 +1,36 @@
+#include <ImportProfiler.hpp>
+
+#include <cstdlib>
+#include <new>
+
+// Replacing the global allocation functions is the only way to see what Assimp allocates, it has no allocator hook.
+// Only import_profiler links this, everything else keeps the standard allocator.
+void* operator new(std::size_t size) {
+    countThreadAllocation(size);
+
+    if(void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
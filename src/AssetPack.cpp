@@ -0,0 +1,150 @@
+#include <AssetPack.hpp>
+
+#include <assimp/MemoryIOWrapper.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+static const AssetPack* mountedPack{ nullptr };
+
+AssetPack::AssetPack(const std::string& path)
+    :file(path, false)
+{
+    if(!file.isOpen()) {
+        return;
+    }
+
+    PackHeader header{};
+    if(file.size() < sizeof(header)) {
+        std::cerr << "::AssetPack:: file too small to be a pack: " << path << '\n';
+        return;
+    }
+    std::memcpy(&header, file.begin(), sizeof(header));
+
+    if(std::memcmp(header.magic, PackMagic, sizeof(PackMagic)) != 0 || header.version != PackVersion) {
+        std::cerr << "::AssetPack:: not a version " << PackVersion << " pack: " << path << '\n';
+        return;
+    }
+    // Every entry takes at least a PackEntry of the index, which bounds the count before anything is reserved for it.
+    if(header.indexOffset > file.size() || header.indexSize > file.size() - header.indexOffset ||
+       header.entryCount > header.indexSize / sizeof(PackEntry)) {
+        std::cerr << "::AssetPack:: index out of range in " << path << '\n';
+        return;
+    }
+
+    entries.reserve(header.entryCount);
+    entryPaths.reserve(header.entryCount);
+    lookup.reserve(header.entryCount);
+
+    const char* p = file.begin() + header.indexOffset;
+    const char* end = p + header.indexSize;
+    for(std::uint32_t i = 0; i < header.entryCount; ++i) {
+        PackEntry entry{};
+        if(static_cast<std::size_t>(end - p) < sizeof(entry)) {
+            std::cerr << "::AssetPack:: truncated index in " << path << '\n';
+            return;
+        }
+        std::memcpy(&entry, p, sizeof(entry));
+        p += sizeof(entry);
+
+        // Stored entries are handed out as size bytes from offset, so both sizes have to agree for them.
+        if(static_cast<std::size_t>(end - p) < entry.pathLength || entry.offset > file.size() ||
+           entry.storedSize > file.size() - entry.offset ||
+           (!(entry.flags & PACK_COMPRESSED) && entry.size != entry.storedSize)) {
+            std::cerr << "::AssetPack:: corrupt entry " << i << " in " << path << '\n';
+            return;
+        }
+
+        entryPaths.emplace_back(p, entry.pathLength);
+        p += entry.pathLength;
+        lookup.emplace(entryPaths.back(), entries.size());
+        entries.push_back(entry);
+    }
+
+    opened = true;
+}
+
+bool AssetPack::find(const std::string& path, std::span<const char>& bytes) const {
+    const auto found = lookup.find(path);
+    if(found == lookup.end()) {
+        return false;
+    }
+
+    const std::size_t index{ found->second };
+    const PackEntry& entry = entries[index];
+    const char* stored = file.begin() + entry.offset;
+
+    if(!(entry.flags & PACK_COMPRESSED)) {
+        bytes = { stored, entry.size };
+        return true;
+    }
+
+    // Textures may be decoded from several threads, the first one to ask inflates the entry for everybody.
+    const std::lock_guard lock(inflateMutex);
+    auto cached = inflated.find(index);
+    if(cached == inflated.end()) {
+        std::vector<char> buffer(entry.size);
+        uLongf size{ static_cast<uLongf>(entry.size) };
+        if(uncompress(reinterpret_cast<Bytef*>(buffer.data()), &size, reinterpret_cast<const Bytef*>(stored),
+                      static_cast<uLong>(entry.storedSize)) != Z_OK || size != entry.size) {
+            std::cerr << "::AssetPack:: could not inflate " << path << '\n';
+            return false;
+        }
+        cached = inflated.emplace(index, std::move(buffer)).first;
+    }
+
+    bytes = { cached->second.data(), cached->second.size() };
+    return true;
+}
+
+bool AssetPack::contains(const std::string& path) const {
+    return lookup.contains(path);
+}
+
+void mountAssetPack(const AssetPack* pack) {
+    mountedPack = pack;
+}
+
+const AssetPack* mountedAssetPack() {
+    return mountedPack;
+}
+
+std::string normaliseAssetPath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+bool findAsset(const std::string& path, std::span<const char>& bytes) {
+    return mountedPack && mountedPack->find(normaliseAssetPath(path), bytes);
+}
+
+bool hasAsset(const std::string& path) {
+    return mountedPack && mountedPack->contains(normaliseAssetPath(path));
+}
+
+AssetFile::AssetFile(const std::string& path) {
+    if(findAsset(path, bytes)) {
+        opened = true;
+        return;
+    }
+
+    mapped = std::make_unique<MappedFile>(path);
+    if(mapped->isOpen()) {
+        bytes = { mapped->begin(), mapped->size() };
+        opened = true;
+    }
+}
+
+bool PackIOSystem::Exists(const char* file) const {
+    return hasAsset(file) || DefaultIOSystem::Exists(file);
+}
+
+Assimp::IOStream* PackIOSystem::Open(const char* file, const char* mode) {
+    std::span<const char> bytes;
+    if(findAsset(file, bytes)) {
+        return new Assimp::MemoryIOStream(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+    }
+
+    return DefaultIOSystem::Open(file, mode);
+}
@@ -0,0 +1,210 @@
+#include <BlockCompression.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+using Block = std::array<unsigned char, 16 * 4>;
+
+std::size_t blockBytes(const BlockFormat format) {
+    return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+}
+
+std::size_t compressedSize(const BlockFormat format, const int width, const int height) {
+    const auto blocksX = static_cast<std::size_t>((width + 3) / 4);
+    const auto blocksY = static_cast<std::size_t>((height + 3) / 4);
+    return blocksX * blocksY * blockBytes(format);
+}
+
+static void fetchBlock(const unsigned char* rgba, const int width, const int height, const int blockX,
+                       const int blockY, Block& block) {
+    for(int y = 0; y < 4; ++y) {
+        const int sourceY{ std::min(blockY * 4 + y, height - 1) };
+        for(int x = 0; x < 4; ++x) {
+            const int sourceX{ std::min(blockX * 4 + x, width - 1) };
+            const unsigned char* texel = rgba + (static_cast<std::size_t>(sourceY) * static_cast<std::size_t>(width) +
+                                                 static_cast<std::size_t>(sourceX)) * 4;
+            std::copy(texel, texel + 4, block.begin() + (y * 4 + x) * 4);
+        }
+    }
+}
+
+static std::uint16_t packRgb565(const float r, const float g, const float b) {
+    const auto quantise = [](const float value, const float levels) {
+        return static_cast<std::uint16_t>(std::clamp(std::lround(value / 255.f * levels), 0L, static_cast<long>(levels)));
+    };
+    return static_cast<std::uint16_t>(quantise(r, 31.f) << 11 | quantise(g, 63.f) << 5 | quantise(b, 31.f));
+}
+
+static std::array<int, 3> unpackRgb565(const std::uint16_t colour) {
+    const int r{ colour >> 11 & 31 };
+    const int g{ colour >> 5 & 63 };
+    const int b{ colour & 31 };
+    return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+}
+
+static void writeLittleEndian(unsigned char* out, std::uint64_t value, const int bytes) {
+    for(int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<unsigned char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+// Endpoints are the extremes of the block along its principal axis, pulled in a little because the palette never
+// reaches the outliers anyway. Always uses the four colour mode, BC1 punch-through alpha isn't needed here.
+static void encodeColourBlock(const Block& block, unsigned char* out) {
+    std::array<float, 3> mean{ 0.f, 0.f, 0.f };
+    for(int i = 0; i < 16; ++i) {
+        for(int c = 0; c < 3; ++c) {
+            mean[static_cast<std::size_t>(c)] += block[static_cast<std::size_t>(i * 4 + c)];
+        }
+    }
+    for(auto& m : mean) {
+        m /= 16.f;
+    }
+
+    std::array<float, 6> covariance{};
+    for(int i = 0; i < 16; ++i) {
+        const float r{ block[static_cast<std::size_t>(i * 4)] - mean[0] };
+        const float g{ block[static_cast<std::size_t>(i * 4 + 1)] - mean[1] };
+        const float b{ block[static_cast<std::size_t>(i * 4 + 2)] - mean[2] };
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // A few rounds of power iteration are plenty to find the dominant direction of 16 colours.
+    std::array<float, 3> axis{ 1.f, 1.f, 1.f };
+    for(int iteration = 0; iteration < 4; ++iteration) {
+        const std::array<float, 3> next{
+            covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+            covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+            covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2],
+        };
+        const float length{ std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) }) };
+        if(length < 1e-6f) {
+            break;
+        }
+        axis = { next[0] / length, next[1] / length, next[2] / length };
+    }
+
+    float minimum{ 0.f };
+    float maximum{ 0.f };
+    for(int i = 0; i < 16; ++i) {
+        float t{ 0.f };
+        for(int c = 0; c < 3; ++c) {
+            t += (block[static_cast<std::size_t>(i * 4 + c)] - mean[static_cast<std::size_t>(c)]) *
+                 axis[static_cast<std::size_t>(c)];
+        }
+        minimum = std::min(minimum, t);
+        maximum = std::max(maximum, t);
+    }
+    const float inset{ (maximum - minimum) / 16.f };
+    minimum += inset;
+    maximum -= inset;
+
+    std::uint16_t colour0{ packRgb565(mean[0] + axis[0] * maximum, mean[1] + axis[1] * maximum,
+                                      mean[2] + axis[2] * maximum) };
+    std::uint16_t colour1{ packRgb565(mean[0] + axis[0] * minimum, mean[1] + axis[1] * minimum,
+                                      mean[2] + axis[2] * minimum) };
+    if(colour0 < colour1) {
+        std::swap(colour0, colour1);
+    }
+
+    const auto endpoint0 = unpackRgb565(colour0);
+    const auto endpoint1 = unpackRgb565(colour1);
+    std::array<std::array<int, 3>, 4> palette{ endpoint0, endpoint1, {}, {} };
+    for(std::size_t c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * endpoint0[c] + endpoint1[c]) / 3;
+        palette[3][c] = (endpoint0[c] + 2 * endpoint1[c]) / 3;
+    }
+
+    std::uint32_t indices{ 0 };
+    // Equal endpoints mean three colour mode, where index 0 is still colour0, so leaving every index at 0 is right.
+    if(colour0 != colour1) {
+        for(int i = 0; i < 16; ++i) {
+            int best{ 0 };
+            int bestDistance{ 1 << 30 };
+            for(int p = 0; p < 4; ++p) {
+                int distance{ 0 };
+                for(std::size_t c = 0; c < 3; ++c) {
+                    const int delta{ block[static_cast<std::size_t>(i * 4) + c] - palette[static_cast<std::size_t>(p)][c] };
+                    distance += delta * delta;
+                }
+                if(distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= static_cast<std::uint32_t>(best) << (i * 2);
+        }
+    }
+
+    writeLittleEndian(out, colour0, 2);
+    writeLittleEndian(out + 2, colour1, 2);
+    writeLittleEndian(out + 4, indices, 4);
+}
+
+// Eight value mode with the block's own extremes as endpoints. The palette is evenly spaced between them, so the
+// nearest entry is found by rounding instead of searching.
+static void encodeChannelBlock(const Block& block, const int channel, unsigned char* out) {
+    unsigned char minimum{ 255 };
+    unsigned char maximum{ 0 };
+    for(int i = 0; i < 16; ++i) {
+        const unsigned char value{ block[static_cast<std::size_t>(i * 4 + channel)] };
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+    }
+
+    std::uint64_t indices{ 0 };
+    if(maximum != minimum) {
+        const int range{ maximum - minimum };
+        for(int i = 0; i < 16; ++i) {
+            const int value{ block[static_cast<std::size_t>(i * 4 + channel)] - minimum };
+            // Steps from minimum (0) to maximum (7), which are palette entries 1 and 0, the rest run 7 down to 2.
+            const int step{ (value * 7 + range / 2) / range };
+            const int index{ step == 7 ? 0 : step == 0 ? 1 : 8 - step };
+            indices |= static_cast<std::uint64_t>(index) << (i * 3);
+        }
+    }
+
+    out[0] = maximum;
+    out[1] = minimum;
+    writeLittleEndian(out + 2, indices, 6);
+}
+
+std::vector<unsigned char> compressBlocks(const unsigned char* rgba, const int width, const int height,
+                                          const BlockFormat format) {
+    std::vector<unsigned char> output(compressedSize(format, width, height));
+    unsigned char* out = output.data();
+
+    Block block;
+    for(int blockY = 0; blockY < (height + 3) / 4; ++blockY) {
+        for(int blockX = 0; blockX < (width + 3) / 4; ++blockX) {
+            fetchBlock(rgba, width, height, blockX, blockY, block);
+            switch(format) {
+            case BlockFormat::BC1:
+                encodeColourBlock(block, out);
+                break;
+            case BlockFormat::BC3:
+                encodeChannelBlock(block, 3, out);
+                encodeColourBlock(block, out + 8);
+                break;
+            case BlockFormat::BC4:
+                encodeChannelBlock(block, 0, out);
+                break;
+            case BlockFormat::BC5:
+                encodeChannelBlock(block, 0, out);
+                encodeChannelBlock(block, 1, out + 8);
+                break;
+            }
+            out += blockBytes(format);
+        }
+    }
+
+    return output;
+}
@@ -0,0 +1,252 @@
+#include <Bloom.hpp>
+
+#include <GLExtensions.hpp>
+#include <GaussianKernel.hpp>
+#include <TextureManager.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string>
+
+// Texture fetches per pixel of the progressive passes: 13 taps down, 9 taps of the level below and 1 of the current one
+// up.
+static constexpr std::size_t DownsampleFetches{ 13 };
+static constexpr std::size_t UpsampleFetches{ 10 };
+
+static std::size_t pixels(const RenderTargetDesc& desc) {
+    return static_cast<std::size_t>(desc.width) * static_cast<std::size_t>(desc.height);
+}
+
+Bloom::Bloom()
+    :downsample("./shaders/blur.vs", "./shaders/bloomDownsample.fs"),
+     upsample("./shaders/blur.vs", "./shaders/bloomUpsample.fs")
+{
+    for(const int blurRadius : BlurRadii) {
+        for(const bool linearSampling : { false, true }) {
+            const GaussianKernel discrete{ gaussianKernel(static_cast<float>(blurRadius) / 2.f, blurRadius) };
+            const GaussianKernel kernel{ linearSampling ? linearSampledKernel(discrete) : discrete };
+            blurVariants.push_back(BlurVariant{
+                .shader = Shader("./shaders/blur.vs", "./shaders/blur.fs", ShaderDefines{ kernelDefines(kernel) }),
+                .radius = blurRadius,
+                .linearSampling = linearSampling,
+                .compute = false,
+                .taps = kernel.weights.size(),
+            });
+            blurVariants.back().shader.use();
+            blurVariants.back().shader.setUniformInt("image", 0);
+        }
+        if(dispatchCompute) {
+            const GaussianKernel kernel{ gaussianKernel(static_cast<float>(blurRadius) / 2.f, blurRadius) };
+            blurVariants.push_back(BlurVariant{
+                .shader = Shader("./shaders/blur.cs", ShaderDefines{ kernelDefines(kernel) }),
+                .radius = blurRadius,
+                .linearSampling = false,
+                .compute = true,
+                .taps = kernel.weights.size(),
+            });
+            blurVariants.back().shader.use();
+            blurVariants.back().shader.setUniformInt("image", 0);
+        }
+    }
+    downsample.use();
+    downsample.setUniformInt("source", 0);
+    upsample.use();
+    upsample.setUniformInt("lower", 0);
+    upsample.setUniformInt("current", 1);
+
+    constexpr std::array<float, 20> quadVertices{
+        // positions        // texture Coords
+        -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+         1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+    };
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+Bloom::~Bloom() {
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteVertexArrays(1, &quadVAO);
+}
+
+FrameResource Bloom::addPasses(FrameGraph& graph, const FrameResource bright, const RenderTargetDesc& desc,
+                               const BloomMode mode) {
+    if(mode == BloomMode::PROGRESSIVE) {
+        return addProgressivePasses(graph, bright, desc);
+    }
+    return computeBlur() ? addComputeBlurPasses(graph, bright, desc) : addGaussianPasses(graph, bright, desc);
+}
+
+std::size_t Bloom::fetches() const {
+    return passFetches;
+}
+
+float Bloom::strength(const BloomMode mode) {
+    return mode == BloomMode::PROGRESSIVE ? 1.f / static_cast<float>(ProgressiveLevels) : 1.f;
+}
+
+void Bloom::drawQuad() const {
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+}
+
+bool Bloom::computeBlur() const {
+    return gaussian.compute && dispatchCompute;
+}
+
+// The smallest kernel at least as wide as asked for, or the widest there is.
+const Bloom::BlurVariant& Bloom::blurVariant() const {
+    const bool compute{ computeBlur() };
+    const BlurVariant* chosen{ nullptr };
+    for(const auto& variant : blurVariants) {
+        if(variant.compute != compute || (!compute && variant.linearSampling != gaussian.linearSampling)) {
+            continue;
+        }
+        if(!chosen || (chosen->radius < gaussian.radius && variant.radius > chosen->radius)) {
+            chosen = &variant;
+        }
+    }
+    return *chosen;
+}
+
+// A single bilinear fetch per target texel would only average 2x2 of the 4x4 texels under it at a quarter of the size,
+// and the blur's taps are spaced by the texels of what it reads, so the blur has to start from a target of its own size.
+FrameResource Bloom::addDownscalePasses(FrameGraph& graph, const FrameResource bright, const RenderTargetDesc& desc,
+                                        RenderTargetDesc& scaledDesc) {
+    const auto downscale = static_cast<unsigned int>(std::clamp(gaussian.downscale, 1, 4));
+    const int levels{ static_cast<int>(std::bit_width(downscale)) - 1 };
+    FrameResource source{ bright };
+    scaledDesc = desc;
+    passFetches = 0;
+    for(int level{ 0 }; level < levels; ++level) {
+        scaledDesc.width = std::max(1, desc.width >> (level + 1));
+        scaledDesc.height = std::max(1, desc.height >> (level + 1));
+        passFetches += pixels(scaledDesc) * DownsampleFetches;
+        FrameResource scaled{};
+        graph.addPass("blur downsample", [&](FramePassBuilder& pass) {
+            pass.read(source);
+            scaled = pass.createColour("blur downsampled", scaledDesc);
+        }, [this, source](const FramePassResources& resources) {
+            downsample.use();
+            bindTexture(0, GL_TEXTURE_2D, resources.texture(source));
+            drawQuad();
+        });
+        source = scaled;
+    }
+    return source;
+}
+
+// Each pass renders into a target of its own, which the graph fits into two textures.
+FrameResource Bloom::addGaussianPasses(FrameGraph& graph, const FrameResource bright, const RenderTargetDesc& desc) {
+    const BlurVariant& variant = blurVariant();
+    RenderTargetDesc blurDesc{};
+    FrameResource blurred{ addDownscalePasses(graph, bright, desc, blurDesc) };
+    passFetches += GaussianPasses * pixels(blurDesc) * (2 * variant.taps - 1);
+
+    for(unsigned int i{ 0 }; i < GaussianPasses; ++i) {
+        const bool horizontal{ i % 2 == 0 };
+        const FrameResource source{ blurred };
+        graph.addPass("gaussian blur", [&](FramePassBuilder& pass) {
+            pass.read(source);
+            blurred = pass.createColour("blurred", blurDesc);
+        }, [&variant, this, source, horizontal](const FramePassResources& resources) {
+            const Shader& blur = variant.shader;
+            glUseProgram(blur.id);
+            blur.setUniformInt("horizontal", horizontal);
+            bindTexture(0, GL_TEXTURE_2D, resources.texture(source));
+            drawQuad();
+        });
+    }
+    return blurred;
+}
+
+// Each dispatch blurs a pair of passes into a target of its own, so there are half as many targets for the graph to fit
+// into two textures.
+FrameResource Bloom::addComputeBlurPasses(FrameGraph& graph, const FrameResource bright,
+                                          const RenderTargetDesc& desc) {
+    const BlurVariant& variant = blurVariant();
+    RenderTargetDesc blurDesc{};
+    FrameResource blurred{ addDownscalePasses(graph, bright, desc, blurDesc) };
+    const GLuint groupsX{ static_cast<GLuint>((blurDesc.width + ComputeTileSize - 1) / ComputeTileSize) };
+    const GLuint groupsY{ static_cast<GLuint>((blurDesc.height + ComputeTileSize - 1) / ComputeTileSize) };
+    // Every workgroup fetches its tile and the apron, the taps themselves read shared memory.
+    const std::size_t cachedSize{ static_cast<std::size_t>(ComputeTileSize) + 2 * (variant.taps - 1) };
+    passFetches += GaussianPasses / 2 * groupsX * groupsY * cachedSize * cachedSize;
+
+    for(unsigned int i{ 0 }; i < GaussianPasses / 2; ++i) {
+        const FrameResource source{ blurred };
+        graph.addPass("compute blur", [&](FramePassBuilder& pass) {
+            pass.compute();
+            pass.read(source);
+            blurred = pass.createColour("blurred", blurDesc);
+            computeTargets[i] = blurred;
+        }, [&variant, this, i, source, blurDesc, groupsX, groupsY](const FramePassResources& resources) {
+            glUseProgram(variant.shader.id);
+            bindTexture(0, GL_TEXTURE_2D, resources.texture(source));
+            bindImageTexture(0, resources.texture(computeTargets[i]), 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                             blurDesc.internalFormat);
+            dispatchCompute(groupsX, groupsY, 1);
+            // Whatever reads the target next samples it.
+            memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        });
+    }
+    return blurred;
+}
+
+// Each level is downsampled from the one above it, then every level but the last gets the one below tent filtered onto
+// it on the way back up. The passes get cheaper by four each level, so the whole chain costs less than two passes at
+// full resolution.
+FrameResource Bloom::addProgressivePasses(FrameGraph& graph, const FrameResource bright, const RenderTargetDesc& desc) {
+    std::array<FrameResource, ProgressiveLevels> downsampled{};
+    std::array<RenderTargetDesc, ProgressiveLevels> levelDescs{};
+    FrameResource source{ bright };
+    passFetches = 0;
+    for(int level{ 0 }; level < ProgressiveLevels; ++level) {
+        RenderTargetDesc& levelDesc = levelDescs[level];
+        levelDesc = desc;
+        levelDesc.width = std::max(1, desc.width >> (level + 1));
+        levelDesc.height = std::max(1, desc.height >> (level + 1));
+        passFetches += pixels(levelDesc) * DownsampleFetches;
+        graph.addPass("bloom downsample", [&](FramePassBuilder& pass) {
+            pass.read(source);
+            downsampled[level] = pass.createColour("bloom level " + std::to_string(level + 1), levelDesc);
+        }, [this, source](const FramePassResources& resources) {
+            downsample.use();
+            bindTexture(0, GL_TEXTURE_2D, resources.texture(source));
+            drawQuad();
+        });
+        source = downsampled[level];
+    }
+
+    FrameResource lower{ downsampled.back() };
+    for(int level{ ProgressiveLevels - 2 }; level >= 0; --level) {
+        const FrameResource current{ downsampled[level] };
+        passFetches += pixels(levelDescs[level]) * UpsampleFetches;
+        FrameResource upsampled{};
+        graph.addPass("bloom upsample", [&](FramePassBuilder& pass) {
+            pass.read(lower);
+            pass.read(current);
+            upsampled = pass.createColour("bloom upsampled " + std::to_string(level + 1), levelDescs[level]);
+        }, [this, lower, current](const FramePassResources& resources) {
+            upsample.use();
+            upsample.setUniformFloat("filterRadius", radius);
+            bindTexture(0, GL_TEXTURE_2D, resources.texture(lower));
+            bindTexture(1, GL_TEXTURE_2D, resources.texture(current));
+            drawQuad();
+        });
+        lower = upsampled;
+    }
+    return lower;
+}
@@ -0,0 +1,132 @@
+#include <Bounds.hpp>
+#include <Mesh.hpp>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+Bounds computeBounds(const std::vector<Vertex>& vertices) {
+    Bounds bounds;
+    if(vertices.empty()) {
+        return bounds;
+    }
+
+    const std::size_t count{ vertices.size() };
+    float radiusSquared{ 0.f };
+
+#ifdef __SSE__
+    // Vertex starts with its position, so one unaligned load picks up x, y, z (plus normal.x in the unused lane). Two
+    // accumulators per bound keep both min/max units busy.
+    static_assert(offsetof(Vertex, position) == 0 && sizeof(Vertex) >= 4 * sizeof(float));
+    const float* base = &vertices[0].position.x;
+    constexpr std::size_t Stride{ sizeof(Vertex) / sizeof(float) };
+
+    __m128 minA = _mm_set1_ps(FLT_MAX), minB = minA;
+    __m128 maxA = _mm_set1_ps(-FLT_MAX), maxB = maxA;
+    std::size_t i{ 0 };
+    for(; i + 2 <= count; i += 2) {
+        const __m128 a = _mm_loadu_ps(base + i * Stride);
+        const __m128 b = _mm_loadu_ps(base + (i + 1) * Stride);
+        minA = _mm_min_ps(minA, a);
+        maxA = _mm_max_ps(maxA, a);
+        minB = _mm_min_ps(minB, b);
+        maxB = _mm_max_ps(maxB, b);
+    }
+    if(i < count) {
+        const __m128 a = _mm_loadu_ps(base + i * Stride);
+        minA = _mm_min_ps(minA, a);
+        maxA = _mm_max_ps(maxA, a);
+    }
+
+    alignas(16) float minimum[4], maximum[4];
+    _mm_store_ps(minimum, _mm_min_ps(minA, minB));
+    _mm_store_ps(maximum, _mm_max_ps(maxA, maxB));
+    bounds.box.min = glm::vec3(minimum[0], minimum[1], minimum[2]);
+    bounds.box.max = glm::vec3(maximum[0], maximum[1], maximum[2]);
+
+    // The sphere needs the centre first, so its radius takes a second pass. Four positions are transposed at a time so
+    // the distances come out of plain vertical multiplies and adds.
+    const glm::vec3 centre = bounds.box.centre();
+    const __m128 cx = _mm_set1_ps(centre.x), cy = _mm_set1_ps(centre.y), cz = _mm_set1_ps(centre.z);
+    __m128 farthest = _mm_setzero_ps();
+    i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(base + i * Stride);
+        __m128 y = _mm_loadu_ps(base + (i + 1) * Stride);
+        __m128 z = _mm_loadu_ps(base + (i + 2) * Stride);
+        __m128 w = _mm_loadu_ps(base + (i + 3) * Stride);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        const __m128 dx = _mm_sub_ps(x, cx);
+        const __m128 dy = _mm_sub_ps(y, cy);
+        const __m128 dz = _mm_sub_ps(z, cz);
+        const __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        farthest = _mm_max_ps(farthest, distanceSquared);
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, farthest);
+    radiusSquared = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    for(; i < count; ++i) {
+        const glm::vec3 d = vertices[i].position - centre;
+        radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+    }
+#else
+    bounds.box.min = bounds.box.max = vertices[0].position;
+    for(const auto& vertex : vertices) {
+        bounds.box.min = glm::min(bounds.box.min, vertex.position);
+        bounds.box.max = glm::max(bounds.box.max, vertex.position);
+    }
+
+    const glm::vec3 centre = bounds.box.centre();
+    for(const auto& vertex : vertices) {
+        const glm::vec3 d = vertex.position - centre;
+        radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+    }
+#endif
+
+    bounds.sphere.centre = centre;
+    bounds.sphere.radius = std::sqrt(radiusSquared);
+    return bounds;
+}
+
+Bounds mergeBounds(const Bounds& a, const Bounds& b) {
+    Bounds merged;
+    merged.box.min = glm::min(a.box.min, b.box.min);
+    merged.box.max = glm::max(a.box.max, b.box.max);
+
+    merged.sphere.centre = merged.box.centre();
+    merged.sphere.radius = std::max(glm::length(a.sphere.centre - merged.sphere.centre) + a.sphere.radius,
+                                    glm::length(b.sphere.centre - merged.sphere.centre) + b.sphere.radius);
+    return merged;
+}
+
+AABB transformAABB(const AABB& box, const glm::mat4& transform) {
+    // Arvo's method: the new extents are the old ones run through the absolute value of the linear part.
+    const glm::vec3 centre = glm::vec3(transform * glm::vec4(box.centre(), 1.f));
+    const glm::vec3 extents = box.extents();
+    glm::vec3 newExtents{ 0.f };
+    for(int column = 0; column < 3; ++column) {
+        newExtents += glm::abs(glm::vec3(transform[column])) * extents[column];
+    }
+
+    return AABB{ .min = centre - newExtents, .max = centre + newExtents };
+}
+
+BoundingSphere transformSphere(const BoundingSphere& sphere, const glm::mat4& transform) {
+    const float scale = std::sqrt(std::max({
+        glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+        glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+        glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2])),
+    }));
+
+    return BoundingSphere{
+        .centre = glm::vec3(transform * glm::vec4(sphere.centre, 1.f)),
+        .radius = sphere.radius * scale,
+    };
+}
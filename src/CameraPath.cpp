@@ -0,0 +1,73 @@
+#include <CameraPath.hpp>
+#include <AssetPack.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static constexpr std::array<char, 4> CameraPathIdentifier{ 'C', 'P', 'T', 'H' };
+static constexpr std::uint32_t CameraPathVersion{ 1 };
+
+struct CameraPathHeader {
+    std::array<char, 4> identifier;
+    std::uint32_t version;
+    double stepSeconds;
+    std::uint64_t sampleCount;
+};
+
+static_assert(sizeof(CameraPathHeader) == 24, "CameraPathHeader is read and written as it is");
+static_assert(sizeof(CameraSample) == 6 * sizeof(float), "CameraSample is read and written as it is");
+
+bool writeCameraPath(const std::string& path, const CameraPath& cameraPath) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()) {
+        std::cerr << "::writeCameraPath:: could not create " << path << '\n';
+        return false;
+    }
+
+    const CameraPathHeader header{
+        .identifier = CameraPathIdentifier,
+        .version = CameraPathVersion,
+        .stepSeconds = cameraPath.stepSeconds,
+        .sampleCount = cameraPath.samples.size(),
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(cameraPath.samples.data()),
+               static_cast<std::streamsize>(cameraPath.samples.size() * sizeof(CameraSample)));
+
+    if(!file) {
+        std::cerr << "::writeCameraPath:: could not write " << path << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool readCameraPath(const std::string& path, CameraPath& cameraPath) {
+    const AssetFile file(path);
+    if(!file.isOpen()) {
+        return false;
+    }
+
+    CameraPathHeader header{};
+    if(file.size() < sizeof(header)) {
+        std::cerr << "::readCameraPath:: truncated file " << path << '\n';
+        return false;
+    }
+    std::memcpy(&header, file.begin(), sizeof(header));
+    if(header.identifier != CameraPathIdentifier || header.version != CameraPathVersion) {
+        std::cerr << "::readCameraPath:: not a version " << CameraPathVersion << " camera path " << path << '\n';
+        return false;
+    }
+    if((file.size() - sizeof(header)) / sizeof(CameraSample) < header.sampleCount) {
+        std::cerr << "::readCameraPath:: truncated file " << path << '\n';
+        return false;
+    }
+
+    cameraPath.stepSeconds = header.stepSeconds;
+    cameraPath.samples.resize(static_cast<std::size_t>(header.sampleCount));
+    std::memcpy(cameraPath.samples.data(), file.begin() + sizeof(header),
+                cameraPath.samples.size() * sizeof(CameraSample));
+    return true;
+}
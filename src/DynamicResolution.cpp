@@ -0,0 +1,77 @@
+#include <DynamicResolution.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution(const double gpuBudgetMs, const float minScale, const float maxScale)
+    :budgetMs(gpuBudgetMs),
+     minSteps(std::max(1, static_cast<int>(std::lround(minScale / ScaleStep)))),
+     maxSteps(std::max(minSteps, static_cast<int>(std::lround(maxScale / ScaleStep)))),
+     steps(maxSteps)
+{}
+
+float DynamicResolution::update(const FrameTimer& timer) {
+    // FrameTimer reads GPU times back in order, so the first one still missing ends the new ones.
+    bool measured{ false };
+    const std::size_t drawn{ scaleStats.frames };
+    nextTiming = std::max({ nextTiming, timer.firstKeptFrame(), drawn - std::min(drawn, RecentFrames) });
+    for(; nextTiming < timer.frameCount() && nextTiming < drawn && timer.timing(nextTiming).gpuMs >= 0.0;
+        ++nextTiming) {
+        const double frameScale{ recentScales[nextTiming % RecentFrames] };
+        estimates[estimateCount++ % EstimateFrames] = timer.timing(nextTiming).gpuMs / (frameScale * frameScale);
+        measured = true;
+    }
+
+    if(budgetMs > 0.0 && measured && nextTiming >= changedAt + SettleFrames) {
+        const int picked{ pickSteps() };
+        if(picked != steps) {
+            steps = picked;
+            changedAt = drawn;
+        }
+    }
+
+    const float picked{ scale() };
+    recentScales[drawn % RecentFrames] = picked;
+    scaleStats.lowestScale = drawn == 0 ? picked : std::min(scaleStats.lowestScale, picked);
+    scaleStats.scaleSum += picked;
+    scaleStats.belowFullFrames += picked < 1.f ? 1 : 0;
+    ++scaleStats.frames;
+    return picked;
+}
+
+float DynamicResolution::scale() const {
+    return static_cast<float>(steps) * ScaleStep;
+}
+
+RenderTargetDesc DynamicResolution::scaled(const RenderTargetDesc& desc) const {
+    RenderTargetDesc scaledDesc{ desc };
+    scaledDesc.width = std::max(1, static_cast<int>(std::lround(static_cast<float>(desc.width) * scale())));
+    scaledDesc.height = std::max(1, static_cast<int>(std::lround(static_cast<float>(desc.height) * scale())));
+    return scaledDesc;
+}
+
+const RenderScaleStats& DynamicResolution::stats() const {
+    return scaleStats;
+}
+
+double DynamicResolution::fullResolutionMs() const {
+    std::array<double, EstimateFrames> sorted{ estimates };
+    const std::size_t count{ std::min(estimateCount, EstimateFrames) };
+    std::sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(count));
+    return sorted[count / 2];
+}
+
+// Over budget, straight to the scale the estimate says fits with some room to spare. Well under it, a step up.
+int DynamicResolution::pickSteps() const {
+    const double estimateMs{ fullResolutionMs() };
+    const double current{ scale() };
+    if(estimateMs * current * current > budgetMs) {
+        const double wanted{ std::sqrt(budgetMs * TargetFraction / estimateMs) };
+        return std::clamp(static_cast<int>(std::floor(wanted / ScaleStep)), minSteps, steps);
+    }
+    const double raised{ static_cast<double>(steps + 1) * ScaleStep };
+    if(steps < maxSteps && estimateMs * raised * raised < budgetMs * RaiseFraction) {
+        return steps + 1;
+    }
+    return steps;
+}
@@ -0,0 +1,44 @@
+#include <FixedTimestep.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(const double stepLength, const unsigned int maxStepsPerFrame)
+    :stepSeconds(stepLength), maxSteps(std::max(1u, maxStepsPerFrame))
+{
+}
+
+unsigned int FixedTimestep::advance(const double frameSeconds) {
+    accumulated += std::max(0.0, frameSeconds);
+
+    unsigned int due{ 0 };
+    while(accumulated >= stepSeconds && due < maxSteps) {
+        accumulated -= stepSeconds;
+        ++due;
+    }
+    // Whatever is still owed after maxSteps is dropped, except for the part of a step it would carry anyway.
+    if(accumulated >= stepSeconds) {
+        const double kept{ std::fmod(accumulated, stepSeconds) };
+        dropped += accumulated - kept;
+        accumulated = kept;
+    }
+
+    steps += due;
+    return due;
+}
+
+float FixedTimestep::step() const {
+    return static_cast<float>(stepSeconds);
+}
+
+float FixedTimestep::alpha() const {
+    return static_cast<float>(accumulated / stepSeconds);
+}
+
+std::uint64_t FixedTimestep::stepCount() const {
+    return steps;
+}
+
+double FixedTimestep::droppedSeconds() const {
+    return dropped;
+}
@@ -0,0 +1,318 @@
+#include <FrameGraph.hpp>
+
+#include <GLExtensions.hpp>
+#include <TextureManager.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+static bool hasStencil(const GLenum internalFormat) {
+    return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+static bool isDepth(const GLenum internalFormat) {
+    return hasStencil(internalFormat) || internalFormat == GL_DEPTH_COMPONENT16 ||
+           internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F;
+}
+
+std::size_t renderTargetBytes(const RenderTargetDesc& desc) {
+    std::size_t bytesPerPixel{ 4 };
+    switch(desc.internalFormat) {
+    case GL_RGBA32F:
+        bytesPerPixel = 16;
+        break;
+    case GL_RGBA16F:
+    case GL_DEPTH32F_STENCIL8:
+        bytesPerPixel = 8;
+        break;
+    case GL_R16F:
+    case GL_DEPTH_COMPONENT16:
+        bytesPerPixel = 2;
+        break;
+    default:
+        // RGBA8, RG16F, R11F_G11F_B10F and the 24 and 32 bit depth formats.
+        break;
+    }
+    return static_cast<std::size_t>(desc.width) * static_cast<std::size_t>(desc.height) * bytesPerPixel;
+}
+
+FramePassBuilder::FramePassBuilder(FrameGraph& owner, const std::size_t index)
+    :graph(owner), pass(index)
+{}
+
+FrameResource FramePassBuilder::createColour(const std::string& name, const RenderTargetDesc& desc) {
+    const FrameResource resource{ graph.createResource(pass, name, desc, false) };
+    graph.passes[pass].colourWrites.push_back(resource);
+    return resource;
+}
+
+FrameResource FramePassBuilder::createDepth(const std::string& name, const RenderTargetDesc& desc) {
+    const FrameResource resource{ graph.createResource(pass, name, desc, true) };
+    graph.passes[pass].depthWrite = resource;
+    graph.passes[pass].writesDepth = true;
+    return resource;
+}
+
+void FramePassBuilder::read(const FrameResource resource) {
+    graph.passes[pass].reads.push_back(resource);
+}
+
+void FramePassBuilder::writeBackbuffer() {
+    graph.passes[pass].writesBackbuffer = true;
+}
+
+void FramePassBuilder::compute() {
+    graph.passes[pass].compute = true;
+}
+
+FramePassResources::FramePassResources(const FrameGraph& owner)
+    :graph(owner)
+{}
+
+unsigned int FramePassResources::texture(const FrameResource resource) const {
+    return graph.textureOf(resource);
+}
+
+FrameGraph::~FrameGraph() {
+    for(const auto& [attachments, framebuffer] : framebuffers) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+    for(const auto& target : pool) {
+        releaseTexture(target.texture);
+    }
+}
+
+void FrameGraph::addPass(const std::string& name, const std::function<void(FramePassBuilder&)>& setup,
+                         std::function<void(const FramePassResources&)> execute) {
+    Pass& pass = passes.emplace_back();
+    pass.name = name;
+    pass.execute = std::move(execute);
+    FramePassBuilder builder{ *this, passes.size() - 1 };
+    setup(builder);
+}
+
+void FrameGraph::execute() {
+    ++frameNumber;
+    cull();
+
+    frameStats.passes = passes.size();
+    frameStats.culledPasses = 0;
+    frameStats.resources = resources.size();
+    frameStats.transientBytes = 0;
+    frameStats.readBytes = 0;
+
+    // Passes drawing to the default framebuffer get the viewport the frame started with back.
+    std::array<GLint, 4> backbufferViewport{};
+    glGetIntegerv(GL_VIEWPORT, backbufferViewport.data());
+
+    const FramePassResources passResources{ *this };
+    for(std::size_t i = 0; i < passes.size(); ++i) {
+        Pass& pass = passes[i];
+        if(pass.culled) {
+            ++frameStats.culledPasses;
+            continue;
+        }
+
+        // Targets nobody reads get no memory, except depth, which the pass itself tests against.
+        std::vector<FrameResource> written{ pass.colourWrites };
+        if(pass.writesDepth) {
+            written.push_back(pass.depthWrite);
+        }
+        for(const FrameResource resource : written) {
+            Resource& target = resources[resource];
+            if(target.readers > 0 || target.depth) {
+                target.pooled = acquire(target.desc);
+                frameStats.transientBytes += renderTargetBytes(target.desc);
+            }
+        }
+
+        if(pass.writesBackbuffer) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(backbufferViewport[0], backbufferViewport[1], backbufferViewport[2], backbufferViewport[3]);
+        } else if(!pass.compute) {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebufferFor(pass));
+            const RenderTargetDesc& size = resources[written.front()].desc;
+            glViewport(0, 0, size.width, size.height);
+        }
+        pass.execute(passResources);
+        for(const FrameResource resource : pass.reads) {
+            frameStats.readBytes += renderTargetBytes(resources[resource].desc);
+        }
+
+        // Whatever this pass was the last to touch goes back to the pool for the passes after it.
+        for(const FrameResource resource : written) {
+            const Resource& target = resources[resource];
+            if(target.pooled != NoIndex && target.readers == 0) {
+                pool[target.pooled].inUse = false;
+            }
+        }
+        for(const FrameResource resource : pass.reads) {
+            const Resource& target = resources[resource];
+            if(target.lastReader == i && target.pooled != NoIndex) {
+                pool[target.pooled].inUse = false;
+            }
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(backbufferViewport[0], backbufferViewport[1], backbufferViewport[2], backbufferViewport[3]);
+
+    passes.clear();
+    resources.clear();
+    releaseUnused(UnusedFramesBeforeRelease);
+}
+
+void FrameGraph::trim() {
+    releaseUnused(0);
+}
+
+const FrameGraphStats& FrameGraph::stats() const {
+    return frameStats;
+}
+
+FrameResource FrameGraph::createResource(const std::size_t pass, const std::string& name, const RenderTargetDesc& desc,
+                                         const bool depth) {
+    resources.push_back(Resource{ .name = name, .desc = desc, .depth = depth, .writer = pass });
+    return static_cast<FrameResource>(resources.size() - 1);
+}
+
+// Reference counting from the backbuffer back: a pass stays while something that stays reads what it writes.
+void FrameGraph::cull() {
+    for(auto& pass : passes) {
+        for(const FrameResource resource : pass.reads) {
+            ++resources[resource].readers;
+        }
+    }
+    std::vector<std::size_t> unreferenced;
+    for(std::size_t i = 0; i < passes.size(); ++i) {
+        Pass& pass = passes[i];
+        pass.references = pass.writesBackbuffer ? 1 : 0;
+        for(const FrameResource resource : pass.colourWrites) {
+            pass.references += resources[resource].readers > 0 ? 1 : 0;
+        }
+        if(pass.writesDepth) {
+            pass.references += resources[pass.depthWrite].readers > 0 ? 1 : 0;
+        }
+        if(pass.references == 0) {
+            unreferenced.push_back(i);
+        }
+    }
+
+    while(!unreferenced.empty()) {
+        Pass& pass = passes[unreferenced.back()];
+        unreferenced.pop_back();
+        pass.culled = true;
+        for(const FrameResource resource : pass.reads) {
+            Resource& target = resources[resource];
+            if(--target.readers == 0 && --passes[target.writer].references == 0) {
+                unreferenced.push_back(target.writer);
+            }
+        }
+    }
+
+    for(std::size_t i = 0; i < passes.size(); ++i) {
+        if(!passes[i].culled) {
+            for(const FrameResource resource : passes[i].reads) {
+                resources[resource].lastReader = i;
+            }
+        }
+    }
+}
+
+unsigned int FrameGraph::textureOf(const FrameResource resource) const {
+    const std::size_t pooled{ resources[resource].pooled };
+    return pooled == NoIndex ? 0 : pool[pooled].texture;
+}
+
+std::size_t FrameGraph::acquire(const RenderTargetDesc& desc) {
+    for(std::size_t i = 0; i < pool.size(); ++i) {
+        if(!pool[i].inUse && pool[i].desc == desc) {
+            pool[i].inUse = true;
+            pool[i].lastUsedFrame = frameNumber;
+            return i;
+        }
+    }
+
+    unsigned int texture{ 0 };
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if(texStorage2D) {
+        texStorage2D(GL_TEXTURE_2D, 1, desc.internalFormat, desc.width, desc.height);
+    } else {
+        const GLenum format = hasStencil(desc.internalFormat) ? GL_DEPTH_STENCIL
+                              : isDepth(desc.internalFormat) ? GL_DEPTH_COMPONENT : GL_RGBA;
+        const GLenum type = hasStencil(desc.internalFormat) ? GL_UNSIGNED_INT_24_8 : GL_FLOAT;
+        glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(desc.internalFormat), desc.width, desc.height, 0, format,
+                     type, nullptr);
+    }
+    manageTexture(texture, GL_TEXTURE_2D, renderTargetBytes(desc), TextureSampler::CLAMP_TO_EDGE);
+
+    pool.push_back(PooledTarget{ .desc = desc, .texture = texture, .inUse = true, .lastUsedFrame = frameNumber });
+    frameStats.pooledBytes += renderTargetBytes(desc);
+    frameStats.peakPooledBytes = std::max(frameStats.peakPooledBytes, frameStats.pooledBytes);
+    return pool.size() - 1;
+}
+
+// Framebuffers only ever hold pooled textures, so releasing one throws them all away to be made again as needed.
+void FrameGraph::releaseUnused(const std::uint64_t frames) {
+    const auto unused = [this, frames](const PooledTarget& target) {
+        return target.lastUsedFrame + frames < frameNumber;
+    };
+    if(std::none_of(pool.begin(), pool.end(), unused)) {
+        return;
+    }
+
+    for(const auto& [attachments, framebuffer] : framebuffers) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+    framebuffers.clear();
+    for(const auto& target : pool) {
+        if(unused(target)) {
+            releaseTexture(target.texture);
+            frameStats.pooledBytes -= renderTargetBytes(target.desc);
+        }
+    }
+    pool.erase(std::remove_if(pool.begin(), pool.end(), unused), pool.end());
+}
+
+unsigned int FrameGraph::framebufferFor(const Pass& pass) {
+    std::vector<unsigned int> attachments;
+    for(const FrameResource resource : pass.colourWrites) {
+        attachments.push_back(textureOf(resource));
+    }
+    attachments.push_back(pass.writesDepth ? textureOf(pass.depthWrite) : 0);
+
+    const auto cached = framebuffers.find(attachments);
+    if(cached != framebuffers.end()) {
+        return cached->second;
+    }
+
+    unsigned int framebuffer{ 0 };
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    // Colour targets nobody reads stay unattached, and what the shader writes to them is dropped.
+    std::vector<GLenum> drawBuffers;
+    for(std::size_t i = 0; i < pass.colourWrites.size(); ++i) {
+        const GLenum attachment{ static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + i) };
+        if(attachments[i] != 0) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, attachments[i], 0);
+        }
+        drawBuffers.push_back(attachments[i] != 0 ? attachment : GL_NONE);
+    }
+    if(pass.writesDepth) {
+        const GLenum attachment = hasStencil(resources[pass.depthWrite].desc.internalFormat)
+                                  ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, attachments.back(), 0);
+    }
+    if(drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+    } else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "::FrameGraph:: framebuffer for pass " << pass.name << " is not complete\n";
+    }
+
+    framebuffers.emplace(std::move(attachments), framebuffer);
+    return framebuffer;
+}
@@ -0,0 +1,136 @@
+#include <FrameTimer.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+static std::int64_t steadyNanoseconds(const std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+FrameTimer::FrameTimer(const std::size_t framesInFlight, const bool keepAllFrames)
+    :slots(std::max<std::size_t>(1, framesInFlight)), keepAll(keepAllFrames)
+{
+    for(auto& slot : slots) {
+        glGenQueries(1, &slot.elapsedQuery);
+        glGenQueries(1, &slot.presentQuery);
+    }
+
+    // Nothing is queued yet, so the GL's idea of now is the GPU's.
+    glFinish();
+    GLint64 gpuNow{ 0 };
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    gpuClockOffset = gpuNow - steadyNanoseconds(std::chrono::steady_clock::now());
+}
+
+FrameTimer::~FrameTimer() {
+    for(const auto& slot : slots) {
+        glDeleteQueries(1, &slot.elapsedQuery);
+        glDeleteQueries(1, &slot.presentQuery);
+    }
+}
+
+void FrameTimer::beginFrame(const std::chrono::steady_clock::time_point inputSampled) {
+    collect(slots[nextSlot]);
+    glBeginQuery(GL_TIME_ELAPSED, slots[nextSlot].elapsedQuery);
+    frameStart = std::chrono::steady_clock::now();
+    frameInput = inputSampled;
+}
+
+void FrameTimer::endFrame() {
+    glEndQuery(GL_TIME_ELAPSED);
+    const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - frameStart };
+    frames.push_back(FrameTiming{ .cpuMs = elapsed.count(), .gpuMs = -1.0, .latencyMs = -1.0 });
+    ++frameTotals.frames;
+    frameTotals.cpuMs += elapsed.count();
+
+    Slot& slot = slots[nextSlot];
+    slot.frame = frameCount() - 1;
+    slot.presented = false;
+    slot.inputSampled = frameInput;
+    nextSlot = (nextSlot + 1) % slots.size();
+
+    // Frames still in flight have to stay until their queries are read back.
+    while(!keepAll && frames.size() > std::max(RecentFrames, slots.size())) {
+        frames.pop_front();
+        ++firstFrame;
+    }
+}
+
+void FrameTimer::presented() {
+    Slot& slot = slots[(nextSlot + slots.size() - 1) % slots.size()];
+    if(slot.frame != NoFrame) {
+        glQueryCounter(slot.presentQuery, GL_TIMESTAMP);
+        slot.presented = true;
+    }
+}
+
+void FrameTimer::finish() {
+    for(auto& slot : slots) {
+        collect(slot);
+    }
+}
+
+std::size_t FrameTimer::frameCount() const {
+    return firstFrame + frames.size();
+}
+
+std::size_t FrameTimer::firstKeptFrame() const {
+    return firstFrame;
+}
+
+const FrameTiming& FrameTimer::timing(const std::size_t frame) const {
+    return frames[frame - firstFrame];
+}
+
+const FrameTimingTotals& FrameTimer::totals() const {
+    return frameTotals;
+}
+
+void FrameTimer::collect(Slot& slot) {
+    if(slot.frame == NoFrame) {
+        return;
+    }
+    FrameTiming& timing = frames[slot.frame - firstFrame];
+
+    GLuint64 nanoseconds{ 0 };
+    glGetQueryObjectui64v(slot.elapsedQuery, GL_QUERY_RESULT, &nanoseconds);
+    timing.gpuMs = static_cast<double>(nanoseconds) / 1e6;
+    ++frameTotals.gpuFrames;
+    frameTotals.gpuMs += timing.gpuMs;
+
+    if(slot.presented) {
+        GLuint64 presentedAt{ 0 };
+        glGetQueryObjectui64v(slot.presentQuery, GL_QUERY_RESULT, &presentedAt);
+        const std::int64_t sinceInput{ static_cast<std::int64_t>(presentedAt) - gpuClockOffset -
+                                       steadyNanoseconds(slot.inputSampled) };
+        timing.latencyMs = static_cast<double>(sinceInput) / 1e6;
+        ++frameTotals.latencyFrames;
+        frameTotals.latencyMs += timing.latencyMs;
+        frameTotals.worstLatencyMs = std::max(frameTotals.worstLatencyMs, timing.latencyMs);
+    }
+    slot.frame = NoFrame;
+}
+
+bool writeFrameTimings(const std::string& path, const FrameTimer& timer) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if(!file) {
+        std::cerr << "::writeFrameTimings:: could not create " << path << '\n';
+        return false;
+    }
+
+    std::fprintf(file, "frame,cpu_ms,gpu_ms,latency_ms\n");
+    for(std::size_t frame = timer.firstKeptFrame(); frame < timer.frameCount(); ++frame) {
+        const FrameTiming& timing = timer.timing(frame);
+        std::fprintf(file, "%zu,%.4f,%.4f,%.4f\n", frame, timing.cpuMs, timing.gpuMs, timing.latencyMs);
+    }
+
+    const bool written{ std::ferror(file) == 0 };
+    std::fclose(file);
+    if(!written) {
+        std::cerr << "::writeFrameTimings:: could not write " << path << '\n';
+    }
+    return written;
+}
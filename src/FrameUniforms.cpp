@@ -0,0 +1,61 @@
+#include <FrameUniforms.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+static_assert(sizeof(CameraUniforms) == 144, "CameraUniforms is copied as it is into a std140 block");
+
+FrameUniforms::FrameUniforms(const std::size_t framesInFlight)
+    :fences(std::max<std::size_t>(1, framesInFlight), nullptr)
+{
+    // Regions have to start on the offset alignment for glBindBufferRange.
+    GLint alignment{ 256 };
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const auto align = static_cast<std::size_t>(std::max(1, alignment));
+    regionBytes = (sizeof(CameraUniforms) + align - 1) / align * align;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(regionBytes * fences.size()), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+FrameUniforms::~FrameUniforms() {
+    for(const GLsync fence : fences) {
+        if(fence) {
+            glDeleteSync(fence);
+        }
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void FrameUniforms::beginFrame() {
+    GLsync& fence = fences[nextRegion];
+    if(fence) {
+        static_cast<void>(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, std::numeric_limits<GLuint64>::max()));
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void FrameUniforms::write(const CameraUniforms& camera) {
+    const auto offset = static_cast<GLintptr>(nextRegion * regionBytes);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    // beginFrame already waited for the GPU to finish with the region, the driver needn't.
+    void* region = glMapBufferRange(GL_UNIFORM_BUFFER, offset, sizeof(CameraUniforms),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if(region) {
+        std::memcpy(region, &camera, sizeof(camera));
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    } else {
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(camera), &camera);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferRange(GL_UNIFORM_BUFFER, CameraUniformBinding, buffer, offset, sizeof(CameraUniforms));
+}
+
+void FrameUniforms::endFrame() {
+    fences[nextRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    nextRegion = (nextRegion + 1) % fences.size();
+}
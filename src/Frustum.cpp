@@ -0,0 +1,227 @@
+#include <Frustum.hpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#include <cmath>
+
+// The kernels take eight per iteration whatever the vector width, one AVX register or two SSE ones.
+static constexpr std::size_t BoundsPerIteration{ 8 };
+
+Frustum extractFrustum(const glm::mat4& viewProjection) {
+    // glm is column major, so row i is the i-th component of every column.
+    const auto row = [&viewProjection](const int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    Frustum frustum;
+    frustum.planes[Frustum::LEFT] = row(3) + row(0);
+    frustum.planes[Frustum::RIGHT] = row(3) - row(0);
+    frustum.planes[Frustum::BOTTOM] = row(3) + row(1);
+    frustum.planes[Frustum::TOP] = row(3) - row(1);
+    frustum.planes[Frustum::NEAR] = row(3) + row(2);
+    frustum.planes[Frustum::FAR] = row(3) - row(2);
+    for(auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+// The sums are spelt out in the same order as the vector code does them, so both round the same way. Negated
+// comparisons keep boxes with NaNs culled, like the ordered comparisons of the vector code do.
+static bool boxInside(const Frustum& frustum, const float cx, const float cy, const float cz, const float ex,
+                      const float ey, const float ez) {
+    for(const auto& plane : frustum.planes) {
+        const float distance{ cx * plane.x + cy * plane.y + cz * plane.z + plane.w };
+        const float reach{ ex * std::abs(plane.x) + ey * std::abs(plane.y) + ez * std::abs(plane.z) };
+        if(!(distance + reach >= 0.f)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sphereInside(const Frustum& frustum, const float cx, const float cy, const float cz, const float radius) {
+    for(const auto& plane : frustum.planes) {
+        const float distance{ cx * plane.x + cy * plane.y + cz * plane.z + plane.w };
+        if(!(distance + radius >= 0.f)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool intersects(const Frustum& frustum, const AABB& box) {
+    const glm::vec3 centre = box.centre();
+    const glm::vec3 extents = box.extents();
+    return boxInside(frustum, centre.x, centre.y, centre.z, extents.x, extents.y, extents.z);
+}
+
+bool intersects(const Frustum& frustum, const BoundingSphere& sphere) {
+    return sphereInside(frustum, sphere.centre.x, sphere.centre.y, sphere.centre.z, sphere.radius);
+}
+
+void AABBArray::push(const AABB& box) {
+    const glm::vec3 centre = box.centre();
+    const glm::vec3 extents = box.extents();
+    centreX.push_back(centre.x);
+    centreY.push_back(centre.y);
+    centreZ.push_back(centre.z);
+    extentX.push_back(extents.x);
+    extentY.push_back(extents.y);
+    extentZ.push_back(extents.z);
+}
+
+void AABBArray::clear() {
+    centreX.clear();
+    centreY.clear();
+    centreZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+void SphereArray::push(const BoundingSphere& sphere) {
+    centreX.push_back(sphere.centre.x);
+    centreY.push_back(sphere.centre.y);
+    centreZ.push_back(sphere.centre.z);
+    radius.push_back(sphere.radius);
+}
+
+void SphereArray::clear() {
+    centreX.clear();
+    centreY.clear();
+    centreZ.clear();
+    radius.clear();
+}
+
+#if defined(__AVX__) || defined(__SSE__)
+#ifdef __AVX__
+using Lanes = __m256;
+static constexpr std::size_t LaneCount{ 8 };
+
+static Lanes loadLanes(const float* values) { return _mm256_loadu_ps(values); }
+static Lanes broadcast(const float value) { return _mm256_set1_ps(value); }
+static Lanes add(const Lanes a, const Lanes b) { return _mm256_add_ps(a, b); }
+static Lanes multiply(const Lanes a, const Lanes b) { return _mm256_mul_ps(a, b); }
+static Lanes both(const Lanes a, const Lanes b) { return _mm256_and_ps(a, b); }
+static Lanes notNegative(const Lanes a) { return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GE_OQ); }
+static unsigned int laneMask(const Lanes a) { return static_cast<unsigned int>(_mm256_movemask_ps(a)); }
+#else
+using Lanes = __m128;
+static constexpr std::size_t LaneCount{ 4 };
+
+static Lanes loadLanes(const float* values) { return _mm_loadu_ps(values); }
+static Lanes broadcast(const float value) { return _mm_set1_ps(value); }
+static Lanes add(const Lanes a, const Lanes b) { return _mm_add_ps(a, b); }
+static Lanes multiply(const Lanes a, const Lanes b) { return _mm_mul_ps(a, b); }
+static Lanes both(const Lanes a, const Lanes b) { return _mm_and_ps(a, b); }
+static Lanes notNegative(const Lanes a) { return _mm_cmpge_ps(a, _mm_setzero_ps()); }
+static unsigned int laneMask(const Lanes a) { return static_cast<unsigned int>(_mm_movemask_ps(a)); }
+#endif
+
+// One plane broadcast to every lane, along with the absolute values of its normal for the box extents.
+struct LanePlane {
+    Lanes x, y, z, w;
+    Lanes absX, absY, absZ;
+};
+
+static std::array<LanePlane, 6> broadcastPlanes(const Frustum& frustum) {
+    std::array<LanePlane, 6> planes;
+    for(std::size_t i = 0; i < planes.size(); ++i) {
+        const glm::vec4& plane = frustum.planes[i];
+        planes[i] = LanePlane{
+            .x = broadcast(plane.x), .y = broadcast(plane.y), .z = broadcast(plane.z), .w = broadcast(plane.w),
+            .absX = broadcast(std::abs(plane.x)), .absY = broadcast(std::abs(plane.y)),
+            .absZ = broadcast(std::abs(plane.z)),
+        };
+    }
+    return planes;
+}
+
+static Lanes distanceTo(const LanePlane& plane, const Lanes cx, const Lanes cy, const Lanes cz) {
+    return add(add(add(multiply(cx, plane.x), multiply(cy, plane.y)), multiply(cz, plane.z)), plane.w);
+}
+
+// Writes every lane's index and only advances past the visible ones, so the next write lands on top of the culled.
+static std::size_t appendVisible(const unsigned int mask, const std::size_t first, std::size_t count,
+                                 std::uint32_t* visible) {
+    for(std::size_t lane = 0; lane < LaneCount; ++lane) {
+        visible[count] = static_cast<std::uint32_t>(first + lane);
+        count += (mask >> lane) & 1u;
+    }
+    return count;
+}
+#endif
+
+std::size_t cullAABBs(const Frustum& frustum, const AABBArray& boxes, std::uint32_t* visible) {
+    const std::size_t count{ boxes.size() };
+    std::size_t visibleCount{ 0 };
+    std::size_t i{ 0 };
+
+#if defined(__AVX__) || defined(__SSE__)
+    const std::array<LanePlane, 6> planes{ broadcastPlanes(frustum) };
+    for(; i + BoundsPerIteration <= count; i += BoundsPerIteration) {
+        for(std::size_t first = i; first < i + BoundsPerIteration; first += LaneCount) {
+            const Lanes cx{ loadLanes(boxes.centreX.data() + first) };
+            const Lanes cy{ loadLanes(boxes.centreY.data() + first) };
+            const Lanes cz{ loadLanes(boxes.centreZ.data() + first) };
+            const Lanes ex{ loadLanes(boxes.extentX.data() + first) };
+            const Lanes ey{ loadLanes(boxes.extentY.data() + first) };
+            const Lanes ez{ loadLanes(boxes.extentZ.data() + first) };
+
+            Lanes inside{};
+            for(std::size_t p = 0; p < planes.size(); ++p) {
+                const LanePlane& plane = planes[p];
+                const Lanes reach{ add(add(multiply(ex, plane.absX), multiply(ey, plane.absY)),
+                                       multiply(ez, plane.absZ)) };
+                const Lanes inFront{ notNegative(add(distanceTo(plane, cx, cy, cz), reach)) };
+                inside = p == 0 ? inFront : both(inside, inFront);
+            }
+            visibleCount = appendVisible(laneMask(inside), first, visibleCount, visible);
+        }
+    }
+#endif
+
+    for(; i < count; ++i) {
+        visible[visibleCount] = static_cast<std::uint32_t>(i);
+        visibleCount += boxInside(frustum, boxes.centreX[i], boxes.centreY[i], boxes.centreZ[i], boxes.extentX[i],
+                                  boxes.extentY[i], boxes.extentZ[i]) ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+std::size_t cullSpheres(const Frustum& frustum, const SphereArray& spheres, std::uint32_t* visible) {
+    const std::size_t count{ spheres.size() };
+    std::size_t visibleCount{ 0 };
+    std::size_t i{ 0 };
+
+#if defined(__AVX__) || defined(__SSE__)
+    const std::array<LanePlane, 6> planes{ broadcastPlanes(frustum) };
+    for(; i + BoundsPerIteration <= count; i += BoundsPerIteration) {
+        for(std::size_t first = i; first < i + BoundsPerIteration; first += LaneCount) {
+            const Lanes cx{ loadLanes(spheres.centreX.data() + first) };
+            const Lanes cy{ loadLanes(spheres.centreY.data() + first) };
+            const Lanes cz{ loadLanes(spheres.centreZ.data() + first) };
+            const Lanes radius{ loadLanes(spheres.radius.data() + first) };
+
+            Lanes inside{};
+            for(std::size_t p = 0; p < planes.size(); ++p) {
+                const Lanes inFront{ notNegative(add(distanceTo(planes[p], cx, cy, cz), radius)) };
+                inside = p == 0 ? inFront : both(inside, inFront);
+            }
+            visibleCount = appendVisible(laneMask(inside), first, visibleCount, visible);
+        }
+    }
+#endif
+
+    for(; i < count; ++i) {
+        visible[visibleCount] = static_cast<std::uint32_t>(i);
+        visibleCount += sphereInside(frustum, spheres.centreX[i], spheres.centreY[i], spheres.centreZ[i],
+                                     spheres.radius[i]) ? 1 : 0;
+    }
+    return visibleCount;
+}
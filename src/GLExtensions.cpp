@@ -0,0 +1,42 @@
+#include <GLExtensions.hpp>
+
+#include <unordered_set>
+
+bool hasGLExtension(const std::string& name) {
+    static const std::unordered_set<std::string> extensions = []() {
+        std::unordered_set<std::string> names;
+        GLint count{ 0 };
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for(GLint i = 0; i < count; ++i) {
+            names.emplace(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i))));
+        }
+        return names;
+    }();
+
+    return extensions.contains(name);
+}
+
+TexStorage2DProc texStorage2D{ nullptr };
+TexStorage3DProc texStorage3D{ nullptr };
+BufferStorageProc bufferStorage{ nullptr };
+DispatchComputeProc dispatchCompute{ nullptr };
+BindImageTextureProc bindImageTexture{ nullptr };
+MemoryBarrierProc memoryBarrier{ nullptr };
+
+void loadGLExtensions(const GLADloadproc load) {
+    const bool core42{ GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 2) };
+    if(core42 || hasGLExtension("GL_ARB_texture_storage")) {
+        texStorage2D = reinterpret_cast<TexStorage2DProc>(load("glTexStorage2D"));
+        texStorage3D = reinterpret_cast<TexStorage3DProc>(load("glTexStorage3D"));
+    }
+    const bool core44{ GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 4) };
+    if(core44 || hasGLExtension("GL_ARB_buffer_storage")) {
+        bufferStorage = reinterpret_cast<BufferStorageProc>(load("glBufferStorage"));
+    }
+    const bool core43{ GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3) };
+    if(core43) {
+        dispatchCompute = reinterpret_cast<DispatchComputeProc>(load("glDispatchCompute"));
+        bindImageTexture = reinterpret_cast<BindImageTextureProc>(load("glBindImageTexture"));
+        memoryBarrier = reinterpret_cast<MemoryBarrierProc>(load("glMemoryBarrier"));
+    }
+}
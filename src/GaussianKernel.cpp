@@ -0,0 +1,55 @@
+#include <GaussianKernel.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+GaussianKernel gaussianKernel(const float sigma, const int radius) {
+    GaussianKernel kernel;
+    float total{ 0.f };
+    for(int i = 0; i <= radius; ++i) {
+        const float offset{ static_cast<float>(i) };
+        const float weight{ std::exp(-offset * offset / (2.f * sigma * sigma)) };
+        kernel.offsets.push_back(offset);
+        kernel.weights.push_back(weight);
+        total += i == 0 ? weight : 2.f * weight;
+    }
+    for(auto& weight : kernel.weights) {
+        weight /= total;
+    }
+    return kernel;
+}
+
+GaussianKernel linearSampledKernel(const GaussianKernel& kernel) {
+    GaussianKernel merged;
+    merged.offsets.push_back(kernel.offsets.front());
+    merged.weights.push_back(kernel.weights.front());
+    for(std::size_t i = 1; i < kernel.weights.size(); i += 2) {
+        // An odd tap out gets a fetch to itself.
+        if(i + 1 == kernel.weights.size()) {
+            merged.offsets.push_back(kernel.offsets[i]);
+            merged.weights.push_back(kernel.weights[i]);
+            break;
+        }
+        const float near{ kernel.weights[i] }, far{ kernel.weights[i + 1] };
+        merged.offsets.push_back((kernel.offsets[i] * near + kernel.offsets[i + 1] * far) / (near + far));
+        merged.weights.push_back(near + far);
+    }
+    return merged;
+}
+
+static std::string floatList(const std::vector<float>& values) {
+    std::string list;
+    for(const float value : values) {
+        std::array<char, 32> text{};
+        std::snprintf(text.data(), text.size(), "%.9f", static_cast<double>(value));
+        list += (list.empty() ? "" : ", ") + std::string(text.data());
+    }
+    return list;
+}
+
+std::string kernelDefines(const GaussianKernel& kernel) {
+    return "#define BLUR_TAPS " + std::to_string(kernel.weights.size()) + "\n" +
+           "#define BLUR_OFFSETS " + floatList(kernel.offsets) + "\n" +
+           "#define BLUR_WEIGHTS " + floatList(kernel.weights) + "\n";
+}
@@ -0,0 +1,133 @@
+#include <ImportProfiler.hpp>
+
+static thread_local ImportProfile* activeProfile{ nullptr };
+static thread_local std::size_t allocatedBytes{ 0 };
+
+ImportStageStats& ImportProfile::stage(const std::string& name) {
+    for(auto& s : stages) {
+        if(s.name == name) {
+            return s;
+        }
+    }
+
+    stages.push_back(ImportStageStats{ .name = name });
+    return stages.back();
+}
+
+void beginImportProfile(ImportProfile* profile) {
+    activeProfile = profile;
+}
+
+void endImportProfile() {
+    activeProfile = nullptr;
+}
+
+ImportProfile* activeImportProfile() {
+    return activeProfile;
+}
+
+void countThreadAllocation(const std::size_t bytes) {
+    allocatedBytes += bytes;
+}
+
+std::size_t threadAllocatedBytes() {
+    return allocatedBytes;
+}
+
+ScopedImportStage::ScopedImportStage(const char* name) {
+    if(!activeProfile) {
+        return;
+    }
+
+    stats = &activeProfile->stage(name);
+    startBytes = allocatedBytes;
+    start = std::chrono::steady_clock::now();
+}
+
+ScopedImportStage::~ScopedImportStage() {
+    if(!stats) {
+        return;
+    }
+
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    stats->seconds += elapsed.count();
+    stats->allocatedBytes += allocatedBytes - startBytes + extraBytes;
+    ++stats->calls;
+}
+
+void ScopedImportStage::addBytes(const std::size_t bytes) {
+    extraBytes += bytes;
+}
+
+namespace {
+
+class TimedIOStream : public Assimp::IOStream {
+public:
+    TimedIOStream(Assimp::IOStream* aStream, ImportStageStats& aStats)
+        :stream(aStream), stats(aStats)
+    {}
+
+    size_t Read(void* buffer, size_t size, size_t count) override {
+        const auto start = std::chrono::steady_clock::now();
+        const auto startBytes = allocatedBytes;
+
+        const size_t result = stream->Read(buffer, size, count);
+
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        stats.seconds += elapsed.count();
+        stats.allocatedBytes += allocatedBytes - startBytes;
+
+        return result;
+    }
+
+    size_t Write(const void* buffer, size_t size, size_t count) override {
+        return stream->Write(buffer, size, count);
+    }
+
+    aiReturn Seek(size_t offset, aiOrigin origin) override {
+        return stream->Seek(offset, origin);
+    }
+
+    size_t Tell() const override {
+        return stream->Tell();
+    }
+
+    size_t FileSize() const override {
+        return stream->FileSize();
+    }
+
+    void Flush() override {
+        stream->Flush();
+    }
+
+    Assimp::IOStream* stream;
+
+private:
+    ImportStageStats& stats;
+};
+
+}
+
+TimedIOSystem::TimedIOSystem(ImportStageStats& aStats)
+    :stats(aStats)
+{}
+
+Assimp::IOStream* TimedIOSystem::Open(const char* file, const char* mode) {
+    const auto start = std::chrono::steady_clock::now();
+    Assimp::IOStream* stream = PackIOSystem::Open(file, mode);
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    stats.seconds += elapsed.count();
+
+    if(!stream) {
+        return nullptr;
+    }
+
+    ++stats.calls;
+    return new TimedIOStream(stream, stats);
+}
+
+void TimedIOSystem::Close(Assimp::IOStream* file) {
+    auto* timed = static_cast<TimedIOStream*>(file);
+    PackIOSystem::Close(timed->stream);
+    delete timed;
+}
@@ -0,0 +1,260 @@
+#include <KtxFile.hpp>
+#include <AssetPack.hpp>
+#include <GLExtensions.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+static constexpr std::array<unsigned char, 12> KtxIdentifier{
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+static constexpr std::uint32_t KtxEndianness{ 0x04030201 };
+static constexpr const char* EncoderKey{ "encoder" };
+
+struct KtxHeader {
+    std::array<unsigned char, 12> identifier;
+    std::uint32_t endianness;
+    std::uint32_t glType;
+    std::uint32_t glTypeSize;
+    std::uint32_t glFormat;
+    std::uint32_t glInternalFormat;
+    std::uint32_t glBaseInternalFormat;
+    std::uint32_t pixelWidth;
+    std::uint32_t pixelHeight;
+    std::uint32_t pixelDepth;
+    std::uint32_t numberOfArrayElements;
+    std::uint32_t numberOfFaces;
+    std::uint32_t numberOfMipmapLevels;
+    std::uint32_t bytesOfKeyValueData;
+};
+
+static_assert(sizeof(KtxHeader) == 64, "KtxHeader is read and written as it is");
+
+static std::uint32_t padToFour(const std::size_t size) {
+    return static_cast<std::uint32_t>((4 - size % 4) % 4);
+}
+
+// What one face of a width x height level takes, 0 for formats we never write. Uncompressed rows are padded to 4 bytes.
+static std::size_t faceBytes(const KtxHeader& header, const int width, const int height) {
+    const auto w = static_cast<std::size_t>(width);
+    const auto h = static_cast<std::size_t>(height);
+    if(header.glType == 0) {
+        std::size_t blockBytes{ 0 };
+        switch(header.glInternalFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+            blockBytes = 8;
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+            blockBytes = 16;
+            break;
+        default:
+            return 0;
+        }
+        return (w + 3) / 4 * ((h + 3) / 4) * blockBytes;
+    }
+    if(header.glType != GL_UNSIGNED_BYTE) {
+        return 0;
+    }
+
+    std::size_t components{ 0 };
+    switch(header.glFormat) {
+    case GL_RED:
+        components = 1;
+        break;
+    case GL_RG:
+        components = 2;
+        break;
+    case GL_RGB:
+        components = 3;
+        break;
+    case GL_RGBA:
+        components = 4;
+        break;
+    default:
+        return 0;
+    }
+    const std::size_t rowBytes{ w * components };
+    return (rowBytes + padToFour(rowBytes)) * h;
+}
+
+// Written next to path and renamed over it, so an interrupted write never leaves a broken file behind for the next run.
+bool writeKtx(const std::string& path, const KtxTexture& texture) {
+    const std::string temporaryPath{ path + ".tmp" };
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()) {
+        std::cerr << "::writeKtx:: could not create " << temporaryPath << '\n';
+        return false;
+    }
+
+    // One key/value pair: its size, then "key\0value\0", then padding.
+    const std::size_t keyValueSize{ std::strlen(EncoderKey) + 1 + texture.encoder.size() + 1 };
+    const std::uint32_t keyValuePadding{ padToFour(keyValueSize) };
+
+    KtxHeader header{};
+    header.identifier = KtxIdentifier;
+    header.endianness = KtxEndianness;
+    header.glType = texture.glType;
+    header.glTypeSize = 1;
+    header.glFormat = texture.glFormat;
+    header.glInternalFormat = texture.internalFormat;
+    header.glBaseInternalFormat = texture.baseInternalFormat;
+    header.pixelWidth = static_cast<std::uint32_t>(texture.width);
+    header.pixelHeight = static_cast<std::uint32_t>(texture.height);
+    header.numberOfFaces = static_cast<std::uint32_t>(texture.faces);
+    header.numberOfMipmapLevels = static_cast<std::uint32_t>(texture.levels.size());
+    header.bytesOfKeyValueData = static_cast<std::uint32_t>(sizeof(std::uint32_t) + keyValueSize + keyValuePadding);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    static constexpr char zeros[4]{};
+    const auto keyValueBytes = static_cast<std::uint32_t>(keyValueSize);
+    file.write(reinterpret_cast<const char*>(&keyValueBytes), sizeof(keyValueBytes));
+    file.write(EncoderKey, static_cast<std::streamsize>(std::strlen(EncoderKey) + 1));
+    file.write(texture.encoder.c_str(), static_cast<std::streamsize>(texture.encoder.size() + 1));
+    file.write(zeros, keyValuePadding);
+
+    // imageSize is the size of one face, each face is padded on its own.
+    const auto faces = static_cast<std::size_t>(texture.faces);
+    for(const auto& level : texture.levels) {
+        const std::size_t faceSize{ level.size() / faces };
+        const auto imageSize = static_cast<std::uint32_t>(faceSize);
+        file.write(reinterpret_cast<const char*>(&imageSize), sizeof(imageSize));
+        for(std::size_t face = 0; face < faces; ++face) {
+            file.write(reinterpret_cast<const char*>(level.data() + face * faceSize),
+                       static_cast<std::streamsize>(faceSize));
+            file.write(zeros, padToFour(faceSize));
+        }
+    }
+
+    file.close();
+    std::error_code error;
+    if(!file) {
+        std::cerr << "::writeKtx:: could not write " << temporaryPath << '\n';
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if(error) {
+        std::cerr << "::writeKtx:: could not replace " << path << ": " << error.message() << '\n';
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool readKtx(const std::string& path, KtxTexture& texture, const int maxDimension) {
+    const AssetFile file(path);
+    if(!file.isOpen()) {
+        return false;
+    }
+
+    const char* p = file.begin();
+    const char* end = file.end();
+    auto truncated = [&]() {
+        std::cerr << "::readKtx:: truncated file " << path << '\n';
+        return false;
+    };
+
+    KtxHeader header{};
+    if(file.size() < sizeof(header)) {
+        return truncated();
+    }
+    std::memcpy(&header, p, sizeof(header));
+    p += sizeof(header);
+
+    if(header.identifier != KtxIdentifier || header.endianness != KtxEndianness) {
+        std::cerr << "::readKtx:: not a little endian KTX 1.1 file " << path << '\n';
+        return false;
+    }
+    if((header.numberOfFaces != 1 && header.numberOfFaces != 6) || header.pixelDepth != 0 ||
+       header.numberOfArrayElements != 0) {
+        std::cerr << "::readKtx:: only 2D textures and cube maps are supported " << path << '\n';
+        return false;
+    }
+    // Every level is checked against the size the header says it has, so the levels handed out can be uploaded as
+    // they are.
+    const std::uint32_t maxSide{ std::max(header.pixelWidth, header.pixelHeight) };
+    if(header.pixelWidth == 0 || header.pixelHeight == 0 || maxSide > std::numeric_limits<int>::max() ||
+       header.numberOfMipmapLevels == 0 ||
+       header.numberOfMipmapLevels > static_cast<std::uint32_t>(std::bit_width(maxSide)) ||
+       faceBytes(header, 1, 1) == 0) {
+        std::cerr << "::readKtx:: unsupported size, level count or format " << path << '\n';
+        return false;
+    }
+    if(static_cast<std::size_t>(end - p) < header.bytesOfKeyValueData) {
+        return truncated();
+    }
+
+    texture.glType = header.glType;
+    texture.glFormat = header.glFormat;
+    texture.internalFormat = header.glInternalFormat;
+    texture.baseInternalFormat = header.glBaseInternalFormat;
+    texture.width = static_cast<int>(header.pixelWidth);
+    texture.height = static_cast<int>(header.pixelHeight);
+    texture.faces = static_cast<int>(header.numberOfFaces);
+    texture.encoder.clear();
+
+    const char* keyValueEnd = p + header.bytesOfKeyValueData;
+    while(keyValueEnd - p >= 4) {
+        std::uint32_t size{ 0 };
+        std::memcpy(&size, p, sizeof(size));
+        p += sizeof(size);
+        if(static_cast<std::size_t>(keyValueEnd - p) < size) {
+            return truncated();
+        }
+
+        const std::string_view pair(p, size);
+        const auto separator = pair.find('\0');
+        if(separator != std::string_view::npos && pair.substr(0, separator) == EncoderKey) {
+            const auto value = pair.substr(separator + 1);
+            texture.encoder = value.substr(0, value.find('\0'));
+        }
+        p += size + padToFour(size);
+    }
+    p = keyValueEnd;
+
+    texture.levels.clear();
+    texture.levels.reserve(header.numberOfMipmapLevels);
+    for(std::uint32_t level = 0; level < header.numberOfMipmapLevels; ++level) {
+        std::uint32_t imageSize{ 0 };
+        if(end - p < 4) {
+            return truncated();
+        }
+        std::memcpy(&imageSize, p, sizeof(imageSize));
+        p += sizeof(imageSize);
+
+        const int width{ std::max(1, texture.width >> level) };
+        const int height{ std::max(1, texture.height >> level) };
+        const bool skipped{ maxDimension > 0 && std::max(width, height) > maxDimension };
+        if(imageSize != faceBytes(header, width, height)) {
+            std::cerr << "::readKtx:: level " << level << " has " << imageSize << " bytes per face instead of "
+                      << faceBytes(header, width, height) << ' ' << path << '\n';
+            return false;
+        }
+        auto& data = texture.levels.emplace_back();
+        for(std::uint32_t face = 0; face < header.numberOfFaces; ++face) {
+            if(static_cast<std::size_t>(end - p) < imageSize) {
+                return truncated();
+            }
+            if(!skipped) {
+                data.insert(data.end(), p, p + imageSize);
+            }
+            p += imageSize;
+            p += std::min<std::size_t>(padToFour(imageSize), static_cast<std::size_t>(end - p));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,47 @@
+#include <MappedFile.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iostream>
+
+MappedFile::MappedFile(const std::string& path, const bool sequential) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        std::cerr << "Could not open file to map. Path: " << path << '\n';
+        return;
+    }
+
+    struct stat status{};
+    if(fstat(fd, &status) != 0) {
+        std::cerr << "Could not stat file to map. Path: " << path << '\n';
+        close(fd);
+        return;
+    }
+
+    opened = true;
+    bytes = static_cast<std::size_t>(status.st_size);
+
+    // mmap refuses zero length mappings, an empty file is simply an empty range.
+    if(bytes > 0) {
+        void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED) {
+            std::cerr << "Could not map file. Path: " << path << '\n';
+            opened = false;
+            bytes = 0;
+        } else {
+            madvise(mapping, bytes, sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+            data = static_cast<const char*>(mapping);
+        }
+    }
+
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if(data) {
+        munmap(const_cast<char*>(data), bytes);
+    }
+}
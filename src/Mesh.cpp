@@ -1,23 +1,59 @@
 #include <Mesh.hpp>
+#include <ImportProfiler.hpp>
+#include <TextureManager.hpp>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include <iostream>
 
-Mesh::Mesh(const std::vector<Vertex>& aVertices, const std::vector<Texture>& aTextures,
-           const std::vector<unsigned int>& aIndices)
-    :vertices(aVertices), textures(aTextures), indices(aIndices)
+Mesh::Mesh(std::vector<Vertex> aVertices, std::vector<Texture> aTextures, std::vector<unsigned int> aIndices)
+    :vertices(std::move(aVertices)), textures(std::move(aTextures)), indices(std::move(aIndices))
 {
+    {
+        ScopedImportStage stage("bounds");
+        bounds = computeBounds(vertices);
+    }
+
     setupMesh();
 }
 
 void Mesh::draw(Shader& shader) const {
+    bindTextures(shader);
+
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, static_cast<int>(indices.size()), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
+void Mesh::drawInstanced(Shader& shader, const unsigned int count) const {
+    bindTextures(shader);
+
+    glBindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<int>(indices.size()), GL_UNSIGNED_INT, 0, static_cast<int>(count));
+    glBindVertexArray(0);
+}
+
+void Mesh::setInstanceBuffer(const unsigned int buffer) {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+    // A mat4 attribute takes four consecutive locations, one column each, advancing once per instance.
+    for(unsigned int column = 0; column < 4; ++column) {
+        const unsigned int location{ 3 + column };
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
+
+    glBindVertexArray(0);
+}
+
+void Mesh::bindTextures(Shader& shader) const {
     unsigned int diffuseNumber{ 0 };
     unsigned int specularNumber{ 0 };
 
     for(unsigned int i = 0; i < textures.size(); ++i) {
-        glActiveTexture(GL_TEXTURE0 + i);
         std::string texTypeStr;
 
         switch(textures[i].textureType) {
@@ -31,13 +67,17 @@ void Mesh::draw(Shader& shader) const {
             break;
         }
 
+        // The model keeps its arrays bound, from one mesh to the next only the layer changes.
+        if(textures[i].packed) {
+            shader.setUniformInt(texTypeStr, static_cast<int>(textures[i].unit));
+            shader.setUniformFloat(texTypeStr + "Layer", textures[i].layer);
+            shader.setVec4(texTypeStr + "Transform", textures[i].uvTransform);
+            continue;
+        }
+
         shader.setUniformInt(texTypeStr, i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        bindTexture(i, GL_TEXTURE_2D, textures[i].id);
     }
-
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<int>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
 }
 
 void Mesh::setupMesh() {
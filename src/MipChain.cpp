@@ -0,0 +1,373 @@
+#include <MipChain.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Enough steps that neighbouring 8 bit sRGB values never share an entry, even in the darks where sRGB is steepest.
+static constexpr int LinearSteps{ 16384 };
+
+struct SrgbTables {
+    std::array<float, 256> toLinear;
+    std::array<unsigned char, LinearSteps> fromLinear;
+};
+
+static const SrgbTables& srgbTables() {
+    static const SrgbTables tables = []() {
+        SrgbTables result{};
+        for(std::size_t i = 0; i < result.toLinear.size(); ++i) {
+            const float value{ static_cast<float>(i) / 255.f };
+            result.toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        for(std::size_t i = 0; i < result.fromLinear.size(); ++i) {
+            const float value{ static_cast<float>(i) / static_cast<float>(LinearSteps - 1) };
+            const float encoded{ value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f };
+            result.fromLinear[i] = static_cast<unsigned char>(std::lround(encoded * 255.f));
+        }
+        return result;
+    }();
+    return tables;
+}
+
+static const unsigned char* texelAt(const MipLevel& level, const int x, const int y) {
+    const int clampedX{ std::min(x, level.width - 1) };
+    const int clampedY{ std::min(y, level.height - 1) };
+    return level.rgba.data() + (static_cast<std::size_t>(clampedY) * static_cast<std::size_t>(level.width) +
+                                static_cast<std::size_t>(clampedX)) * 4;
+}
+
+static void averageLinear(const MipLevel& source, const int x, const int y, unsigned char* out) {
+    const unsigned char* a = texelAt(source, x * 2, y * 2);
+    const unsigned char* b = texelAt(source, x * 2 + 1, y * 2);
+    const unsigned char* c = texelAt(source, x * 2, y * 2 + 1);
+    const unsigned char* d = texelAt(source, x * 2 + 1, y * 2 + 1);
+    for(int channel = 0; channel < 4; ++channel) {
+        out[channel] = static_cast<unsigned char>((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+    }
+}
+
+static void averageSrgb(const MipLevel& source, const int x, const int y, unsigned char* out) {
+    const SrgbTables& tables = srgbTables();
+    const std::array<const unsigned char*, 4> texels{
+        texelAt(source, x * 2, y * 2),
+        texelAt(source, x * 2 + 1, y * 2),
+        texelAt(source, x * 2, y * 2 + 1),
+        texelAt(source, x * 2 + 1, y * 2 + 1),
+    };
+
+#ifdef __SSE2__
+    __m128 sum{ _mm_setzero_ps() };
+    for(const unsigned char* texel : texels) {
+        sum = _mm_add_ps(sum, _mm_set_ps(static_cast<float>(texel[3]) / 255.f, tables.toLinear[texel[2]],
+                                         tables.toLinear[texel[1]], tables.toLinear[texel[0]]));
+    }
+    const __m128 average{ _mm_mul_ps(sum, _mm_set1_ps(0.25f)) };
+    // Colour becomes a table index, alpha goes straight back to 8 bits. Adding a half before truncating rounds.
+    const __m128 scale{ _mm_set_ps(255.f, LinearSteps - 1, LinearSteps - 1, LinearSteps - 1) };
+    alignas(16) std::array<int, 4> indices;
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices.data()),
+                    _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(average, scale), _mm_set1_ps(0.5f))));
+    for(std::size_t channel = 0; channel < 3; ++channel) {
+        out[channel] = tables.fromLinear[static_cast<std::size_t>(indices[channel])];
+    }
+    out[3] = static_cast<unsigned char>(indices[3]);
+#else
+    std::array<float, 4> sum{};
+    for(const unsigned char* texel : texels) {
+        for(std::size_t channel = 0; channel < 3; ++channel) {
+            sum[channel] += tables.toLinear[texel[channel]];
+        }
+        sum[3] += static_cast<float>(texel[3]) / 255.f;
+    }
+    for(std::size_t channel = 0; channel < 3; ++channel) {
+        out[channel] = tables.fromLinear[static_cast<std::size_t>(sum[channel] * 0.25f * (LinearSteps - 1) + 0.5f)];
+    }
+    out[3] = static_cast<unsigned char>(sum[3] * 0.25f * 255.f + 0.5f);
+#endif
+}
+
+// The source texels under texel i of the level below, along one axis, and how much of each it covers. Halving an even
+// size covers two whole texels. An odd size 2n + 1 goes into n texels, each 2 + 1/n source texels wide, which takes in
+// three of them weighted (n - i), n and (i + 1) over 2n + 1. Two taps would drop the last row and column.
+struct BoxFootprint {
+    std::array<int, 3> texels;
+    std::array<float, 3> weights;
+    std::size_t count;
+};
+
+static BoxFootprint boxFootprint(const int i, const int sourceSize) {
+    if(sourceSize > 1 && sourceSize % 2 == 1) {
+        const int n{ sourceSize / 2 };
+        const float size{ static_cast<float>(sourceSize) };
+        return { { i * 2, i * 2 + 1, i * 2 + 2 },
+                 { static_cast<float>(n - i) / size, static_cast<float>(n) / size, static_cast<float>(i + 1) / size },
+                 3 };
+    }
+    return { { i * 2, i * 2 + 1, 0 }, { .5f, .5f, 0.f }, 2 };
+}
+
+// Box filters a level with an odd side, over up to 3x3 texels.
+static void averageOdd(const MipLevel& source, const BoxFootprint& xs, const BoxFootprint& ys, const bool srgb,
+                       unsigned char* out) {
+    const SrgbTables& tables = srgbTables();
+    std::array<float, 4> sum{};
+    for(std::size_t j = 0; j < ys.count; ++j) {
+        for(std::size_t i = 0; i < xs.count; ++i) {
+            const unsigned char* texel = texelAt(source, xs.texels[i], ys.texels[j]);
+            const float weight{ xs.weights[i] * ys.weights[j] };
+            for(std::size_t channel = 0; channel < 3; ++channel) {
+                sum[channel] += weight * (srgb ? tables.toLinear[texel[channel]] : static_cast<float>(texel[channel]));
+            }
+            sum[3] += weight * static_cast<float>(texel[3]);
+        }
+    }
+    for(std::size_t channel = 0; channel < 3; ++channel) {
+        out[channel] = srgb ? tables.fromLinear[static_cast<std::size_t>(sum[channel] * (LinearSteps - 1) + 0.5f)]
+                            : static_cast<unsigned char>(sum[channel] + 0.5f);
+    }
+    out[3] = static_cast<unsigned char>(sum[3] + 0.5f);
+}
+
+static MipLevel downsample(const MipLevel& source, const bool srgb) {
+    MipLevel level;
+    level.width = std::max(1, source.width / 2);
+    level.height = std::max(1, source.height / 2);
+    level.rgba.resize(static_cast<std::size_t>(level.width) * static_cast<std::size_t>(level.height) * 4);
+
+    const bool odd{ (source.width > 1 && source.width % 2 == 1) || (source.height > 1 && source.height % 2 == 1) };
+    for(int y = 0; y < level.height; ++y) {
+        unsigned char* out = level.rgba.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(level.width) * 4;
+        int x{ 0 };
+
+        if(odd) {
+            const BoxFootprint ys{ boxFootprint(y, source.height) };
+            for(; x < level.width; ++x) {
+                averageOdd(source, boxFootprint(x, source.width), ys, srgb, out + x * 4);
+            }
+            continue;
+        }
+
+        if(srgb) {
+            for(; x < level.width; ++x) {
+                averageSrgb(source, x, y, out + x * 4);
+            }
+            continue;
+        }
+
+#ifdef __SSE2__
+        // Two output texels per step: four source texels from each of the two rows, widened to 16 bits, summed
+        // vertically, then each horizontal pair summed, rounded and narrowed back.
+        const unsigned char* row0 = texelAt(source, 0, y * 2);
+        const unsigned char* row1 = texelAt(source, 0, y * 2 + 1);
+        const __m128i zero{ _mm_setzero_si128() };
+        const __m128i rounding{ _mm_set1_epi16(2) };
+        for(; x + 1 < level.width && x * 2 + 3 < source.width; x += 2) {
+            const __m128i top{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8)) };
+            const __m128i bottom{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8)) };
+            const __m128i left{ _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero)) };
+            const __m128i right{ _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero)) };
+            const __m128i sum{ _mm_add_epi16(_mm_unpacklo_epi64(left, right), _mm_unpackhi_epi64(left, right)) };
+            const __m128i average{ _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2) };
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(average, zero));
+        }
+#endif
+        for(; x < level.width; ++x) {
+            averageLinear(source, x, y, out + x * 4);
+        }
+    }
+
+    return level;
+}
+
+// Share of texels that survive an alpha test at cutoff once alpha is multiplied by scale.
+static float alphaCoverage(const MipLevel& level, const float cutoff, const float scale) {
+    const float threshold{ cutoff * 255.f };
+    std::size_t passing{ 0 };
+    for(std::size_t i = 3; i < level.rgba.size(); i += 4) {
+        if(static_cast<float>(level.rgba[i]) * scale > threshold) {
+            ++passing;
+        }
+    }
+    return static_cast<float>(passing) / static_cast<float>(level.rgba.size() / 4);
+}
+
+// Coverage only grows with the scale, so a bisection closes in on the target. Small levels can't hit it exactly and
+// take whichever side comes closer, rather than always the lower one that would drop them to nothing.
+static void scaleAlphaToCoverage(MipLevel& level, const float coverage, const float cutoff) {
+    float low{ 0.f };
+    float high{ 4.f };
+    for(int iteration = 0; iteration < 12; ++iteration) {
+        const float middle{ (low + high) * 0.5f };
+        if(alphaCoverage(level, cutoff, middle) > coverage) {
+            high = middle;
+        } else {
+            low = middle;
+        }
+    }
+
+    const float lowError{ coverage - alphaCoverage(level, cutoff, low) };
+    const float highError{ alphaCoverage(level, cutoff, high) - coverage };
+    const float scale{ lowError <= highError ? low : high };
+    for(std::size_t i = 3; i < level.rgba.size(); i += 4) {
+        level.rgba[i] = static_cast<unsigned char>(std::min(255.f, static_cast<float>(level.rgba[i]) * scale + 0.5f));
+    }
+}
+
+std::vector<MipLevel> generateMipChain(MipLevel base, const MipOptions& options) {
+    std::vector<MipLevel> levels;
+    levels.push_back(std::move(base));
+
+    while(levels.back().width > 1 || levels.back().height > 1) {
+        levels.push_back(downsample(levels.back(), options.srgb));
+    }
+
+    // Every level is filtered from the unscaled alpha of the one above, scaling comes last.
+    if(options.preserveAlphaCoverage) {
+        const float coverage{ alphaCoverage(levels.front(), options.alphaCutoff, 1.f) };
+        for(std::size_t i = 1; i < levels.size(); ++i) {
+            scaleAlphaToCoverage(levels[i], coverage, options.alphaCutoff);
+        }
+    }
+
+    return levels;
+}
+
+// Direction through the point (s, t) of face, both from -1 to 1. Faces are laid out as in the GL spec's cube map table,
+// where face is the major axis and s and t come from its sc and tc.
+static std::array<float, 3> cubeDirection(const std::size_t face, const float s, const float t) {
+    switch(face) {
+    case 0:
+        return { 1.f, -t, -s };
+    case 1:
+        return { -1.f, -t, s };
+    case 2:
+        return { s, 1.f, t };
+    case 3:
+        return { s, -1.f, -t };
+    case 4:
+        return { s, -t, 1.f };
+    default:
+        return { -s, -t, -1.f };
+    }
+}
+
+// The texel at x, y of face, which may lie past the face's edge. Those are found by following the direction through
+// them onto whichever face it hits.
+static const unsigned char* cubeTexelAt(const CubeLevel& level, std::size_t face, int x, int y) {
+    const int size{ level[face].width };
+    if(x < 0 || y < 0 || x >= size || y >= size) {
+        const float texelSize{ 2.f / static_cast<float>(size) };
+        const auto [dx, dy, dz] = cubeDirection(face, (static_cast<float>(x) + .5f) * texelSize - 1.f,
+                                                (static_cast<float>(y) + .5f) * texelSize - 1.f);
+        const float ax{ std::abs(dx) };
+        const float ay{ std::abs(dy) };
+        const float az{ std::abs(dz) };
+        float s{ 0.f };
+        float t{ 0.f };
+        if(ax >= ay && ax >= az) {
+            face = dx > 0.f ? 0 : 1;
+            s = (dx > 0.f ? -dz : dz) / ax;
+            t = -dy / ax;
+        } else if(ay >= az) {
+            face = dy > 0.f ? 2 : 3;
+            s = dx / ay;
+            t = (dy > 0.f ? dz : -dz) / ay;
+        } else {
+            face = dz > 0.f ? 4 : 5;
+            s = (dz > 0.f ? dx : -dx) / az;
+            t = -dy / az;
+        }
+        x = std::clamp(static_cast<int>((s + 1.f) * .5f * static_cast<float>(size)), 0, size - 1);
+        y = std::clamp(static_cast<int>((t + 1.f) * .5f * static_cast<float>(size)), 0, size - 1);
+    }
+    return texelAt(level[face], x, y);
+}
+
+struct TentTap {
+    int texel;
+    float weight;
+};
+
+// Source texels under the tent centred on texel i of a level of size, normalised weights. Halving a level gives the
+// usual 1 3 3 1 over the four texels around the pair i covers, odd sizes get fractional footprints.
+static std::vector<TentTap> tentTaps(const int i, const int sourceSize, const int size) {
+    const float scale{ static_cast<float>(sourceSize) / static_cast<float>(size) };
+    const float centre{ (static_cast<float>(i) + .5f) * scale };
+    std::vector<TentTap> taps;
+    float total{ 0.f };
+    const int last{ static_cast<int>(std::ceil(centre + scale)) };
+    for(int texel = static_cast<int>(std::floor(centre - scale)); texel < last; ++texel) {
+        const float weight{ scale - std::abs(static_cast<float>(texel) + .5f - centre) };
+        if(weight > 0.f) {
+            taps.push_back({ texel, weight });
+            total += weight;
+        }
+    }
+    for(auto& tap : taps) {
+        tap.weight /= total;
+    }
+    return taps;
+}
+
+MipLevel downsampleCubeFace(const CubeLevel& source, const std::size_t face, const bool srgb) {
+    const SrgbTables& tables = srgbTables();
+    std::array<float, 256> toLinear{};
+    for(std::size_t i = 0; i < toLinear.size(); ++i) {
+        toLinear[i] = srgb ? tables.toLinear[i] : static_cast<float>(i) / 255.f;
+    }
+
+    const int sourceSize{ source[face].width };
+    MipLevel level;
+    level.width = std::max(1, sourceSize / 2);
+    level.height = level.width;
+    level.rgba.resize(static_cast<std::size_t>(level.width) * static_cast<std::size_t>(level.height) * 4);
+
+    // Faces are square, rows and columns share their taps.
+    std::vector<std::vector<TentTap>> taps;
+    for(int i = 0; i < level.width; ++i) {
+        taps.push_back(tentTaps(i, sourceSize, level.width));
+    }
+
+    unsigned char* out = level.rgba.data();
+    for(int y = 0; y < level.height; ++y) {
+        for(int x = 0; x < level.width; ++x, out += 4) {
+            std::array<float, 4> sum{};
+            for(const TentTap& row : taps[static_cast<std::size_t>(y)]) {
+                for(const TentTap& column : taps[static_cast<std::size_t>(x)]) {
+                    const unsigned char* texel = cubeTexelAt(source, face, column.texel, row.texel);
+                    const float weight{ row.weight * column.weight };
+                    for(std::size_t channel = 0; channel < 3; ++channel) {
+                        sum[channel] += weight * toLinear[texel[channel]];
+                    }
+                    sum[3] += weight * static_cast<float>(texel[3]) / 255.f;
+                }
+            }
+            for(std::size_t channel = 0; channel < 3; ++channel) {
+                const float value{ std::clamp(sum[channel], 0.f, 1.f) };
+                out[channel] = srgb ? tables.fromLinear[static_cast<std::size_t>(value * (LinearSteps - 1) + .5f)]
+                                    : static_cast<unsigned char>(value * 255.f + .5f);
+            }
+            out[3] = static_cast<unsigned char>(std::clamp(sum[3], 0.f, 1.f) * 255.f + .5f);
+        }
+    }
+
+    return level;
+}
+
+bool isAlphaTested(const std::vector<unsigned char>& rgba) {
+    std::size_t transparent{ 0 };
+    std::size_t opaque{ 0 };
+    for(std::size_t i = 3; i < rgba.size(); i += 4) {
+        transparent += rgba[i] <= 8;
+        opaque += rgba[i] >= 247;
+    }
+
+    const std::size_t texels{ rgba.size() / 4 };
+    return texels > 0 && (transparent + opaque) * 100 >= texels * 85 && transparent * 100 >= texels * 5;
+}
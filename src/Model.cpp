@@ -1,77 +1,253 @@
 #include <Model.hpp>
+#include <ImportProfiler.hpp>
+#include <AssetPack.hpp>
+#include <TextureLoader.hpp>
+#include <TextureStreamer.hpp>
+#include <TexturePacker.hpp>
+#include <TextureManager.hpp>
+#include <ObjLoader.hpp>
 
 #include <glad/glad.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <stb_image.h>
 #include <iostream>
+#include <array>
 
 #include <assimp/types.h>
 
-static unsigned int textureFromFile(const char* path, const std::string& directory, [[maybe_unused]]bool gamma = false) {
-    std::string fileName = std::string(path);
-    fileName = directory + '/' + fileName;
+// Units the arrays start at, GL 3.3 guarantees 16 in the fragment shader. Meshes of a model that isn't packed bind
+// their textures one by one from unit 0.
+static constexpr unsigned int PackedTextureUnit{ 4 };
+static constexpr std::size_t MaxPackedArrays{ 12 };
 
-    unsigned int textureID = 0;
-    glGenTextures(1, &textureID);
+// Specular maps are masks, everything else is colour. Colour is sampled as sRGB, plain or packed alike.
+static TextureUsage textureUsage(const Texture& texture) {
+    return texture.textureType == TextureType::SPECULAR ? TextureUsage::MASK : TextureUsage::COLOUR;
+}
+
+struct PostProcessStep {
+    unsigned int flag;
+    const char* name;
+};
+
+// Listed in the order Assimp's own pipeline runs them, so applying them one at a time yields the same scene as passing
+// them all to ReadFile. FlipUVs comes first there, so the tangents are computed on the flipped UVs.
+static constexpr std::array<PostProcessStep, 4> PostProcessSteps{{
+    { aiProcess_FlipUVs, "post-process: FlipUVs" },
+    { aiProcess_Triangulate, "post-process: Triangulate" },
+    { aiProcess_GenSmoothNormals, "post-process: GenSmoothNormals" },
+    { aiProcess_CalcTangentSpace, "post-process: CalcTangentSpace" },
+}};
+
+Model::Model(const std::string& path, ImportProfile* profile) {
+    if(!profile) {
+        loadModel(path);
+        return;
+    }
 
-    int width = 0, height = 0, numberComponents = 0;
-    unsigned char* data = stbi_load(fileName.c_str(), &width, &height, &numberComponents, 0);
+    profile->path = path;
+    const auto start = std::chrono::steady_clock::now();
+    const auto startBytes = threadAllocatedBytes();
 
-    if(!data) {
-        std::cerr << "::stbi_load:: ERROR LOADING TEXTURE, path -> " << path << '\n';
-        stbi_image_free(data);
+    beginImportProfile(profile);
+    loadModel(path);
+    endImportProfile();
+
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    profile->totalSeconds = elapsed.count();
+    profile->totalAllocatedBytes = threadAllocatedBytes() - startBytes;
+    // stb_image allocates with malloc, which the operator new counter above does not see.
+    for(const auto& stage : profile->stages) {
+        if(stage.name == "image decode") {
+            profile->totalAllocatedBytes += stage.allocatedBytes;
+        }
     }
+}
 
-    GLenum format = GL_RGB;
-    if(numberComponents == 1) {
-        format = GL_RED;
-    } else if(numberComponents == 3) {
-        format = GL_RGB;
-    } else if(numberComponents == 4) {
-        format = GL_RGBA;
+void Model::draw(Shader& shader) const {
+    bindTextureArrays();
+    for(const auto& mesh : meshes) {
+        mesh.draw(shader);
     }
+}
 
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+void Model::drawInstanced(Shader& shader) const {
+    bindTextureArrays();
+    for(const auto& mesh : meshes) {
+        mesh.drawInstanced(shader, instanceCount);
+    }
+}
+
+void Model::setInstanceTransforms(const std::vector<glm::mat4>& transforms) {
+    if(instanceVBO == 0) {
+        glGenBuffers(1, &instanceVBO);
+        for(auto& mesh : meshes) {
+            mesh.setInstanceBuffer(instanceVBO);
+        }
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    instanceCount = static_cast<unsigned int>(transforms.size());
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(transforms.size() * sizeof(glm::mat4)), transforms.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    stbi_image_free(data);
+void Model::requestTextureDetail(const Camera& camera, const glm::mat4& transform, const float viewportHeight) const {
+    TextureStreamer* streamer = activeTextureStreamer();
+    if(!streamer) {
+        return;
+    }
 
-    return textureID;
+    for(const auto& mesh : meshes) {
+        const float pixels{ camera.projectedSize(transformSphere(mesh.bounds.sphere, transform), viewportHeight) };
+        for(const auto& texture : mesh.textures) {
+            streamer->request(texture.id, pixels);
+        }
+    }
 }
 
-Model::Model(const std::string& path) {
-    loadModel(path);
+bool Model::packTextures() {
+    if(!textureArrays.empty()) {
+        return true;
+    }
+
+    // The streamer uploads from the cache too, but owns its textures and swaps their levels under us.
+    const TextureStreamer* streamer = activeTextureStreamer();
+    std::vector<KtxTexture> chains(texturesLoaded.size());
+    std::vector<bool> gammaCorrection(texturesLoaded.size());
+    for(std::size_t i = 0; i < texturesLoaded.size(); ++i) {
+        gammaCorrection[i] = textureUsage(texturesLoaded[i]) == TextureUsage::COLOUR;
+        if((streamer && streamer->owns(texturesLoaded[i].id)) ||
+           !readKtx(textureCachePath(directory + '/' + texturesLoaded[i].path), chains[i])) {
+            return false;
+        }
+    }
+
+    // A shader samples either arrays or plain textures, so a mesh with some of each couldn't be drawn with either.
+    const TexturePacking packing{ packTextureArrays(chains, gammaCorrection, MaxPackedArrays) };
+    for(const auto& placement : packing.placements) {
+        if(placement.array == TexturePlacement::NotPacked) {
+            for(const unsigned int array : packing.arrays) {
+                releaseTexture(array);
+            }
+            return false;
+        }
+    }
+
+    for(std::size_t i = 0; i < texturesLoaded.size(); ++i) {
+        const TexturePlacement& placement = packing.placements[i];
+        Texture& texture = texturesLoaded[i];
+        releaseTexture(texture.id);
+        texture.id = packing.arrays[placement.array];
+        texture.packed = true;
+        texture.unit = PackedTextureUnit + static_cast<unsigned int>(placement.array);
+        texture.layer = placement.layer;
+        texture.uvTransform = placement.uvTransform;
+    }
+    textureArrays = packing.arrays;
+
+    updateMeshTextures();
+    return true;
 }
 
-void Model::draw(Shader& shader) const {
-    for(const auto& mesh : meshes) {
-        mesh.draw(shader);
+void Model::bindTextureArrays() const {
+    for(std::size_t i = 0; i < textureArrays.size(); ++i) {
+        bindTexture(PackedTextureUnit + static_cast<unsigned int>(i), GL_TEXTURE_2D_ARRAY, textureArrays[i]);
     }
 }
 
 void Model::loadModel(const std::string& path) {
+    directory = path.substr(0, path.find_last_of('/'));
+
+    // Plain Wavefront files don't need Assimp's general pipeline, Assimp stays as the fallback if our parser refuses one.
+    const auto extension = path.substr(path.find_last_of('.') + 1);
+    if(!(extension == "obj" || extension == "OBJ") || !loadObjModel(path)) {
+        loadAssimpModel(path);
+    }
+
+    uploadTextures();
+
+    for(std::size_t i = 0; i < meshes.size(); ++i) {
+        bounds = i == 0 ? meshes[i].bounds : mergeBounds(bounds, meshes[i].bounds);
+    }
+}
+
+void Model::loadAssimpModel(const std::string& path) {
     Assimp::Importer importer;
+    const aiScene* scene{ nullptr };
 
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    ImportProfile* profile{ activeImportProfile() };
+
+    if(!profile) {
+        if(mountedAssetPack()) {
+            importer.SetIOHandler(new PackIOSystem);
+        }
+
+        unsigned int flags{ 0 };
+        for(const auto& step : PostProcessSteps) {
+            flags |= step.flag;
+        }
+        scene = importer.ReadFile(path, flags);
+    } else {
+        // Assimp reads and parses in one call, the timed file system lets us take the time spent in reads out of the
+        // parse. The file read stage is created first so it comes first in the report.
+        ImportStageStats& fileRead = profile->stage("file read");
+        importer.SetIOHandler(new TimedIOSystem(fileRead));
+        const double readSeconds{ fileRead.seconds };
+        const std::size_t readBytes{ fileRead.allocatedBytes };
+        {
+            ScopedImportStage stage("Assimp parse");
+            scene = importer.ReadFile(path, 0);
+        }
+        ImportStageStats& parse = profile->stage("Assimp parse");
+        parse.seconds -= fileRead.seconds - readSeconds;
+        parse.allocatedBytes -= fileRead.allocatedBytes - readBytes;
+
+        for(const auto& step : PostProcessSteps) {
+            if(!scene) {
+                break;
+            }
+            ScopedImportStage stage(step.name);
+            scene = importer.ApplyPostProcessing(step.flag);
+        }
+    }
 
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cerr << "ERROR reading file in ASSIMP! " << importer.GetErrorString() << '\n';
         return;
     }
 
-    directory = path.substr(0, path.find_last_of('/'));
-
     processNode(scene->mRootNode, scene);
 }
 
+bool Model::loadObjModel(const std::string& path) {
+    ObjModel obj;
+    if(!loadObj(path, obj)) {
+        std::cerr << "Native OBJ loader failed, falling back to ASSIMP for " << path << '\n';
+        return false;
+    }
+
+    for(auto& objMesh : obj.meshes) {
+        std::vector<Texture> textures;
+        if(objMesh.material >= 0) {
+            const auto& material = obj.materials[static_cast<std::size_t>(objMesh.material)];
+            if(!material.diffuseMap.empty()) {
+                textures.push_back(loadMaterialTexture(material.diffuseMap, TextureType::DIFFUSE));
+            }
+            if(!material.specularMap.empty()) {
+                textures.push_back(loadMaterialTexture(material.specularMap, TextureType::SPECULAR));
+            }
+        }
+
+        ScopedImportStage stage("GL upload");
+        meshes.push_back(Mesh(std::move(objMesh.vertices), std::move(textures), std::move(objMesh.indices)));
+    }
+
+    return true;
+}
+
 void Model::processNode(aiNode* node, const aiScene* const scene) {
     for(unsigned int i = 0; i < node->mNumMeshes; ++i) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
@@ -88,34 +264,40 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* const scene) {
     std::vector<unsigned int> indices;
     std::vector<Texture> textures;
 
-    for(unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-        Vertex vertex;
+    {
+        ScopedImportStage stage("vertex conversion");
+        for(unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            Vertex vertex;
 
-        vertex.position = glm::vec3(mesh->mVertices[i].x,
-                                    mesh->mVertices[i].y,
-                                    mesh->mVertices[i].z);
+            vertex.position = glm::vec3(mesh->mVertices[i].x,
+                                        mesh->mVertices[i].y,
+                                        mesh->mVertices[i].z);
 
-        if(mesh->HasNormals()) {
-            vertex.normal = glm::vec3(mesh->mNormals[i].x,
-                                      mesh->mNormals[i].y,
-                                      mesh->mNormals[i].z);
-        }
+            if(mesh->HasNormals()) {
+                vertex.normal = glm::vec3(mesh->mNormals[i].x,
+                                          mesh->mNormals[i].y,
+                                          mesh->mNormals[i].z);
+            }
 
-        // There are 8 possible texture coordinates, but we only care about the first two.
-        if(mesh->mTextureCoords[0]) {
-            vertex.textureCoordinates = glm::vec2(mesh->mTextureCoords[0][i].x,
-                                                  mesh->mTextureCoords[0][i].y);
-        } else {
-            vertex.textureCoordinates = glm::vec2(0.0f, 0.0f);
-        }
+            // There are 8 possible texture coordinates, but we only care about the first two.
+            if(mesh->mTextureCoords[0]) {
+                vertex.textureCoordinates = glm::vec2(mesh->mTextureCoords[0][i].x,
+                                                      mesh->mTextureCoords[0][i].y);
+            } else {
+                vertex.textureCoordinates = glm::vec2(0.0f, 0.0f);
+            }
 
-        vertices.push_back(vertex);
+            vertices.push_back(vertex);
+        }
     }
 
-    for(unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        aiFace face = mesh->mFaces[i];
-        for(unsigned int j = 0; j < face.mNumIndices; ++j) {
-            indices.push_back(face.mIndices[j]);
+    {
+        ScopedImportStage stage("index conversion");
+        for(unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            aiFace face = mesh->mFaces[i];
+            for(unsigned int j = 0; j < face.mNumIndices; ++j) {
+                indices.push_back(face.mIndices[j]);
+            }
         }
     }
 
@@ -123,9 +305,10 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* const scene) {
     std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE);
     textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
     std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR);
-    textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+    textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
-    return Mesh(vertices, textures, indices);
+    ScopedImportStage stage("GL upload");
+    return Mesh(std::move(vertices), std::move(textures), std::move(indices));
 }
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type) {
@@ -135,39 +318,69 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType
         aiString str;
         mat->GetTexture(type, i, &str);
 
-        bool skip = false;
+        TextureType myType = TextureType::DIFFUSE;
+        switch(type) {
+        case aiTextureType_DIFFUSE:
+            myType = TextureType::DIFFUSE;
+            break;
+        case aiTextureType_SPECULAR:
+            myType = TextureType::SPECULAR;
+            break;
+        default:
+            break;
+        }
+
+        textures.push_back(loadMaterialTexture(str.C_Str(), myType));
+    }
+
+    return textures;
+}
 
+Texture Model::loadMaterialTexture(const std::string& file, const TextureType type) {
+    {
+        ScopedImportStage stage("texture lookup");
         for(unsigned int j = 0; j < texturesLoaded.size(); ++j) {
-            if (std::strcmp(texturesLoaded[j].path.data(), str.C_Str()) == 0) {
-                textures.push_back(texturesLoaded[j]);
-                skip = true;
-                break;
+            if(texturesLoaded[j].path == file) {
+                return texturesLoaded[j];
             }
         }
+    }
 
-        if(!skip) {
-            TextureType myType = TextureType::DIFFUSE;
-            switch(type) {
-            case aiTextureType_DIFFUSE:
-                myType = TextureType::DIFFUSE;
-                break;
-            case aiTextureType_SPECULAR:
-                myType = TextureType::SPECULAR;
-                break;
-            default:
-                break;
-            }
+    // The id is filled in by uploadTextures once every mesh has asked for its textures.
+    Texture t {
+        .id = 0,
+        .textureType = type,
+        .path = file
+    };
 
-            Texture t {
-                .id = textureFromFile(str.C_Str(), directory),
-                .textureType = myType,
-                .path = std::string(str.C_Str())
-            };
+    texturesLoaded.push_back(t);
+    return t;
+}
 
-            textures.push_back(t);
-            texturesLoaded.push_back(t);
-        }
+void Model::uploadTextures() {
+    TextureBatch batch;
+    for(const auto& texture : texturesLoaded) {
+        const TextureUsage usage{ textureUsage(texture) };
+        batch.add(directory + '/' + texture.path, usage == TextureUsage::COLOUR, usage);
     }
 
-    return textures;
+    const auto ids = batch.upload();
+    for(std::size_t i = 0; i < texturesLoaded.size(); ++i) {
+        texturesLoaded[i].id = ids[i];
+    }
+
+    updateMeshTextures();
+}
+
+void Model::updateMeshTextures() {
+    for(auto& mesh : meshes) {
+        for(auto& texture : mesh.textures) {
+            for(const auto& loaded : texturesLoaded) {
+                if(loaded.path == texture.path) {
+                    texture = loaded;
+                    break;
+                }
+            }
+        }
+    }
 }
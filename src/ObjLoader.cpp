@@ -0,0 +1,802 @@
+#include <ObjLoader.hpp>
+#include <AssetPack.hpp>
+#include <ImportProfiler.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+constexpr std::int32_t NoIndex{ INT32_MIN };
+
+// Below these a chunk, or a mesh to deduplicate, is not worth a thread.
+constexpr std::size_t MinChunkBytes{ 1 << 20 };
+constexpr std::size_t MinShardCorners{ 1 << 16 };
+
+struct Corner {
+    std::int32_t position;
+    std::int32_t textureCoordinates;
+    std::int32_t normal;
+
+    bool operator==(const Corner& other) const {
+        return position == other.position && textureCoordinates == other.textureCoordinates && normal == other.normal;
+    }
+};
+
+// A negative face index counts back from the last vertex seen, which for a chunk parsed on its own is only known once
+// every earlier chunk has been counted. These are patched afterwards.
+struct RelativeIndex {
+    std::size_t corner;
+    std::uint8_t component;
+};
+
+struct MaterialSwitch {
+    std::size_t corner;
+    std::string material;
+};
+
+struct Chunk {
+    const char* begin{ nullptr };
+    const char* end{ nullptr };
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> textureCoordinates;
+    std::vector<glm::vec3> normals;
+    std::vector<Corner> corners;
+    std::vector<RelativeIndex> relativeIndices;
+    std::vector<MaterialSwitch> materialSwitches;
+    std::vector<std::string> materialLibraries;
+
+    bool failed{ false };
+};
+
+// A contiguous range of corners, in one chunk, drawn with one material.
+struct CornerRun {
+    const Corner* begin;
+    const Corner* end;
+};
+
+constexpr std::array<double, 23> Pow10{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+constexpr std::array<std::uint64_t, 19> Pow10Integer{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+};
+
+}
+
+template<typename Function>
+static void parallelFor(const std::size_t count, const unsigned int threads, Function&& function) {
+    if(threads <= 1 || count <= 1) {
+        for(std::size_t i = 0; i < count; ++i) {
+            function(i);
+        }
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    const std::size_t workerCount{ std::min<std::size_t>(threads, count) };
+    workers.reserve(workerCount);
+    for(std::size_t w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&, w]() {
+            for(std::size_t i = w; i < count; i += workerCount) {
+                function(i);
+            }
+        });
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+}
+
+static bool isDigit(const char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Converts up to eight ASCII digits, already stripped of '0', in the low bytes of chunk (first digit in the lowest byte)
+// with three multiplies instead of eight.
+static std::uint64_t combineEightDigits(std::uint64_t chunk) {
+    chunk = (chunk * 10) + (chunk >> 8);
+    return (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+            (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+}
+
+static std::uint64_t parseDigitsSwar(const char* p, const unsigned int count) {
+    std::uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    // Bytes past count may borrow while subtracting, but borrows only travel towards later bytes, which the shift
+    // drops. What is left are the digits, aligned as if they had leading zeros.
+    chunk -= 0x3030303030303030ULL;
+    chunk <<= 8 * (8 - count);
+    return combineEightDigits(chunk);
+}
+
+// Consumes a run of decimal digits. Returns how many were read; the value is only meaningful for up to 19 of them.
+static unsigned int parseDigits(const char*& p, const char* end, std::uint64_t& value) {
+    value = 0;
+
+#ifdef __SSE2__
+    // Only when 16 bytes can be loaded without running off the mapping.
+    if(end - p >= 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                             _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+        const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(digits));
+        const auto count = static_cast<unsigned int>(__builtin_ctz(~mask | 0x10000u));
+
+        if(count < 16) {
+            if(count == 0) {
+                return 0;
+            }
+            if(count <= 8) {
+                value = parseDigitsSwar(p, count);
+            } else {
+                value = parseDigitsSwar(p, 8) * Pow10Integer[count - 8] + parseDigitsSwar(p + 8, count - 8);
+            }
+            p += count;
+            return count;
+        }
+    }
+#endif
+
+    unsigned int count{ 0 };
+    while(p < end && isDigit(*p)) {
+        if(count < 19) {
+            value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+        }
+        ++count;
+        ++p;
+    }
+    return count;
+}
+
+static const char* skipSpaces(const char* p, const char* end) {
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+static const char* skipLine(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) + 1 : end;
+}
+
+static bool parseFloat(const char*& p, const char* end, float& out) {
+    const char* start = p;
+    bool negative{ false };
+    if(p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    std::uint64_t integer{ 0 }, fraction{ 0 };
+    const unsigned int integerDigits{ parseDigits(p, end, integer) };
+    unsigned int fractionDigits{ 0 };
+    if(p < end && *p == '.') {
+        ++p;
+        fractionDigits = parseDigits(p, end, fraction);
+    }
+
+    if(integerDigits + fractionDigits == 0) {
+        p = start;
+        return false;
+    }
+
+    int exponent{ 0 };
+    if(p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent{ false };
+        if(p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        std::uint64_t exponentValue{ 0 };
+        if(parseDigits(p, end, exponentValue) == 0 || exponentValue > 400) {
+            p = start;
+            return false;
+        }
+        exponent = negativeExponent ? -static_cast<int>(exponentValue) : static_cast<int>(exponentValue);
+    }
+
+    const std::uint64_t mantissa{ integerDigits + fractionDigits <= 18 ? integer * Pow10Integer[fractionDigits] + fraction : 0 };
+
+    // Too many digits for the mantissa to be an exact double, rare enough to hand to the C library.
+    if(integerDigits + fractionDigits > 18 || mantissa > (1ULL << 53)) {
+        std::array<char, 64> buffer{};
+        const auto length = std::min<std::size_t>(static_cast<std::size_t>(p - start), buffer.size() - 1);
+        std::memcpy(buffer.data(), start, length);
+        out = std::strtof(buffer.data(), nullptr);
+        return true;
+    }
+
+    exponent -= static_cast<int>(fractionDigits);
+
+    // Both the mantissa and the power of ten are exact doubles here, so one multiply or divide rounds correctly.
+    double value = static_cast<double>(mantissa);
+    if(exponent >= 0 && exponent <= 22) {
+        value *= Pow10[static_cast<std::size_t>(exponent)];
+    } else if(exponent < 0 && exponent >= -22) {
+        value /= Pow10[static_cast<std::size_t>(-exponent)];
+    } else {
+        value *= std::pow(10.0, exponent);
+    }
+
+    out = static_cast<float>(negative ? -value : value);
+    return true;
+}
+
+static bool parseIndex(const char*& p, const char* end, std::int64_t& out) {
+    bool negative{ false };
+    if(p < end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    std::uint64_t value{ 0 };
+    const unsigned int digits{ parseDigits(p, end, value) };
+    if(digits == 0 || digits > 10 || value == 0) {
+        return false;
+    }
+
+    out = negative ? -static_cast<std::int64_t>(value) : static_cast<std::int64_t>(value);
+    return true;
+}
+
+// Turns a 1-based or negative OBJ index into a 0-based one. Negative ones are made relative to this chunk and flagged
+// in relativeMask so they can be patched once the chunk's base is known.
+static bool resolveIndex(const std::int64_t index, const std::size_t localCount, const std::uint8_t component,
+                         std::int32_t& out, std::uint8_t& relativeMask) {
+    if(index > 0) {
+        if(index > INT32_MAX) {
+            return false;
+        }
+        out = static_cast<std::int32_t>(index - 1);
+        return true;
+    }
+
+    // Still negative when it reaches back into earlier chunks; the patch in loadObj adds their counts. Nothing further
+    // back than INT32_MAX elements can land in range, and letting it through would wrap into a valid-looking index.
+    const std::int64_t local{ static_cast<std::int64_t>(localCount) + index };
+    if(local < -INT32_MAX || local > INT32_MAX) {
+        return false;
+    }
+    out = static_cast<std::int32_t>(local);
+    relativeMask = static_cast<std::uint8_t>(relativeMask | (1u << component));
+    return true;
+}
+
+static std::string_view restOfLine(const char* p, const char* end) {
+    p = skipSpaces(p, end);
+    const char* lineEnd = p;
+    while(lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') {
+        ++lineEnd;
+    }
+    // Trailing spaces are not part of the name.
+    while(lineEnd > p && (lineEnd[-1] == ' ' || lineEnd[-1] == '\t')) {
+        --lineEnd;
+    }
+    return std::string_view(p, static_cast<std::size_t>(lineEnd - p));
+}
+
+static bool startsWithKeyword(const char* p, const char* end, const std::string_view keyword) {
+    const auto available = static_cast<std::size_t>(end - p);
+    if(available <= keyword.size() || std::memcmp(p, keyword.data(), keyword.size()) != 0) {
+        return false;
+    }
+    const char next = p[keyword.size()];
+    return next == ' ' || next == '\t';
+}
+
+static bool parseFace(const char* p, const char* end, Chunk& chunk) {
+    struct PolygonCorner {
+        Corner corner;
+        std::uint8_t relativeMask;
+    };
+
+    std::array<PolygonCorner, 64> polygon;
+    std::size_t polygonSize{ 0 };
+
+    while(true) {
+        p = skipSpaces(p, end);
+        if(p >= end || *p == '\n' || *p == '#') {
+            break;
+        }
+
+        if(polygonSize == polygon.size()) {
+            return false;
+        }
+
+        PolygonCorner& entry = polygon[polygonSize++];
+        entry = PolygonCorner{ .corner = { NoIndex, NoIndex, NoIndex }, .relativeMask = 0 };
+        std::int64_t index{ 0 };
+        if(!parseIndex(p, end, index) ||
+           !resolveIndex(index, chunk.positions.size(), 0, entry.corner.position, entry.relativeMask)) {
+            return false;
+        }
+
+        if(p < end && *p == '/') {
+            ++p;
+            if(p < end && *p != '/') {
+                if(!parseIndex(p, end, index) ||
+                   !resolveIndex(index, chunk.textureCoordinates.size(), 1, entry.corner.textureCoordinates,
+                                 entry.relativeMask)) {
+                    return false;
+                }
+            }
+            if(p < end && *p == '/') {
+                ++p;
+                if(!parseIndex(p, end, index) ||
+                   !resolveIndex(index, chunk.normals.size(), 2, entry.corner.normal, entry.relativeMask)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if(polygonSize < 3) {
+        return false;
+    }
+
+    auto emit = [&](const PolygonCorner& entry) {
+        for(std::uint8_t component = 0; component < 3; ++component) {
+            if(entry.relativeMask & (1u << component)) {
+                chunk.relativeIndices.push_back(RelativeIndex{ .corner = chunk.corners.size(), .component = component });
+            }
+        }
+        chunk.corners.push_back(entry.corner);
+    };
+
+    // Fans out polygons the way aiProcess_Triangulate does for convex faces.
+    for(std::size_t i = 1; i + 1 < polygonSize; ++i) {
+        emit(polygon[0]);
+        emit(polygon[i]);
+        emit(polygon[i + 1]);
+    }
+
+    return true;
+}
+
+static void parseChunk(Chunk& chunk) {
+    const char* p = chunk.begin;
+    const char* end = chunk.end;
+
+    while(p < end) {
+        p = skipSpaces(p, end);
+        if(p >= end) {
+            break;
+        }
+
+        const char* lineStart = p;
+        bool ok{ true };
+
+        if(p[0] == 'v' && p + 1 < end) {
+            if(p[1] == ' ' || p[1] == '\t') {
+                glm::vec3 position;
+                p = skipSpaces(p + 1, end);
+                ok = parseFloat(p, end, position.x);
+                p = skipSpaces(p, end);
+                ok = ok && parseFloat(p, end, position.y);
+                p = skipSpaces(p, end);
+                ok = ok && parseFloat(p, end, position.z);
+                chunk.positions.push_back(position);
+            } else if(p[1] == 't') {
+                glm::vec2 textureCoordinates{ 0.f, 0.f };
+                p = skipSpaces(p + 2, end);
+                ok = parseFloat(p, end, textureCoordinates.x);
+                p = skipSpaces(p, end);
+                // A 1D texture coordinate is legal, v stays 0.
+                if(p < end && *p != '\n') {
+                    ok = ok && parseFloat(p, end, textureCoordinates.y);
+                }
+                chunk.textureCoordinates.push_back(textureCoordinates);
+            } else if(p[1] == 'n') {
+                glm::vec3 normal;
+                p = skipSpaces(p + 2, end);
+                ok = parseFloat(p, end, normal.x);
+                p = skipSpaces(p, end);
+                ok = ok && parseFloat(p, end, normal.y);
+                p = skipSpaces(p, end);
+                ok = ok && parseFloat(p, end, normal.z);
+                chunk.normals.push_back(normal);
+            }
+        } else if(p[0] == 'f' && p + 1 < end && (p[1] == ' ' || p[1] == '\t')) {
+            ok = parseFace(p + 1, end, chunk);
+        } else if(startsWithKeyword(p, end, "usemtl")) {
+            chunk.materialSwitches.push_back(MaterialSwitch{
+                .corner = chunk.corners.size(),
+                .material = std::string(restOfLine(p + 6, end)),
+            });
+        } else if(startsWithKeyword(p, end, "mtllib")) {
+            chunk.materialLibraries.emplace_back(restOfLine(p + 6, end));
+        }
+
+        if(!ok) {
+            std::cerr << "::loadObj:: malformed line: " << restOfLine(lineStart, end) << '\n';
+            chunk.failed = true;
+            return;
+        }
+
+        p = skipLine(p, end);
+    }
+}
+
+static void loadMaterialLibrary(const std::string& path, std::vector<ObjMaterial>& materials) {
+    const AssetFile file(path);
+    if(!file.isOpen()) {
+        return;
+    }
+
+    const char* p = file.begin();
+    const char* end = file.end();
+    while(p < end) {
+        p = skipSpaces(p, end);
+
+        if(startsWithKeyword(p, end, "newmtl")) {
+            materials.emplace_back();
+            materials.back().name = restOfLine(p + 6, end);
+        } else if(!materials.empty()) {
+            // Maps may carry options ("-bm 1.0 normal.png"), the file name is always last.
+            auto mapFile = [&](const std::size_t keywordSize) {
+                const std::string_view line = restOfLine(p + keywordSize, end);
+                const auto space = line.find_last_of(" \t");
+                return std::string(space == std::string_view::npos ? line : line.substr(space + 1));
+            };
+
+            if(startsWithKeyword(p, end, "map_Kd")) {
+                materials.back().diffuseMap = mapFile(6);
+            } else if(startsWithKeyword(p, end, "map_Ks")) {
+                materials.back().specularMap = mapFile(6);
+            } else if(startsWithKeyword(p, end, "map_Bump") || startsWithKeyword(p, end, "map_bump")) {
+                materials.back().normalMap = mapFile(8);
+            } else if(startsWithKeyword(p, end, "bump")) {
+                materials.back().normalMap = mapFile(4);
+            }
+        }
+
+        p = skipLine(p, end);
+    }
+}
+
+// Corners are sharded by position and hashed on it within the shard as well: faces next to each other in the file use
+// nearby positions, so their lookups hit nearby slots instead of missing the cache all over a large table. The low bit
+// spreads the positions that appear with several uv/normal pairs along seams.
+static std::uint64_t hashCorner(const Corner& corner, const unsigned int shards) {
+    const std::uint32_t position{ static_cast<std::uint32_t>(corner.position) / shards };
+    const std::uint32_t attributes{ static_cast<std::uint32_t>(corner.textureCoordinates) * 0x9E3779B1u ^
+                                    static_cast<std::uint32_t>(corner.normal) * 0x85EBCA77u };
+    return (static_cast<std::uint64_t>(position) << 1) | (attributes >> 31);
+}
+
+namespace {
+
+// Open addressing map from a corner to the vertex it became. Linear probing on a power of two table.
+class CornerMap {
+public:
+    CornerMap(const std::size_t expected, const unsigned int aShards)
+        :shards(aShards)
+    {
+        std::size_t capacity{ 16 };
+        while(capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        slots.assign(capacity, Slot{});
+    }
+
+    // Returns the existing vertex for corner, or assigns it nextVertex.
+    unsigned int findOrInsert(const Corner& corner, const unsigned int nextVertex) {
+        if((size + 1) * 2 > slots.size()) {
+            grow();
+        }
+
+        const std::size_t mask{ slots.size() - 1 };
+        for(std::size_t i = hashCorner(corner, shards) & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if(slot.vertex == Empty) {
+                slot.corner = corner;
+                slot.vertex = nextVertex;
+                ++size;
+                return nextVertex;
+            }
+            if(slot.corner == corner) {
+                return slot.vertex;
+            }
+        }
+    }
+
+private:
+    static constexpr unsigned int Empty{ UINT_MAX };
+
+    struct Slot {
+        Corner corner{};
+        unsigned int vertex{ Empty };
+    };
+
+    std::vector<Slot> slots;
+    std::size_t size{ 0 };
+    unsigned int shards;
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        const std::size_t mask{ slots.size() - 1 };
+        for(const Slot& slot : old) {
+            if(slot.vertex == Empty) {
+                continue;
+            }
+            std::size_t i = hashCorner(slot.corner, shards) & mask;
+            while(slots[i].vertex != Empty) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+};
+
+struct ModelData {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> textureCoordinates;
+    std::vector<glm::vec3> normals;
+    // Per position, only filled when some corner has no normal of its own.
+    std::vector<glm::vec3> smoothNormals;
+};
+
+}
+
+static Vertex makeVertex(const Corner& corner, const ModelData& data) {
+    Vertex vertex;
+    vertex.position = data.positions[static_cast<std::size_t>(corner.position)];
+    vertex.normal = corner.normal != NoIndex ? data.normals[static_cast<std::size_t>(corner.normal)]
+                                             : data.smoothNormals[static_cast<std::size_t>(corner.position)];
+    if(corner.textureCoordinates != NoIndex) {
+        const glm::vec2 uv = data.textureCoordinates[static_cast<std::size_t>(corner.textureCoordinates)];
+        // Same as aiProcess_FlipUVs.
+        vertex.textureCoordinates = glm::vec2(uv.x, 1.f - uv.y);
+    } else {
+        vertex.textureCoordinates = glm::vec2(0.f, 0.f);
+    }
+    return vertex;
+}
+
+// Deduplicates corners into vertices. Corners are split into shards by position so every thread owns the vertices of
+// its shard outright and no locking is needed; each thread still walks all corners but skips the ones it doesn't own.
+static void buildMesh(const std::vector<CornerRun>& runs, const ModelData& data, const unsigned int threads,
+                      ObjMesh& mesh) {
+    std::size_t cornerCount{ 0 };
+    for(const auto& run : runs) {
+        cornerCount += static_cast<std::size_t>(run.end - run.begin);
+    }
+
+    const unsigned int shards{ cornerCount >= MinShardCorners ? threads : 1u };
+    std::vector<unsigned int> cornerVertex(cornerCount);
+    std::vector<std::vector<Vertex>> shardVertices(shards);
+
+    parallelFor(shards, shards, [&](const std::size_t shard) {
+        // Most meshes have about one vertex per position, the map grows if seams add more.
+        CornerMap map(data.positions.size() / shards + 1, shards);
+        auto& vertices = shardVertices[shard];
+        std::size_t i{ 0 };
+
+        for(const auto& run : runs) {
+            for(const Corner* corner = run.begin; corner != run.end; ++corner, ++i) {
+                if(static_cast<std::uint32_t>(corner->position) % shards != shard) {
+                    continue;
+                }
+
+                const auto next = static_cast<unsigned int>(vertices.size());
+                const unsigned int vertex{ map.findOrInsert(*corner, next) };
+                if(vertex == next) {
+                    vertices.push_back(makeVertex(*corner, data));
+                }
+                cornerVertex[i] = vertex;
+            }
+        }
+    });
+
+    std::vector<unsigned int> shardBase(shards, 0);
+    std::size_t vertexCount{ 0 };
+    for(unsigned int shard = 0; shard < shards; ++shard) {
+        shardBase[shard] = static_cast<unsigned int>(vertexCount);
+        vertexCount += shardVertices[shard].size();
+    }
+
+    mesh.vertices.reserve(vertexCount);
+    for(auto& vertices : shardVertices) {
+        mesh.vertices.insert(mesh.vertices.end(), vertices.begin(), vertices.end());
+    }
+
+    // Shard-local vertex numbers become indices into the concatenated array.
+    mesh.indices = std::move(cornerVertex);
+    std::size_t i{ 0 };
+    for(const auto& run : runs) {
+        for(const Corner* corner = run.begin; corner != run.end; ++corner, ++i) {
+            mesh.indices[i] += shardBase[static_cast<std::uint32_t>(corner->position) % shards];
+        }
+    }
+}
+
+static void computeSmoothNormals(const std::vector<Chunk>& chunks, ModelData& data) {
+    data.smoothNormals.assign(data.positions.size(), glm::vec3(0.f));
+
+    for(const auto& chunk : chunks) {
+        for(std::size_t i = 0; i + 2 < chunk.corners.size(); i += 3) {
+            const auto a = static_cast<std::size_t>(chunk.corners[i].position);
+            const auto b = static_cast<std::size_t>(chunk.corners[i + 1].position);
+            const auto c = static_cast<std::size_t>(chunk.corners[i + 2].position);
+            // Not normalised, so larger faces weigh more.
+            const glm::vec3 normal = glm::cross(data.positions[b] - data.positions[a], data.positions[c] - data.positions[a]);
+            data.smoothNormals[a] += normal;
+            data.smoothNormals[b] += normal;
+            data.smoothNormals[c] += normal;
+        }
+    }
+
+    for(auto& normal : data.smoothNormals) {
+        const float length = glm::length(normal);
+        normal = length > 0.f ? normal / length : glm::vec3(0.f, 1.f, 0.f);
+    }
+}
+
+bool loadObj(const std::string& path, ObjModel& model, unsigned int threads) {
+    if(threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const AssetFile file(path);
+    if(!file.isOpen()) {
+        return false;
+    }
+
+    // Split at line boundaries into roughly equal chunks.
+    std::vector<Chunk> chunks;
+    {
+        ScopedImportStage stage("OBJ parse");
+
+        const std::size_t chunkCount{ std::clamp<std::size_t>(file.size() / MinChunkBytes, 1, threads) };
+        const std::size_t chunkBytes{ file.size() / chunkCount };
+        const char* p = file.begin();
+        for(std::size_t i = 0; i < chunkCount && p < file.end(); ++i) {
+            Chunk chunk;
+            chunk.begin = p;
+            chunk.end = i + 1 == chunkCount ? file.end() : skipLine(std::min(p + chunkBytes, file.end()), file.end());
+            p = chunk.end;
+            chunks.push_back(std::move(chunk));
+        }
+
+        parallelFor(chunks.size(), threads, [&](const std::size_t i) {
+            parseChunk(chunks[i]);
+        });
+    }
+
+    for(const auto& chunk : chunks) {
+        if(chunk.failed) {
+            std::cerr << "::loadObj:: could not parse " << path << '\n';
+            return false;
+        }
+    }
+
+    {
+        ScopedImportStage stage("MTL parse");
+        const std::string directory = path.substr(0, path.find_last_of('/'));
+        for(const auto& chunk : chunks) {
+            for(const auto& library : chunk.materialLibraries) {
+                loadMaterialLibrary(directory + '/' + library, model.materials);
+            }
+        }
+    }
+
+    ScopedImportStage stage("vertex conversion");
+
+    // Patch relative indices now that every chunk knows how many elements came before it, then gather the elements
+    // into single arrays.
+    ModelData data;
+    // Done in 64 bits; anything that doesn't fit becomes -1 so the range check below rejects it.
+    auto patch = [](std::int32_t& index, const std::size_t base) {
+        const std::int64_t patched{ static_cast<std::int64_t>(index) + static_cast<std::int64_t>(base) };
+        index = patched > INT32_MAX ? -1 : static_cast<std::int32_t>(patched);
+    };
+
+    std::size_t positionBase{ 0 }, textureCoordinatesBase{ 0 }, normalBase{ 0 };
+    for(auto& chunk : chunks) {
+        for(const auto& relative : chunk.relativeIndices) {
+            Corner& corner = chunk.corners[relative.corner];
+            switch(relative.component) {
+            case 0:
+                patch(corner.position, positionBase);
+                break;
+            case 1:
+                patch(corner.textureCoordinates, textureCoordinatesBase);
+                break;
+            default:
+                patch(corner.normal, normalBase);
+                break;
+            }
+        }
+
+        positionBase += chunk.positions.size();
+        textureCoordinatesBase += chunk.textureCoordinates.size();
+        normalBase += chunk.normals.size();
+
+        data.positions.insert(data.positions.end(), chunk.positions.begin(), chunk.positions.end());
+        data.textureCoordinates.insert(data.textureCoordinates.end(), chunk.textureCoordinates.begin(),
+                                       chunk.textureCoordinates.end());
+        data.normals.insert(data.normals.end(), chunk.normals.begin(), chunk.normals.end());
+    }
+
+    auto inRange = [](const std::int32_t index, const std::size_t size) {
+        return index >= 0 && static_cast<std::size_t>(index) < size;
+    };
+
+    bool missingNormals{ false };
+    for(const auto& chunk : chunks) {
+        for(const auto& corner : chunk.corners) {
+            if(!inRange(corner.position, data.positions.size()) ||
+               (corner.textureCoordinates != NoIndex && !inRange(corner.textureCoordinates, data.textureCoordinates.size())) ||
+               (corner.normal != NoIndex && !inRange(corner.normal, data.normals.size()))) {
+                std::cerr << "::loadObj:: face index out of range in " << path << '\n';
+                return false;
+            }
+            missingNormals = missingNormals || corner.normal == NoIndex;
+        }
+    }
+
+    if(missingNormals) {
+        computeSmoothNormals(chunks, data);
+    }
+
+    // Group corner ranges by material, one mesh per material like the faces would be drawn.
+    std::vector<std::string> runMaterials;
+    std::vector<std::vector<CornerRun>> materialRuns;
+    std::string currentMaterial;
+    for(const auto& chunk : chunks) {
+        std::size_t start{ 0 };
+        auto addRun = [&](const std::size_t stop) {
+            if(stop == start) {
+                return;
+            }
+            const auto found = std::find(runMaterials.begin(), runMaterials.end(), currentMaterial);
+            const auto index = static_cast<std::size_t>(found - runMaterials.begin());
+            if(found == runMaterials.end()) {
+                runMaterials.push_back(currentMaterial);
+                materialRuns.emplace_back();
+            }
+            materialRuns[index].push_back(CornerRun{ chunk.corners.data() + start, chunk.corners.data() + stop });
+        };
+
+        for(const auto& materialSwitch : chunk.materialSwitches) {
+            addRun(materialSwitch.corner);
+            start = materialSwitch.corner;
+            currentMaterial = materialSwitch.material;
+        }
+        addRun(chunk.corners.size());
+    }
+
+    model.meshes.resize(materialRuns.size());
+    for(std::size_t i = 0; i < materialRuns.size(); ++i) {
+        buildMesh(materialRuns[i], data, threads, model.meshes[i]);
+
+        for(std::size_t m = 0; m < model.materials.size(); ++m) {
+            if(model.materials[m].name == runMaterials[i]) {
+                model.meshes[i].material = static_cast<int>(m);
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,129 @@
+#include <QuaternionCamera.hpp>
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+QuaternionCamera::QuaternionCamera(const glm::vec3& aPosition, const float aYaw, const float aPitch,
+                                   const float aAspect, const float aNear, const float aFar)
+    :eye(aPosition), yawDegrees(aYaw), pitchDegrees(aPitch), aspect(aAspect), nearPlane(aNear), farPlane(aFar)
+{
+}
+
+void QuaternionCamera::processKeyboard(const CameraMovementOptions direction, const float deltaTime) {
+    const float velocity{ movementSpeed * deltaTime };
+
+    if(direction == CameraMovementOptions::FORWARD) {
+        setPosition(eye + front() * velocity);
+    } else if(direction == CameraMovementOptions::BACKWARD) {
+        setPosition(eye - front() * velocity);
+    } else if(direction == CameraMovementOptions::LEFT) {
+        setPosition(eye - right() * velocity);
+    } else if(direction == CameraMovementOptions::RIGHT) {
+        setPosition(eye + right() * velocity);
+    } else if(direction == CameraMovementOptions::UP) {
+        setPosition(eye + up() * velocity);
+    } else if(direction == CameraMovementOptions::DOWN) {
+        setPosition(eye - up() * velocity);
+    }
+}
+
+void QuaternionCamera::processMouseMovement(const float xOffset, const float yOffset, const bool constrainPitch) {
+    yawDegrees += xOffset * mouseSensitivity;
+    pitchDegrees += yOffset * mouseSensitivity;
+    if(constrainPitch) {
+        pitchDegrees = std::clamp(pitchDegrees, -89.f, 89.f);
+    }
+    dirty |= ORIENTATION | VIEW | VIEW_PROJECTION | FRUSTUM;
+}
+
+void QuaternionCamera::processMouseScroll(const float yOffset) {
+    zoomDegrees = std::clamp(zoomDegrees - yOffset, 1.f, 45.f);
+    dirty |= PROJECTION | VIEW_PROJECTION | FRUSTUM;
+}
+
+void QuaternionCamera::setPosition(const glm::vec3& aPosition) {
+    eye = aPosition;
+    dirty |= VIEW | VIEW_PROJECTION | FRUSTUM;
+}
+
+void QuaternionCamera::setPose(const glm::vec3& aPosition, const float aYaw, const float aPitch, const float aZoom) {
+    eye = aPosition;
+    yawDegrees = aYaw;
+    pitchDegrees = aPitch;
+    zoomDegrees = aZoom;
+    dirty = ALL;
+}
+
+void QuaternionCamera::setAspect(const float aAspect) {
+    aspect = aAspect;
+    dirty |= PROJECTION | VIEW_PROJECTION | FRUSTUM;
+}
+
+const glm::quat& QuaternionCamera::orientation() const {
+    if(dirty & ORIENTATION) {
+        // Yaw about the world's up, then pitch about the camera's own right. The identity looks down -Z, which is
+        // Camera's yaw of -90, and positive yaw turns towards +X like Camera's does.
+        const glm::quat yawRotation{ glm::angleAxis(-glm::radians(yawDegrees + 90.f), glm::vec3(0.f, 1.f, 0.f)) };
+        const glm::quat pitchRotation{ glm::angleAxis(glm::radians(pitchDegrees), glm::vec3(1.f, 0.f, 0.f)) };
+        rotation = glm::normalize(yawRotation * pitchRotation);
+        dirty &= ~ORIENTATION;
+    }
+    return rotation;
+}
+
+glm::vec3 QuaternionCamera::front() const {
+    return orientation() * glm::vec3(0.f, 0.f, -1.f);
+}
+
+glm::vec3 QuaternionCamera::right() const {
+    return orientation() * glm::vec3(1.f, 0.f, 0.f);
+}
+
+glm::vec3 QuaternionCamera::up() const {
+    return orientation() * glm::vec3(0.f, 1.f, 0.f);
+}
+
+const glm::mat4& QuaternionCamera::view() const {
+    if(dirty & VIEW) {
+        // The inverse of the camera's rotation and translation. No lookAt, so no cross products or normalising.
+        viewMatrix = glm::mat4_cast(glm::conjugate(orientation()));
+        viewMatrix[3] = glm::vec4(-(glm::mat3(viewMatrix) * eye), 1.f);
+        dirty &= ~VIEW;
+    }
+    return viewMatrix;
+}
+
+const glm::mat4& QuaternionCamera::projection() const {
+    if(dirty & PROJECTION) {
+        projectionMatrix = glm::perspective(glm::radians(zoomDegrees), aspect, nearPlane, farPlane);
+        dirty &= ~PROJECTION;
+    }
+    return projectionMatrix;
+}
+
+const glm::mat4& QuaternionCamera::viewProjection() const {
+    if(dirty & VIEW_PROJECTION) {
+        viewProjectionMatrix = projection() * view();
+        dirty &= ~VIEW_PROJECTION;
+    }
+    return viewProjectionMatrix;
+}
+
+const Frustum& QuaternionCamera::frustum() const {
+    if(dirty & FRUSTUM) {
+        viewFrustum = extractFrustum(viewProjection());
+        dirty &= ~FRUSTUM;
+    }
+    return viewFrustum;
+}
+
+float QuaternionCamera::projectedSize(const BoundingSphere& sphere, const float viewportHeight) const {
+    const float distance{ glm::length(sphere.centre - eye) };
+    if(distance <= sphere.radius) {
+        return viewportHeight;
+    }
+    return sphere.radius / (distance * std::tan(glm::radians(zoomDegrees) * .5f)) * viewportHeight;
+}
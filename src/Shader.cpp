@@ -1,11 +1,28 @@
 #include <Shader.hpp>
+#include <GLExtensions.hpp>
 #include <glad/glad.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <array>
 
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
+// GLSL wants #version before anything else, defines go on the line after it.
+static std::string withDefines(const std::string& source, const ShaderDefines& defines) {
+    if(defines.lines.empty()) {
+        return source;
+    }
+    const std::size_t versionEnd{ source.rfind("#version", 0) == 0 ? source.find('\n') : std::string::npos };
+    if(versionEnd == std::string::npos) {
+        return defines.lines + source;
+    }
+    return source.substr(0, versionEnd + 1) + defines.lines + source.substr(versionEnd + 1);
+}
+
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+    :Shader(vertexPath, fragmentPath, ShaderDefines{})
+{}
+
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines) {
     // Read file contents.
     std::ifstream vertexStreamFile(vertexPath);
     if(!vertexStreamFile.is_open()) {
@@ -20,12 +37,12 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
     std::stringstream vertexSStream;
     std::string vertexSourceCode;
     vertexSStream << vertexStreamFile.rdbuf();
-    vertexSourceCode = vertexSStream.str();
+    vertexSourceCode = withDefines(vertexSStream.str(), defines);
 
     std::stringstream fragmentSStream;
     std::string fragmentSourceCode;
     fragmentSStream << fragmentStreamFile.rdbuf();
-    fragmentSourceCode = fragmentSStream.str();
+    fragmentSourceCode = withDefines(fragmentSStream.str(), defines);
 
     const char* vertexSourceCodeC = vertexSourceCode.c_str();
     const char* fragmentSourceCodeC = fragmentSourceCode.c_str();
@@ -149,6 +166,41 @@ Shader::Shader(const std::string& vertexPath, const std::string& geometryPath, c
     glDeleteShader(geometry);
 }
 
+Shader::Shader(const std::string& computePath, const ShaderDefines& defines) {
+    std::ifstream computeStreamFile(computePath);
+    if(!computeStreamFile.is_open()) {
+        std::cerr << "Could not open compute source code. Path: " << computePath << '\n';
+    }
+
+    std::stringstream computeSStream;
+    computeSStream << computeStreamFile.rdbuf();
+    const std::string computeSourceCode{ withDefines(computeSStream.str(), defines) };
+    const char* computeSourceCodeC = computeSourceCode.c_str();
+
+    int success;
+    std::array<char, 512> log;
+
+    unsigned int compute = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(compute, 1, &computeSourceCodeC, nullptr);
+    glCompileShader(compute);
+    glGetShaderiv(compute, GL_COMPILE_STATUS, &success);
+    if(!success) {
+        glGetShaderInfoLog(compute, log.size(), nullptr, &log[0]);
+        std::cerr << "Could not compile compute shader: " << &log[0] << '\n';
+    }
+
+    id = glCreateProgram();
+    glAttachShader(id, compute);
+    glLinkProgram(id);
+    glGetProgramiv(id, GL_LINK_STATUS, &success);
+    if(!success) {
+        glGetProgramInfoLog(id, log.size(), nullptr, &log[0]);
+        std::cerr << "Could not link compute shader: " << &log[0] << '\n';
+    }
+
+    glDeleteShader(compute);
+}
+
 
 void Shader::use() {
     glUseProgram(id);
@@ -181,3 +233,14 @@ void Shader::setVec3(const std::string &name, const glm::vec3 &val) const {
 void Shader::setVec2(const std::string& name, const glm::vec2& val) const {
     glUniform2fv(glGetUniformLocation(id, name.c_str()), 1, &val[0]);
 }
+
+void Shader::setVec4(const std::string& name, const glm::vec4& val) const {
+    glUniform4fv(glGetUniformLocation(id, name.c_str()), 1, &val[0]);
+}
+
+void Shader::bindUniformBlock(const std::string& name, const unsigned int binding) const {
+    const unsigned int index{ glGetUniformBlockIndex(id, name.c_str()) };
+    if(index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(id, index, binding);
+    }
+}
@@ -0,0 +1,697 @@
+#include <TextureLoader.hpp>
+#include <AssetPack.hpp>
+#include <ImportProfiler.hpp>
+#include <ThreadPool.hpp>
+#include <BlockCompression.hpp>
+#include <GLExtensions.hpp>
+#include <MipChain.hpp>
+#include <TextureStreamer.hpp>
+#include <TextureManager.hpp>
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <optional>
+
+// Bump whenever the encoder or mip filter output changes, cached files written by another version are encoded again.
+static constexpr const char* EncoderVersion{ "BlockCompression 2" };
+
+TextureUsage inferTextureUsage(const std::string& path) {
+    std::string name{ std::filesystem::path(path).stem().string() };
+    std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    if(name.find("normal") != std::string::npos) {
+        return TextureUsage::NORMAL;
+    }
+    for(const char* mask : { "spec", "disp", "rough" }) {
+        if(name.find(mask) != std::string::npos) {
+            return TextureUsage::MASK;
+        }
+    }
+    if(name == "ao" || name.ends_with("_ao")) {
+        return TextureUsage::MASK;
+    }
+    return TextureUsage::COLOUR;
+}
+
+bool decodeImage(const std::string& path, DecodedImage& image) {
+    image.path = path;
+
+    std::span<const char> bytes;
+    if(findAsset(path, bytes)) {
+        image.pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(bytes.data()),
+                                             static_cast<int>(bytes.size()), &image.width, &image.height,
+                                             &image.components, 0);
+    } else {
+        image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.components, 0);
+    }
+
+    if(!image.pixels) {
+        std::cerr << "::stbi_load:: ERROR LOADING TEXTURE, path -> " << path << '\n';
+        return false;
+    }
+    return true;
+}
+
+void freeImage(DecodedImage& image) {
+    stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+}
+
+// Single channel textures are spread to grey so shaders reading .rgb see the mask, not a red tint. The swizzle belongs
+// to the texture, everything else to the sampler.
+static void finishTexture(const unsigned int textureID, const std::size_t bytes, const bool singleChannel,
+                          const TextureSampler sampler) {
+    if(singleChannel) {
+        const GLint swizzle[]{ GL_RED, GL_RED, GL_RED, GL_ONE };
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+    manageTexture(textureID, GL_TEXTURE_2D, bytes, sampler);
+}
+
+static std::size_t levelBytes(const KtxTexture& texture, const std::size_t firstLevel) {
+    std::size_t bytes{ 0 };
+    for(std::size_t level = firstLevel; level < texture.levels.size(); ++level) {
+        bytes += texture.levels[level].size();
+    }
+    return bytes;
+}
+
+unsigned int uploadTexture(const DecodedImage& image, const bool gammaCorrection, const TextureSampler sampler) {
+    unsigned int textureID{ 0 };
+    glGenTextures(1, &textureID);
+
+    // Drivers keep RGB with a padding byte, so three components count as four.
+    GLenum format{ GL_RGB };
+    GLenum internalFormat{ GL_RGB8 };
+    std::size_t texelBytes{ 4 };
+    if(image.components == 1) {
+        format = GL_RED;
+        internalFormat = GL_R8;
+        texelBytes = 1;
+    } else if(image.components == 3) {
+        internalFormat = gammaCorrection ? GL_SRGB8 : GL_RGB8;
+        format = GL_RGB;
+    } else if(image.components == 4) {
+        internalFormat = gammaCorrection ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        format = GL_RGBA;
+    }
+
+    const int levels{ static_cast<int>(std::bit_width(static_cast<unsigned int>(std::max(image.width, image.height)))) };
+    std::size_t bytes{ 0 };
+    for(int level = 0; level < levels; ++level) {
+        bytes += static_cast<std::size_t>(std::max(1, image.width >> level)) *
+                 static_cast<std::size_t>(std::max(1, image.height >> level)) * texelBytes;
+    }
+
+    // GL calls return before the driver is done with them, so when profiling we wait for it to get honest numbers.
+    {
+        ScopedImportStage stage("GL upload");
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        // Images that failed to decode keep an empty texture, immutable storage can't be zero sized.
+        if(texStorage2D && image.pixels) {
+            texStorage2D(GL_TEXTURE_2D, levels, internalFormat, image.width, image.height);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width, image.height, format, GL_UNSIGNED_BYTE, image.pixels);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), image.width, image.height, 0, format,
+                         GL_UNSIGNED_BYTE, image.pixels);
+        }
+        if(activeImportProfile()) {
+            glFinish();
+        }
+    }
+    {
+        ScopedImportStage stage("mip generation");
+        glGenerateMipmap(GL_TEXTURE_2D);
+        if(activeImportProfile()) {
+            glFinish();
+        }
+    }
+
+    finishTexture(textureID, image.pixels ? bytes : 0, format == GL_RED, sampler);
+
+    return textureID;
+}
+
+// Everything the cached levels depend on besides the image: the format picked, and whether colour was filtered as sRGB.
+static std::string encoderTag(const TextureUsage usage, const bool gammaCorrection, const bool s3tcSupported) {
+    return std::string(EncoderVersion) + " usage " + std::to_string(static_cast<int>(usage)) + " gamma " +
+           std::to_string(gammaCorrection) + " s3tc " + std::to_string(s3tcSupported);
+}
+
+static std::vector<unsigned char> expandToRgba(const DecodedImage& image) {
+    const std::size_t texels{ static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height) };
+    const auto components = static_cast<std::size_t>(image.components);
+    std::vector<unsigned char> rgba(texels * 4);
+    for(std::size_t i = 0; i < texels; ++i) {
+        const unsigned char* source = image.pixels + i * components;
+        unsigned char* target = rgba.data() + i * 4;
+        if(components < 3) {
+            target[0] = target[1] = target[2] = source[0];
+            target[3] = components == 2 ? source[1] : 255;
+        } else {
+            std::copy(source, source + 3, target);
+            target[3] = components == 4 ? source[3] : 255;
+        }
+    }
+    return rgba;
+}
+
+// JPEG leaves a little chroma noise on grey images, a couple of steps between channels still counts as grey.
+static bool isGreyAndOpaque(const std::vector<unsigned char>& rgba) {
+    for(std::size_t i = 0; i < rgba.size(); i += 4) {
+        if(std::abs(rgba[i] - rgba[i + 1]) > 2 || std::abs(rgba[i + 1] - rgba[i + 2]) > 2 || rgba[i + 3] != 255) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool hasTransparency(const std::vector<unsigned char>& rgba) {
+    for(std::size_t i = 3; i < rgba.size(); i += 4) {
+        if(rgba[i] != 255) {
+            return true;
+        }
+    }
+    return false;
+}
+
+KtxTexture prepareTexture(const DecodedImage& image, const TextureUsage usage, const bool gammaCorrection,
+                          const bool s3tcSupported) {
+    KtxTexture texture;
+    if(!image.pixels) {
+        return texture;
+    }
+
+    MipLevel base{ .width = image.width, .height = image.height, .rgba = expandToRgba(image) };
+
+    // Formats without an sRGB variant are sampled as they are, so only the others get their colour filtered as sRGB.
+    std::optional<BlockFormat> format;
+    bool srgb{ gammaCorrection };
+    if(usage == TextureUsage::NORMAL) {
+        format = BlockFormat::BC5;
+        texture.internalFormat = GL_COMPRESSED_RG_RGTC2;
+        texture.baseInternalFormat = GL_RG;
+        srgb = false;
+    } else if(usage == TextureUsage::MASK && isGreyAndOpaque(base.rgba)) {
+        format = BlockFormat::BC4;
+        texture.internalFormat = GL_COMPRESSED_RED_RGTC1;
+        texture.baseInternalFormat = GL_RED;
+        srgb = false;
+    } else if(!s3tcSupported) {
+        texture.glType = GL_UNSIGNED_BYTE;
+        texture.glFormat = GL_RGBA;
+        texture.internalFormat = GL_RGBA8;
+        texture.baseInternalFormat = GL_RGBA;
+    } else if(hasTransparency(base.rgba)) {
+        format = BlockFormat::BC3;
+        texture.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        texture.baseInternalFormat = GL_RGBA;
+    } else {
+        format = BlockFormat::BC1;
+        texture.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        texture.baseInternalFormat = GL_RGB;
+    }
+
+    const MipOptions options{ .srgb = srgb, .preserveAlphaCoverage = isAlphaTested(base.rgba) };
+
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.encoder = encoderTag(usage, gammaCorrection, s3tcSupported);
+    std::vector<MipLevel> levels;
+    {
+        ScopedImportStage stage("mip generation");
+        levels = generateMipChain(std::move(base), options);
+    }
+    ScopedImportStage stage("block compression");
+    for(auto& level : levels) {
+        if(format) {
+            texture.levels.push_back(compressBlocks(level.rgba.data(), level.width, level.height, *format));
+        } else {
+            texture.levels.push_back(std::move(level.rgba));
+        }
+    }
+
+    return texture;
+}
+
+GLenum sizedInternalFormat(const KtxTexture& texture, const bool gammaCorrection) {
+    switch(texture.internalFormat) {
+    case GL_RGBA8:
+        return gammaCorrection ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        return gammaCorrection ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return gammaCorrection ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    default:
+        return texture.internalFormat;
+    }
+}
+
+unsigned int uploadPreparedTexture(const KtxTexture& texture, const bool gammaCorrection, const TextureSampler sampler) {
+    unsigned int textureID{ 0 };
+    glGenTextures(1, &textureID);
+
+    const GLenum internalFormat{ sizedInternalFormat(texture, gammaCorrection) };
+    const bool compressed{ texture.glType == 0 };
+
+    {
+        ScopedImportStage stage("GL upload");
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        // Immutable storage lets the driver allocate the whole chain once and skip completeness checks on every level.
+        if(texStorage2D) {
+            texStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(texture.levels.size()), internalFormat, texture.width,
+                         texture.height);
+        }
+        for(std::size_t level = 0; level < texture.levels.size(); ++level) {
+            const int width{ std::max(1, texture.width >> level) };
+            const int height{ std::max(1, texture.height >> level) };
+            const auto size = static_cast<GLsizei>(texture.levels[level].size());
+            const unsigned char* data = texture.levels[level].data();
+            if(texStorage2D && compressed) {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, width, height, internalFormat,
+                                          size, data);
+            } else if(texStorage2D) {
+                glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, width, height, texture.glFormat,
+                                texture.glType, data);
+            } else {
+                uploadTextureLevel(texture, level, gammaCorrection);
+            }
+        }
+        if(activeImportProfile()) {
+            glFinish();
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size()) - 1);
+    finishTexture(textureID, levelBytes(texture, 0), texture.baseInternalFormat == GL_RED, sampler);
+
+    return textureID;
+}
+
+void uploadTextureLevel(const KtxTexture& texture, const std::size_t level, const bool gammaCorrection) {
+    const GLenum internalFormat{ sizedInternalFormat(texture, gammaCorrection) };
+    const int width{ std::max(1, texture.width >> level) };
+    const int height{ std::max(1, texture.height >> level) };
+    const auto& data = texture.levels[level];
+    if(texture.glType == 0) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internalFormat, width, height, 0,
+                               static_cast<GLsizei>(data.size()), data.data());
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalFormat), width, height, 0,
+                     texture.glFormat, texture.glType, data.data());
+    }
+}
+
+// A zero sized image is the only way to hand a level of a mutable texture back to the driver.
+void releaseTextureLevel(const KtxTexture& texture, const std::size_t level, const bool gammaCorrection) {
+    const GLenum internalFormat{ sizedInternalFormat(texture, gammaCorrection) };
+    if(texture.glType == 0) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internalFormat, 0, 0, 0, 0, nullptr);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalFormat), 0, 0, 0,
+                     texture.glFormat, texture.glType, nullptr);
+    }
+}
+
+TextureUpload allocateTextureLevel(const unsigned int textureId, KtxTexture& texture, const std::size_t level,
+                                   const bool gammaCorrection) {
+    TextureUpload upload{
+        .texture = textureId,
+        .target = GL_TEXTURE_2D,
+        .level = static_cast<int>(level),
+        .width = std::max(1, texture.width >> level),
+        .height = std::max(1, texture.height >> level),
+        .format = texture.glType == 0 ? sizedInternalFormat(texture, gammaCorrection) : texture.glFormat,
+        .type = texture.glType,
+        .data = std::move(texture.levels[level]),
+        .onIssued = {},
+    };
+
+    // Compressed levels take their size even without data.
+    const GLenum internalFormat{ sizedInternalFormat(texture, gammaCorrection) };
+    if(texture.glType == 0) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, upload.level, internalFormat, upload.width, upload.height, 0,
+                               static_cast<GLsizei>(upload.data.size()), nullptr);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, upload.level, static_cast<GLint>(internalFormat), upload.width, upload.height, 0,
+                     texture.glFormat, texture.glType, nullptr);
+    }
+    texture.levels[level] = {};
+
+    return upload;
+}
+
+unsigned int uploadMutableTexture(const KtxTexture& texture, const std::size_t firstLevel, const bool gammaCorrection,
+                                  const TextureSampler sampler) {
+    unsigned int textureID{ 0 };
+    glGenTextures(1, &textureID);
+
+    {
+        ScopedImportStage stage("GL upload");
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        for(std::size_t level = firstLevel; level < texture.levels.size(); ++level) {
+            uploadTextureLevel(texture, level, gammaCorrection);
+        }
+        if(activeImportProfile()) {
+            glFinish();
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(firstLevel));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size()) - 1);
+    finishTexture(textureID, levelBytes(texture, firstLevel), texture.baseInternalFormat == GL_RED, sampler);
+
+    return textureID;
+}
+
+std::string textureCachePath(const std::string& path) {
+    return (std::filesystem::path("cache") / std::filesystem::path(normaliseAssetPath(path)).relative_path()).string() +
+           ".ktx";
+}
+
+// Only a loose source can be newer than its cache, a packed one is taken as built together with it.
+static bool cacheIsCurrent(const std::string& path, const std::string& cachePath) {
+    std::error_code error;
+    const auto cacheTime = std::filesystem::last_write_time(cachePath, error);
+    if(error) {
+        std::span<const char> bytes;
+        return findAsset(cachePath, bytes);
+    }
+
+    const auto sourceTime = std::filesystem::last_write_time(path, error);
+    return error || sourceTime <= cacheTime;
+}
+
+// Runs on a worker: the cached mip chain when there is a current one, otherwise decode, filter, compress and cache.
+// A streamed texture only keeps levels up to StreamedResidentSize, once the cache holds the rest.
+static void loadForUpload(const std::string& path, const TextureUsage usage, const bool gammaCorrection,
+                          const bool s3tcSupported, const bool streamed, DecodedImage& image, KtxTexture& prepared) {
+    const std::string cachePath{ textureCachePath(path) };
+    if(cacheIsCurrent(path, cachePath) && readKtx(cachePath, prepared, streamed ? StreamedResidentSize : 0) &&
+       prepared.encoder == encoderTag(usage, gammaCorrection, s3tcSupported)) {
+        return;
+    }
+    prepared = {};
+
+    if(!decodeImage(path, image)) {
+        return;
+    }
+
+    prepared = prepareTexture(image, usage, gammaCorrection, s3tcSupported);
+    freeImage(image);
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    if(writeKtx(cachePath, prepared) && streamed) {
+        for(std::size_t level = 0; level < prepared.levels.size(); ++level) {
+            if(std::max(prepared.width >> level, prepared.height >> level) > StreamedResidentSize) {
+                prepared.levels[level] = {};
+            }
+        }
+    }
+}
+
+// sRGB S3TC formats come with EXT_texture_sRGB. Has to be asked on the context thread.
+static bool s3tcSupportedFor(const bool gammaCorrection) {
+    return hasGLExtension("GL_EXT_texture_compression_s3tc") &&
+           (!gammaCorrection || hasGLExtension("GL_EXT_texture_sRGB") ||
+            hasGLExtension("GL_EXT_texture_compression_s3tc_srgb"));
+}
+
+TextureBatch::~TextureBatch() {
+    // Workers hold pointers into entries, they have to be done before it goes away.
+    waitForDecodes();
+    for(auto& entry : entries) {
+        freeImage(entry.image);
+    }
+}
+
+std::size_t TextureBatch::add(const std::string& path, const bool gammaCorrection) {
+    return add(path, gammaCorrection, inferTextureUsage(path));
+}
+
+std::size_t TextureBatch::add(const std::string& path, const bool gammaCorrection, const TextureUsage usage,
+                              const TextureSampler sampler) {
+    Entry& entry = entries.emplace_back();
+    entry.image.path = path;
+    entry.usage = usage;
+    entry.sampler = sampler;
+    entry.gammaCorrection = gammaCorrection;
+    entry.streamed = activeTextureStreamer() != nullptr;
+    // Extensions can only be queried here on the context thread.
+    entry.s3tcSupported = s3tcSupportedFor(gammaCorrection);
+    {
+        const std::lock_guard lock(mutex);
+        ++remaining;
+    }
+
+    Entry* decoding{ &entry };
+    workerPool().submit([this, decoding]() {
+        loadForUpload(decoding->image.path, decoding->usage, decoding->gammaCorrection, decoding->s3tcSupported,
+                      decoding->streamed, decoding->image, decoding->prepared);
+
+        const std::lock_guard lock(mutex);
+        decoding->decoded = true;
+        --remaining;
+        imageDecoded.notify_all();
+    });
+
+    return entries.size() - 1;
+}
+
+std::vector<unsigned int> TextureBatch::upload() {
+    std::vector<unsigned int> ids(entries.size(), 0);
+    std::vector<bool> uploaded(entries.size(), false);
+
+    for(std::size_t done = 0; done < entries.size(); ++done) {
+        // Decodes run on the pool, so in a profile this stage is how long the context thread sat waiting for them.
+        std::size_t next{ 0 };
+        {
+            ScopedImportStage stage("image decode");
+            std::unique_lock lock(mutex);
+            imageDecoded.wait(lock, [&]() {
+                for(next = 0; next < entries.size(); ++next) {
+                    if(entries[next].decoded && !uploaded[next]) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+
+            const DecodedImage& image = entries[next].image;
+            stage.addBytes(static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height) *
+                           static_cast<std::size_t>(image.components));
+        }
+
+        Entry& entry = entries[next];
+        if(entry.streamed && !entry.prepared.levels.empty() && activeTextureStreamer()) {
+            ids[next] = activeTextureStreamer()->add(std::move(entry.prepared), textureCachePath(entry.image.path),
+                                                     entry.gammaCorrection, entry.sampler);
+        } else if(!entry.prepared.levels.empty()) {
+            ids[next] = uploadPreparedTexture(entry.prepared, entry.gammaCorrection, entry.sampler);
+        } else {
+            ids[next] = uploadTexture(entry.image, entry.gammaCorrection, entry.sampler);
+        }
+        freeImage(entry.image);
+        entry.prepared = {};
+        uploaded[next] = true;
+    }
+    entries.clear();
+
+    return ids;
+}
+
+void TextureBatch::waitForDecodes() {
+    std::unique_lock lock(mutex);
+    imageDecoded.wait(lock, [this]() { return remaining == 0; });
+}
+
+unsigned int loadTexture(const std::string& path, const bool gammaCorrection) {
+    TextureBatch batch;
+    batch.add(path, gammaCorrection);
+    return batch.upload().front();
+}
+
+std::string cubemapCachePath(const CubemapFaces& faces) {
+    return textureCachePath(std::filesystem::path(faces.front()).parent_path().string());
+}
+
+static std::string cubemapEncoderTag(const bool gammaCorrection, const bool s3tcSupported) {
+    return encoderTag(TextureUsage::COLOUR, gammaCorrection, s3tcSupported) + " cube";
+}
+
+// Runs task(0) to task(count - 1) on the worker pool and waits for those, not for whatever else is queued there.
+static void runOnWorkers(const std::size_t count, const std::function<void(std::size_t)>& task) {
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t remaining{ count };
+    for(std::size_t i = 0; i < count; ++i) {
+        workerPool().submit([&, i]() {
+            task(i);
+            const std::lock_guard lock(mutex);
+            --remaining;
+            finished.notify_all();
+        });
+    }
+
+    std::unique_lock lock(mutex);
+    finished.wait(lock, [&]() { return remaining == 0; });
+}
+
+KtxTexture prepareCubemap(const CubemapFaces& faces, const bool gammaCorrection, const bool s3tcSupported) {
+    std::array<DecodedImage, 6> images;
+    std::array<bool, 6> decoded{};
+    runOnWorkers(faces.size(), [&](const std::size_t face) {
+        decoded[face] = decodeImage(faces[face], images[face]);
+    });
+
+    KtxTexture texture;
+    CubeLevel base;
+    bool complete{ true };
+    for(std::size_t face = 0; face < faces.size(); ++face) {
+        if(!decoded[face]) {
+            complete = false;
+        } else if(images[face].width != images[face].height || images[face].width != images.front().width) {
+            std::cerr << "::prepareCubemap:: faces must be square and the same size, path -> " << faces[face] << '\n';
+            complete = false;
+        } else {
+            base[face] = { .width = images[face].width, .height = images[face].height,
+                           .rgba = expandToRgba(images[face]) };
+        }
+        freeImage(images[face]);
+    }
+    if(!complete) {
+        return texture;
+    }
+
+    std::optional<BlockFormat> format;
+    if(!s3tcSupported) {
+        texture.glType = GL_UNSIGNED_BYTE;
+        texture.glFormat = GL_RGBA;
+        texture.internalFormat = GL_RGBA8;
+        texture.baseInternalFormat = GL_RGBA;
+    } else if(std::any_of(base.begin(), base.end(), [](const MipLevel& face) { return hasTransparency(face.rgba); })) {
+        format = BlockFormat::BC3;
+        texture.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        texture.baseInternalFormat = GL_RGBA;
+    } else {
+        format = BlockFormat::BC1;
+        texture.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        texture.baseInternalFormat = GL_RGB;
+    }
+
+    // Every level reads all six faces of the one above, so levels go one at a time and only their faces in parallel.
+    std::vector<CubeLevel> levels;
+    levels.push_back(std::move(base));
+    while(levels.back().front().width > 1) {
+        CubeLevel next;
+        const CubeLevel& source = levels.back();
+        runOnWorkers(next.size(), [&](const std::size_t face) {
+            next[face] = downsampleCubeFace(source, face, gammaCorrection);
+        });
+        levels.push_back(std::move(next));
+    }
+
+    std::array<std::vector<std::vector<unsigned char>>, 6> encoded;
+    runOnWorkers(encoded.size(), [&](const std::size_t face) {
+        for(auto& level : levels) {
+            MipLevel& image = level[face];
+            if(format) {
+                encoded[face].push_back(compressBlocks(image.rgba.data(), image.width, image.height, *format));
+            } else {
+                encoded[face].push_back(std::move(image.rgba));
+            }
+        }
+    });
+
+    texture.width = levels.front().front().width;
+    texture.height = texture.width;
+    texture.faces = static_cast<int>(faces.size());
+    texture.encoder = cubemapEncoderTag(gammaCorrection, s3tcSupported);
+    for(std::size_t level = 0; level < levels.size(); ++level) {
+        auto& data = texture.levels.emplace_back();
+        for(const auto& face : encoded) {
+            data.insert(data.end(), face[level].begin(), face[level].end());
+        }
+    }
+
+    return texture;
+}
+
+unsigned int uploadPreparedCubemap(const KtxTexture& texture, const bool gammaCorrection) {
+    unsigned int textureID{ 0 };
+    glGenTextures(1, &textureID);
+
+    const GLenum internalFormat{ sizedInternalFormat(texture, gammaCorrection) };
+    const bool compressed{ texture.glType == 0 };
+
+    {
+        ScopedImportStage stage("GL upload");
+        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        if(texStorage2D) {
+            texStorage2D(GL_TEXTURE_CUBE_MAP, static_cast<GLsizei>(texture.levels.size()), internalFormat, texture.width,
+                         texture.height);
+        }
+        for(std::size_t level = 0; level < texture.levels.size(); ++level) {
+            const int size{ std::max(1, texture.width >> level) };
+            const std::size_t faceSize{ texture.levels[level].size() / static_cast<std::size_t>(texture.faces) };
+            for(std::size_t face = 0; face < static_cast<std::size_t>(texture.faces); ++face) {
+                const auto target = static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face);
+                const auto mip = static_cast<GLint>(level);
+                const unsigned char* data = texture.levels[level].data() + face * faceSize;
+                if(texStorage2D && compressed) {
+                    glCompressedTexSubImage2D(target, mip, 0, 0, size, size, internalFormat,
+                                              static_cast<GLsizei>(faceSize), data);
+                } else if(compressed) {
+                    glCompressedTexImage2D(target, mip, internalFormat, size, size, 0, static_cast<GLsizei>(faceSize),
+                                           data);
+                } else if(texStorage2D) {
+                    glTexSubImage2D(target, mip, 0, 0, size, size, texture.glFormat, texture.glType, data);
+                } else {
+                    glTexImage2D(target, mip, static_cast<GLint>(internalFormat), size, size, 0, texture.glFormat,
+                                 texture.glType, data);
+                }
+            }
+        }
+        if(activeImportProfile()) {
+            glFinish();
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size()) - 1);
+    manageTexture(textureID, GL_TEXTURE_CUBE_MAP, levelBytes(texture, 0), TextureSampler::CUBE_MAP);
+
+    return textureID;
+}
+
+unsigned int loadCubemap(const CubemapFaces& faces, const bool gammaCorrection) {
+    const bool s3tcSupported{ s3tcSupportedFor(gammaCorrection) };
+    const std::string cachePath{ cubemapCachePath(faces) };
+    const bool current{ std::all_of(faces.begin(), faces.end(), [&](const std::string& face) {
+        return cacheIsCurrent(face, cachePath);
+    }) };
+
+    KtxTexture texture;
+    if(!current || !readKtx(cachePath, texture) || texture.faces != static_cast<int>(faces.size()) ||
+       texture.encoder != cubemapEncoderTag(gammaCorrection, s3tcSupported)) {
+        texture = prepareCubemap(faces, gammaCorrection, s3tcSupported);
+        if(texture.levels.empty()) {
+            return 0;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+        static_cast<void>(writeKtx(cachePath, texture));
+    }
+
+    return uploadPreparedCubemap(texture, gammaCorrection);
+}
@@ -0,0 +1,178 @@
+#include <TextureManager.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+static TextureManager* manager{ nullptr };
+
+void setTextureManager(TextureManager* textureManager) {
+    manager = textureManager;
+}
+
+TextureManager* activeTextureManager() {
+    return manager;
+}
+
+struct SamplerParameters {
+    GLint wrap;
+    GLint minFilter;
+};
+
+static SamplerParameters samplerParameters(const TextureSampler sampler) {
+    switch(sampler) {
+    case TextureSampler::CLAMP_TO_EDGE:
+        return { GL_CLAMP_TO_EDGE, GL_LINEAR };
+    case TextureSampler::CUBE_MAP:
+        return { GL_CLAMP_TO_EDGE, GL_LINEAR_MIPMAP_LINEAR };
+    case TextureSampler::REPEAT:
+    default:
+        return { GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR };
+    }
+}
+
+TextureManager::TextureManager() {
+    glGenSamplers(static_cast<GLsizei>(samplers.size()), samplers.data());
+    for(std::size_t i = 0; i < samplers.size(); ++i) {
+        const SamplerParameters parameters{ samplerParameters(static_cast<TextureSampler>(i)) };
+        glSamplerParameteri(samplers[i], GL_TEXTURE_WRAP_S, parameters.wrap);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_WRAP_T, parameters.wrap);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_WRAP_R, parameters.wrap);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+}
+
+TextureManager::~TextureManager() {
+    for(const auto& [texture, entry] : textures) {
+        glDeleteTextures(1, &texture);
+    }
+    glDeleteSamplers(static_cast<GLsizei>(samplers.size()), samplers.data());
+}
+
+void TextureManager::track(const unsigned int texture, const std::size_t bytes, const TextureSampler sampler) {
+    auto& entry = textures[texture];
+    setGpuBytes(memory.gpuBytes - entry.bytes + bytes);
+    entry = { .bytes = bytes, .sampler = sampler, .lastUsedFrame = 0 };
+}
+
+void TextureManager::setBytes(const unsigned int texture, const std::size_t bytes) {
+    const auto found = textures.find(texture);
+    if(found == textures.end()) {
+        return;
+    }
+    setGpuBytes(memory.gpuBytes - found->second.bytes + bytes);
+    found->second.bytes = bytes;
+}
+
+void TextureManager::release(const unsigned int texture) {
+    const auto found = textures.find(texture);
+    if(found != textures.end()) {
+        setGpuBytes(memory.gpuBytes - found->second.bytes);
+        textures.erase(found);
+    }
+    glDeleteTextures(1, &texture);
+}
+
+unsigned int TextureManager::use(const unsigned int texture) {
+    const auto found = textures.find(texture);
+    if(found == textures.end()) {
+        return 0;
+    }
+    found->second.lastUsedFrame = frameNumber;
+    return samplers[static_cast<std::size_t>(found->second.sampler)];
+}
+
+void TextureManager::nextFrame() {
+    ++frameNumber;
+}
+
+void TextureManager::setBudget(const std::size_t gpuBytes, const std::size_t cpuBytes) {
+    gpuLimit = gpuBytes;
+    cpuLimit = cpuBytes;
+}
+
+void TextureManager::setCpuBytes(const std::size_t bytes) {
+    memory.cpuBytes = bytes;
+    memory.peakCpuBytes = std::max(memory.peakCpuBytes, bytes);
+}
+
+void TextureManager::recordEviction(const std::size_t bytes, const std::size_t levels, const bool wholeTexture) {
+    memory.evictedBytes += bytes;
+    memory.evictedLevels += levels;
+    memory.evictedTextures += wholeTexture ? 1 : 0;
+}
+
+unsigned int TextureManager::samplerFor(const unsigned int texture) const {
+    const auto found = textures.find(texture);
+    return found == textures.end() ? 0 : samplers[static_cast<std::size_t>(found->second.sampler)];
+}
+
+std::size_t TextureManager::textureBytes(const unsigned int texture) const {
+    const auto found = textures.find(texture);
+    return found == textures.end() ? 0 : found->second.bytes;
+}
+
+std::size_t TextureManager::totalBytes() const {
+    return memory.gpuBytes;
+}
+
+std::size_t TextureManager::textureCount() const {
+    return textures.size();
+}
+
+std::uint64_t TextureManager::frame() const {
+    return frameNumber;
+}
+
+std::uint64_t TextureManager::lastUsedFrame(const unsigned int texture) const {
+    const auto found = textures.find(texture);
+    return found == textures.end() ? 0 : found->second.lastUsedFrame;
+}
+
+std::size_t TextureManager::gpuBudget() const {
+    return gpuLimit;
+}
+
+std::size_t TextureManager::cpuBudget() const {
+    return cpuLimit;
+}
+
+const TextureMemoryStats& TextureManager::stats() const {
+    return memory;
+}
+
+void TextureManager::setGpuBytes(const std::size_t bytes) {
+    memory.gpuBytes = bytes;
+    memory.peakGpuBytes = std::max(memory.peakGpuBytes, bytes);
+}
+
+void manageTexture(const unsigned int texture, const unsigned int target, const std::size_t bytes,
+                   const TextureSampler sampler) {
+    if(manager) {
+        manager->track(texture, bytes, sampler);
+        return;
+    }
+
+    const SamplerParameters parameters{ samplerParameters(sampler) };
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, parameters.wrap);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, parameters.wrap);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void bindTexture(const unsigned int unit, const unsigned int target, const unsigned int texture) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(target, texture);
+    if(manager) {
+        glBindSampler(unit, manager->use(texture));
+    }
+}
+
+void releaseTexture(const unsigned int texture) {
+    if(manager) {
+        manager->release(texture);
+    } else {
+        glDeleteTextures(1, &texture);
+    }
+}
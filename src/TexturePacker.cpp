@@ -0,0 +1,292 @@
+#include <TexturePacker.hpp>
+#include <GLExtensions.hpp>
+#include <TextureLoader.hpp>
+#include <TextureManager.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <tuple>
+
+// Power of two textures up to this size that share their size with nothing else go into atlas pages.
+static constexpr int AtlasMaxTile{ 256 };
+static constexpr int AtlasMaxPage{ 2048 };
+// Every level kept on a page doubles the gutter each rectangle needs at the top level.
+static constexpr int AtlasMaxLevels{ 4 };
+
+// Textures can share an array when everything its storage and uploads are given matches. internalFormat is the sized
+// one the array is allocated with, so gamma corrected textures never share with linear ones.
+using ArrayKey = std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, int, int, std::size_t>;
+
+static ArrayKey arrayKey(const KtxTexture& texture, const unsigned int internalFormat) {
+    return { texture.glType, texture.glFormat, internalFormat, texture.baseInternalFormat, texture.width,
+             texture.height, texture.levels.size() };
+}
+
+struct Layer {
+    const KtxTexture* texture;
+    // Inputs sampled from this layer and their UV transforms, one for a plain layer, one per rectangle for a page.
+    std::vector<std::pair<std::size_t, glm::vec4>> users;
+};
+
+// Texels along the side of a block and its size in bytes. Only RGBA8 is stored uncompressed, everything else is one
+// of the block formats prepareTexture picks.
+struct BlockLayout {
+    int dimension;
+    std::size_t bytes;
+};
+
+static BlockLayout blockLayout(const KtxTexture& texture) {
+    if(texture.glType != 0) {
+        return { 1, 4 };
+    }
+    const bool halfBlocks{ texture.internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ||
+                           texture.internalFormat == GL_COMPRESSED_RED_RGTC1 };
+    return { 4, halfBlocks ? std::size_t{ 8 } : std::size_t{ 16 } };
+}
+
+static bool isAtlasCandidate(const KtxTexture& texture) {
+    const auto width = static_cast<unsigned int>(texture.width);
+    const auto height = static_cast<unsigned int>(texture.height);
+    return std::has_single_bit(width) && std::has_single_bit(height) && texture.width <= AtlasMaxTile &&
+           texture.height <= AtlasMaxTile && std::min(texture.width, texture.height) >= blockLayout(texture).dimension;
+}
+
+struct Slot {
+    std::size_t page{ 0 };
+    int x{ 0 };
+    int y{ 0 };
+};
+
+// Shelves left to right, a new shelf when a row is full and a new page when a page is. sizes come tallest first.
+static std::vector<Slot> shelfPack(const std::vector<glm::ivec2>& sizes, const int side) {
+    std::vector<Slot> slots;
+    Slot cursor;
+    int shelfHeight{ 0 };
+    for(const auto& size : sizes) {
+        if(cursor.x + size.x > side) {
+            cursor.x = 0;
+            cursor.y += shelfHeight;
+            shelfHeight = 0;
+        }
+        if(cursor.y + size.y > side) {
+            ++cursor.page;
+            cursor.x = 0;
+            cursor.y = 0;
+            shelfHeight = 0;
+        }
+        slots.push_back(cursor);
+        cursor.x += size.x;
+        shelfHeight = std::max(shelfHeight, size.y);
+    }
+    return slots;
+}
+
+// Copies one level of a rectangle into a page, surrounded by gutter blocks taken from the opposite edges, which is
+// what GL_REPEAT would have sampled there.
+static void copyRectangle(const std::vector<unsigned char>& source, const int blocksWide, const int blocksHigh,
+                          std::vector<unsigned char>& page, const int pageBlocksWide, const int originX,
+                          const int originY, const int gutter, const std::size_t blockBytes) {
+    for(int y = -gutter; y < blocksHigh + gutter; ++y) {
+        const int sourceY{ (y % blocksHigh + blocksHigh) % blocksHigh };
+        for(int x = -gutter; x < blocksWide + gutter; ++x) {
+            const int sourceX{ (x % blocksWide + blocksWide) % blocksWide };
+            const auto target = static_cast<std::size_t>((originY + y) * pageBlocksWide + originX + x) * blockBytes;
+            const auto from = static_cast<std::size_t>(sourceY * blocksWide + sourceX) * blockBytes;
+            std::memcpy(page.data() + target, source.data() + from, blockBytes);
+        }
+    }
+}
+
+// Packs textures, which share a format, into as few pages as fit. Pages are square and as small as holds everything
+// on one page, or AtlasMaxPage when it takes several.
+static std::vector<Layer> buildAtlasPages(const std::vector<KtxTexture>& textures,
+                                          std::vector<std::size_t> candidates, std::deque<KtxTexture>& pages) {
+    const KtxTexture& first = textures[candidates.front()];
+    const BlockLayout block{ blockLayout(first) };
+
+    // Enough levels that the smallest rectangle still spans a block on the last one.
+    int levels{ AtlasMaxLevels };
+    for(const std::size_t index : candidates) {
+        const KtxTexture& texture = textures[index];
+        const auto smallest = static_cast<unsigned int>(std::min(texture.width, texture.height) / block.dimension);
+        levels = std::min({ levels, static_cast<int>(texture.levels.size()),
+                             static_cast<int>(std::bit_width(smallest)) });
+    }
+    // Whole blocks on every level, on both the rectangle and its gutter.
+    const int gutter{ block.dimension << (levels - 1) };
+
+    std::sort(candidates.begin(), candidates.end(), [&](const std::size_t a, const std::size_t b) {
+        return std::tie(textures[a].height, textures[a].width) > std::tie(textures[b].height, textures[b].width);
+    });
+    std::vector<glm::ivec2> sizes;
+    int largest{ 0 };
+    for(const std::size_t index : candidates) {
+        sizes.emplace_back(textures[index].width + gutter * 2, textures[index].height + gutter * 2);
+        largest = std::max({ largest, sizes.back().x, sizes.back().y });
+    }
+
+    int side{ static_cast<int>(std::bit_ceil(static_cast<unsigned int>(largest))) };
+    std::vector<Slot> slots{ shelfPack(sizes, side) };
+    while(slots.back().page > 0 && side < AtlasMaxPage) {
+        side *= 2;
+        slots = shelfPack(sizes, side);
+    }
+
+    std::vector<Layer> layers(slots.back().page + 1);
+    for(auto& layer : layers) {
+        KtxTexture& page = pages.emplace_back();
+        page.glType = first.glType;
+        page.glFormat = first.glFormat;
+        page.internalFormat = first.internalFormat;
+        page.baseInternalFormat = first.baseInternalFormat;
+        page.width = side;
+        page.height = side;
+        for(int level = 0; level < levels; ++level) {
+            const auto blocks = static_cast<std::size_t>((side >> level) / block.dimension);
+            page.levels.emplace_back(blocks * blocks * block.bytes, 0);
+        }
+        layer.texture = &page;
+    }
+
+    const auto pageSide = static_cast<float>(side);
+    for(std::size_t i = 0; i < candidates.size(); ++i) {
+        const KtxTexture& texture = textures[candidates[i]];
+        const Slot& slot = slots[i];
+        KtxTexture& page = pages[pages.size() - layers.size() + slot.page];
+        for(int level = 0; level < levels; ++level) {
+            const int unit{ block.dimension << level };
+            copyRectangle(texture.levels[static_cast<std::size_t>(level)], (texture.width >> level) / block.dimension,
+                          (texture.height >> level) / block.dimension, page.levels[static_cast<std::size_t>(level)],
+                          (side >> level) / block.dimension, (slot.x + gutter) / unit, (slot.y + gutter) / unit,
+                          gutter / unit, block.bytes);
+        }
+
+        layers[slot.page].users.emplace_back(candidates[i],
+                                             glm::vec4(static_cast<float>(texture.width) / pageSide,
+                                                       static_cast<float>(texture.height) / pageSide,
+                                                       static_cast<float>(slot.x + gutter) / pageSide,
+                                                       static_cast<float>(slot.y + gutter) / pageSide));
+    }
+
+    return layers;
+}
+
+// Immutable storage when the context has it, like uploadPreparedTexture, mutable levels otherwise.
+static unsigned int uploadArray(const std::vector<Layer>& layers, const GLenum internalFormat) {
+    const KtxTexture& first = *layers.front().texture;
+    const auto depth = static_cast<GLsizei>(layers.size());
+    const bool compressed{ first.glType == 0 };
+
+    unsigned int textureID{ 0 };
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+    if(texStorage3D) {
+        texStorage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLsizei>(first.levels.size()), internalFormat, first.width,
+                     first.height, depth);
+    }
+
+    std::vector<unsigned char> data;
+    std::size_t bytes{ 0 };
+    for(std::size_t level = 0; level < first.levels.size(); ++level) {
+        const int width{ std::max(1, first.width >> level) };
+        const int height{ std::max(1, first.height >> level) };
+        data.clear();
+        for(const auto& layer : layers) {
+            const auto& levelData = layer.texture->levels[level];
+            data.insert(data.end(), levelData.begin(), levelData.end());
+        }
+        bytes += data.size();
+
+        const auto size = static_cast<GLsizei>(data.size());
+        if(texStorage3D && compressed) {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0, width, height, depth,
+                                      internalFormat, size, data.data());
+        } else if(texStorage3D) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0, width, height, depth,
+                            first.glFormat, first.glType, data.data());
+        } else if(compressed) {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), internalFormat, width, height, depth,
+                                   0, size, data.data());
+        } else {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), static_cast<GLint>(internalFormat), width,
+                         height, depth, 0, first.glFormat, first.glType, data.data());
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(first.levels.size()) - 1);
+    if(first.baseInternalFormat == GL_RED) {
+        const GLint swizzle[]{ GL_RED, GL_RED, GL_RED, GL_ONE };
+        glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+    manageTexture(textureID, GL_TEXTURE_2D_ARRAY, bytes, TextureSampler::REPEAT);
+
+    return textureID;
+}
+
+TexturePacking packTextureArrays(const std::vector<KtxTexture>& textures, const std::vector<bool>& gammaCorrection,
+                                 const std::size_t maxArrays) {
+    TexturePacking packing;
+    packing.placements.resize(textures.size());
+
+    std::vector<unsigned int> internalFormats(textures.size());
+    for(std::size_t i = 0; i < textures.size(); ++i) {
+        internalFormats[i] = sizedInternalFormat(textures[i], gammaCorrection[i]);
+    }
+
+    const glm::vec4 identity{ 1.f, 1.f, 0.f, 0.f };
+    std::map<ArrayKey, std::vector<Layer>> groups;
+    for(std::size_t i = 0; i < textures.size(); ++i) {
+        if(!textures[i].levels.empty()) {
+            groups[arrayKey(textures[i], internalFormats[i])].push_back({ &textures[i], { { i, identity } } });
+        }
+    }
+
+    // Small textures with nothing to share an array with are gathered per format, a format with a single one left
+    // keeps its array of one.
+    std::map<std::tuple<unsigned int, unsigned int, unsigned int>, std::vector<std::size_t>> atlasCandidates;
+    for(const auto& [key, layers] : groups) {
+        const KtxTexture& texture = *layers.front().texture;
+        if(layers.size() == 1 && isAtlasCandidate(texture)) {
+            atlasCandidates[{ texture.glType, texture.glFormat, std::get<2>(key) }].push_back(
+                layers.front().users.front().first);
+        }
+    }
+
+    std::deque<KtxTexture> pages;
+    for(const auto& [format, candidates] : atlasCandidates) {
+        if(candidates.size() < 2) {
+            continue;
+        }
+        const unsigned int internalFormat{ std::get<2>(format) };
+        for(const std::size_t index : candidates) {
+            groups.erase(arrayKey(textures[index], internalFormat));
+        }
+        for(auto& page : buildAtlasPages(textures, candidates, pages)) {
+            groups[arrayKey(*page.texture, internalFormat)].push_back(std::move(page));
+        }
+    }
+
+    for(const auto& [key, layers] : groups) {
+        if(packing.arrays.size() == maxArrays) {
+            break;
+        }
+
+        packing.arrays.push_back(uploadArray(layers, std::get<2>(key)));
+        for(std::size_t layer = 0; layer < layers.size(); ++layer) {
+            for(const auto& [index, uvTransform] : layers[layer].users) {
+                packing.placements[index] = {
+                    .array = packing.arrays.size() - 1,
+                    .layer = static_cast<float>(layer),
+                    .uvTransform = uvTransform,
+                };
+            }
+        }
+    }
+
+    return packing;
+}
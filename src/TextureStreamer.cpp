@@ -0,0 +1,362 @@
+#include <TextureStreamer.hpp>
+#include <TextureLoader.hpp>
+#include <ThreadPool.hpp>
+#include <GLExtensions.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// How long a level has to go unrequested before it is released. Keeps a mesh hovering around a level boundary from
+// streaming the same level in and out every frame.
+static constexpr unsigned int ReleaseDelayFrames{ 60 };
+
+static TextureStreamer* streamer{ nullptr };
+
+void setTextureStreamer(TextureStreamer* textureStreamer) {
+    streamer = textureStreamer;
+}
+
+TextureStreamer* activeTextureStreamer() {
+    return streamer;
+}
+
+// Only RGBA8 is stored uncompressed, everything else is one of the block formats prepareTexture picks.
+static std::size_t levelBytes(const KtxTexture& texture, const std::size_t level) {
+    const auto width = static_cast<std::size_t>(std::max(1, texture.width >> level));
+    const auto height = static_cast<std::size_t>(std::max(1, texture.height >> level));
+    if(texture.glType != 0) {
+        return width * height * 4;
+    }
+
+    const bool halfBlocks{ texture.internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ||
+                           texture.internalFormat == GL_COMPRESSED_RED_RGTC1 };
+    return (width + 3) / 4 * ((height + 3) / 4) * (halfBlocks ? 8 : 16);
+}
+
+static std::size_t chainBytes(const KtxTexture& texture, const std::size_t firstLevel) {
+    std::size_t bytes{ 0 };
+    for(std::size_t level = firstLevel; level < texture.levels.size(); ++level) {
+        bytes += levelBytes(texture, level);
+    }
+    return bytes;
+}
+
+static void updateManagedBytes(const unsigned int textureId, const KtxTexture& texture, const std::size_t baseLevel) {
+    if(TextureManager* manager = activeTextureManager()) {
+        manager->setBytes(textureId, chainBytes(texture, baseLevel));
+    }
+}
+
+TextureStreamer::TextureStreamer(const std::size_t uploadBudgetBytes)
+    :uploadBudget(uploadBudgetBytes), uploads(uploadBudgetBytes)
+{
+}
+
+TextureStreamer::~TextureStreamer() {
+    // Workers hold pointers into entries, they have to be done before it goes away.
+    std::unique_lock lock(mutex);
+    loadDone.wait(lock, [this]() { return pendingLoads == 0; });
+}
+
+unsigned int TextureStreamer::add(KtxTexture texture, const std::string& cachePath, const bool gammaCorrection,
+                                  const TextureSampler sampler) {
+    std::size_t firstLevel{ 0 };
+    while(firstLevel < texture.levels.size() && texture.levels[firstLevel].empty()) {
+        ++firstLevel;
+    }
+    if(firstLevel == texture.levels.size()) {
+        std::cerr << "::TextureStreamer:: no resident levels to start from, path -> " << cachePath << '\n';
+        return 0;
+    }
+
+    const unsigned int id{ uploadMutableTexture(texture, firstLevel, gammaCorrection, sampler) };
+    for(auto& level : texture.levels) {
+        level = {};
+    }
+
+    Entry& entry = entries.emplace_back();
+    entry.id = id;
+    entry.cachePath = cachePath;
+    entry.gammaCorrection = gammaCorrection;
+    entry.texture = std::move(texture);
+    entry.residentLevel = firstLevel;
+    entry.baseLevel = firstLevel;
+    entry.queuedLevel = firstLevel;
+    entry.wantedLevel = firstLevel;
+    entry.restingLevel = firstLevel;
+    entryIndex.emplace(id, entries.size() - 1);
+
+    return id;
+}
+
+void TextureStreamer::request(const unsigned int textureId, const float pixels) {
+    const auto found = entryIndex.find(textureId);
+    if(found == entryIndex.end()) {
+        return;
+    }
+
+    if(TextureManager* manager = activeTextureManager()) {
+        static_cast<void>(manager->use(textureId));
+    }
+
+    // The coarsest level that still has at least one texel per pixel.
+    Entry& entry = entries[found->second];
+    const auto size = static_cast<float>(std::max(entry.texture.width, entry.texture.height));
+    const float ratio{ size / std::max(pixels, 1.f) };
+    const std::size_t level{ ratio <= 1.f ? 0 : static_cast<std::size_t>(std::floor(std::log2(ratio))) };
+    entry.wantedLevel = std::min(entry.wantedLevel, std::clamp(level, entry.finestLevel, entry.residentLevel));
+}
+
+void TextureStreamer::update() {
+    // Evicted textures drawn or requested this frame want their resident levels back.
+    TextureManager* manager = activeTextureManager();
+    if(manager) {
+        for(auto& entry : entries) {
+            if(manager->lastUsedFrame(entry.id) == manager->frame()) {
+                entry.restingLevel = entry.residentLevel;
+                entry.wantedLevel = std::min(entry.wantedLevel, entry.residentLevel);
+            }
+        }
+    }
+
+    // Take in whatever the workers finished reading, keeping only the levels still wanted and not yet uploaded.
+    {
+        const std::lock_guard lock(mutex);
+        for(auto& entry : entries) {
+            if(!entry.loadFinished) {
+                continue;
+            }
+            if(entry.loaded.levels.size() != entry.texture.levels.size()) {
+                std::cerr << "::TextureStreamer:: can't stream from " << entry.cachePath << ", keeping what's resident\n";
+                entry.finestLevel = entry.queuedLevel;
+                entry.wantedLevel = std::max(entry.wantedLevel, entry.finestLevel);
+            } else {
+                for(std::size_t level = entry.wantedLevel; level < entry.queuedLevel; ++level) {
+                    entry.texture.levels[level] = std::move(entry.loaded.levels[level]);
+                }
+            }
+            entry.loaded = {};
+            entry.loading = false;
+            entry.loadFinished = false;
+        }
+    }
+
+    // Biggest shortfall first, so the budget goes where the blur is most visible. Levels are uploaded coarse to fine,
+    // the texture is complete again after every one of them.
+    std::vector<Entry*> wanting;
+    for(auto& entry : entries) {
+        if(entry.wantedLevel < entry.queuedLevel) {
+            wanting.push_back(&entry);
+        }
+    }
+    std::sort(wanting.begin(), wanting.end(), [](const Entry* a, const Entry* b) {
+        return a->queuedLevel - a->wantedLevel > b->queuedLevel - b->wantedLevel;
+    });
+
+    std::size_t uploaded{ 0 };
+    for(Entry* entry : wanting) {
+        while(entry->wantedLevel < entry->queuedLevel) {
+            const std::size_t level{ entry->queuedLevel - 1 };
+            auto& data = entry->texture.levels[level];
+            if(data.empty()) {
+                if(!entry->loading && roomToLoad(*entry)) {
+                    startLoad(*entry);
+                }
+                break;
+            }
+            // A level bigger than the whole budget still goes up, alone, or it never would.
+            if(uploaded > 0 && uploaded + data.size() > uploadBudget) {
+                break;
+            }
+            if(!makeRoom(levelBytes(entry->texture, level))) {
+                break;
+            }
+
+            // The level is sampled from once the queue has issued all of it, not before.
+            uploaded += data.size();
+            glBindTexture(GL_TEXTURE_2D, entry->id);
+            TextureUpload upload{ allocateTextureLevel(entry->id, entry->texture, level, entry->gammaCorrection) };
+            upload.onIssued = [entry, level]() {
+                glBindTexture(GL_TEXTURE_2D, entry->id);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level));
+                entry->baseLevel = level;
+            };
+            uploads.push(std::move(upload));
+            entry->queuedLevel = level;
+            // The level's memory is allocated from here on, whether or not it holds anything yet.
+            updateManagedBytes(entry->id, entry->texture, level);
+        }
+    }
+    uploads.update();
+
+    for(auto& entry : entries) {
+        // Nothing is released while levels are still on their way up.
+        if(entry.queuedLevel < entry.baseLevel) {
+            entry.framesUnneeded = 0;
+        } else if(entry.wantedLevel > entry.baseLevel) {
+            if(++entry.framesUnneeded >= ReleaseDelayFrames) {
+                release(entry, entry.wantedLevel);
+            }
+        } else {
+            entry.framesUnneeded = 0;
+        }
+
+        // Loaded levels finer than anything wanted now would only sit there.
+        for(std::size_t level = 0; level < entry.wantedLevel; ++level) {
+            entry.texture.levels[level] = {};
+        }
+        entry.wantedLevel = entry.restingLevel;
+    }
+
+    // Textures the streamer doesn't own can push the total over the budget too.
+    if(manager) {
+        if(manager->gpuBudget() > 0 && manager->totalBytes() > manager->gpuBudget()) {
+            static_cast<void>(evict(manager->totalBytes() - manager->gpuBudget(), false));
+        }
+        manager->setCpuBytes(stagedBytes());
+    }
+}
+
+bool TextureStreamer::owns(const unsigned int textureId) const {
+    return entryIndex.contains(textureId);
+}
+
+std::size_t TextureStreamer::residentBytes() const {
+    std::size_t bytes{ 0 };
+    for(const auto& entry : entries) {
+        bytes += chainBytes(entry.texture, entry.baseLevel);
+    }
+    return bytes;
+}
+
+std::size_t TextureStreamer::fullBytes() const {
+    std::size_t bytes{ 0 };
+    for(const auto& entry : entries) {
+        bytes += chainBytes(entry.texture, 0);
+    }
+    return bytes;
+}
+
+std::size_t TextureStreamer::stagedBytes() const {
+    std::size_t bytes{ uploads.pendingBytes() };
+    for(const auto& entry : entries) {
+        if(entry.loading) {
+            bytes += chainBytes(entry.texture, 0);
+        }
+        for(const auto& level : entry.texture.levels) {
+            bytes += level.size();
+        }
+    }
+    return bytes;
+}
+
+// Reads the whole cache file back, update() picks out the levels it still needs once it's done.
+void TextureStreamer::startLoad(Entry& entry) {
+    entry.loading = true;
+    {
+        const std::lock_guard lock(mutex);
+        ++pendingLoads;
+    }
+
+    Entry* loading{ &entry };
+    workerPool().submit([this, loading]() {
+        KtxTexture texture;
+        if(!readKtx(loading->cachePath, texture)) {
+            texture = {};
+        }
+
+        const std::lock_guard lock(mutex);
+        loading->loaded = std::move(texture);
+        loading->loadFinished = true;
+        --pendingLoads;
+        loadDone.notify_all();
+    });
+}
+
+// The worker holds the whole cache file for a moment. With nothing else staged a read goes ahead regardless, or a file
+// bigger than the budget would never stream.
+bool TextureStreamer::roomToLoad(const Entry& entry) const {
+    const TextureManager* manager = activeTextureManager();
+    if(!manager || manager->cpuBudget() == 0) {
+        return true;
+    }
+    const std::size_t staged{ stagedBytes() };
+    return staged == 0 || staged + chainBytes(entry.texture, 0) <= manager->cpuBudget();
+}
+
+// The base level moves first so the texture never samples from a level that is gone.
+void TextureStreamer::release(Entry& entry, const std::size_t level) {
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level));
+    for(std::size_t released = entry.baseLevel; released < level; ++released) {
+        releaseTextureLevel(entry.texture, released, entry.gammaCorrection);
+    }
+    entry.baseLevel = level;
+    entry.queuedLevel = level;
+    entry.framesUnneeded = 0;
+    updateManagedBytes(entry.id, entry.texture, level);
+}
+
+bool TextureStreamer::makeRoom(const std::size_t bytes) {
+    const TextureManager* manager = activeTextureManager();
+    if(!manager || manager->gpuBudget() == 0 || manager->totalBytes() + bytes <= manager->gpuBudget()) {
+        return true;
+    }
+    return evict(manager->totalBytes() + bytes - manager->gpuBudget(), true);
+}
+
+bool TextureStreamer::evict(const std::size_t bytes, const bool allOrNothing) {
+    TextureManager* manager = activeTextureManager();
+    if(!manager) {
+        return false;
+    }
+
+    // Textures with levels still in the upload queue can't lose any until those are issued.
+    std::vector<Entry*> candidates;
+    for(auto& entry : entries) {
+        if(entry.queuedLevel == entry.baseLevel && manager->lastUsedFrame(entry.id) < manager->frame()) {
+            candidates.push_back(&entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [manager](const Entry* a, const Entry* b) {
+        return manager->lastUsedFrame(a->id) < manager->lastUsedFrame(b->id);
+    });
+
+    // Streamed levels first, and only when that isn't enough the resident ones too. The last level always stays, so
+    // the texture remains complete and its id valid.
+    std::vector<std::size_t> evictTo;
+    for(const Entry* entry : candidates) {
+        evictTo.push_back(entry->baseLevel);
+    }
+    std::size_t freed{ 0 };
+    for(const bool whole : { false, true }) {
+        for(std::size_t i = 0; i < candidates.size() && freed < bytes; ++i) {
+            const Entry& entry = *candidates[i];
+            const std::size_t coarsest{ whole ? entry.texture.levels.size() - 1 : entry.residentLevel };
+            for(; evictTo[i] < coarsest && freed < bytes; ++evictTo[i]) {
+                freed += levelBytes(entry.texture, evictTo[i]);
+            }
+        }
+    }
+    if(freed < bytes && allOrNothing) {
+        return false;
+    }
+
+    for(std::size_t i = 0; i < candidates.size(); ++i) {
+        Entry& entry = *candidates[i];
+        if(evictTo[i] == entry.baseLevel) {
+            continue;
+        }
+        const std::size_t lastLevel{ entry.texture.levels.size() - 1 };
+        manager->recordEviction(chainBytes(entry.texture, entry.baseLevel) - chainBytes(entry.texture, evictTo[i]),
+                                evictTo[i] - entry.baseLevel, evictTo[i] == lastLevel);
+        release(entry, evictTo[i]);
+        entry.restingLevel = std::max(entry.residentLevel, evictTo[i]);
+        entry.wantedLevel = std::max(entry.wantedLevel, entry.restingLevel);
+    }
+    return freed >= bytes;
+}
@@ -0,0 +1,198 @@
+#include <TextureUploadQueue.hpp>
+#include <GLExtensions.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// Every band starts on its own cache line, which also covers the alignment block formats want.
+static constexpr std::size_t BandAlignment{ 64 };
+
+static bool isCompressed(const TextureUpload& upload) {
+    return upload.type == 0;
+}
+
+// Compressed data can only be split between rows of blocks.
+static int rowCount(const TextureUpload& upload) {
+    return isCompressed(upload) ? (upload.height + 3) / 4 : upload.height;
+}
+
+static std::size_t rowBytes(const TextureUpload& upload) {
+    return upload.data.size() / static_cast<std::size_t>(std::max(1, rowCount(upload)));
+}
+
+TextureUploadQueue::TextureUploadQueue(const std::size_t frameBytes, const std::size_t framesInFlight)
+    :regionBytes(frameBytes), fences(std::max<std::size_t>(1, framesInFlight), nullptr)
+{
+    const auto size = static_cast<GLsizeiptr>(regionBytes * fences.size());
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    if(bufferStorage) {
+        const GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+        bufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+    } else {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+TextureUploadQueue::~TextureUploadQueue() {
+    for(const GLsync fence : fences) {
+        if(fence) {
+            glDeleteSync(fence);
+        }
+    }
+    // Deleting a buffer unmaps it.
+    glDeleteBuffers(1, &buffer);
+}
+
+void TextureUploadQueue::push(TextureUpload upload) {
+    bytesPending += upload.data.size();
+    pending.push_back(std::move(upload));
+}
+
+void TextureUploadQueue::update() {
+    static_cast<void>(updateRegion(false));
+}
+
+void TextureUploadQueue::flush() {
+    while(!pending.empty()) {
+        static_cast<void>(updateRegion(true));
+    }
+}
+
+bool TextureUploadQueue::idle() const {
+    return pending.empty();
+}
+
+std::size_t TextureUploadQueue::pendingBytes() const {
+    return bytesPending;
+}
+
+bool TextureUploadQueue::persistentlyMapped() const {
+    return mapped != nullptr;
+}
+
+bool TextureUploadQueue::updateRegion(const bool wait) {
+    if(pending.empty()) {
+        return true;
+    }
+
+    GLsync& fence = fences[nextRegion];
+    if(fence) {
+        const GLenum status{ glClientWaitSync(fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                              wait ? std::numeric_limits<GLuint64>::max() : 0) };
+        if(status == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    const std::size_t regionStart{ nextRegion * regionBytes };
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    // The fence said the GPU is done with the region, so no need for the driver to synchronise the mapping.
+    unsigned char* region = mapped ? mapped + regionStart : static_cast<unsigned char*>(glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(regionStart), static_cast<GLsizeiptr>(regionBytes),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+    GLint alignment{ 4 };
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // Rows go into the region front to back, an upload that doesn't fit carries on in the next region. lastRow ends up
+    // one past the last row staged of the last upload touched.
+    std::vector<std::pair<std::size_t, Band>> bands;
+    std::size_t used{ 0 };
+    int lastRow{ 0 };
+    for(std::size_t i = 0; i < pending.size() && region; ++i) {
+        const TextureUpload& upload = pending[i];
+        const int firstRow{ i == 0 ? rowsIssued : 0 };
+        const int rowsLeft{ rowCount(upload) - firstRow };
+        const std::size_t bytesPerRow{ rowBytes(upload) };
+        const std::size_t offset{ (used + BandAlignment - 1) / BandAlignment * BandAlignment };
+        const std::size_t rowsFitting{ offset < regionBytes ? (regionBytes - offset) / bytesPerRow : 0 };
+        const int rows{ static_cast<int>(std::min(static_cast<std::size_t>(rowsLeft), rowsFitting)) };
+        if(rows == 0) {
+            break;
+        }
+
+        const int rowHeight{ isCompressed(upload) ? 4 : 1 };
+        const Band band{
+            .offset = regionStart + offset,
+            .y = firstRow * rowHeight,
+            .height = std::min(rows * rowHeight, upload.height - firstRow * rowHeight),
+            .bytes = static_cast<std::size_t>(rows) * bytesPerRow,
+        };
+        std::memcpy(region + offset, upload.data.data() + static_cast<std::size_t>(firstRow) * bytesPerRow, band.bytes);
+        bands.emplace_back(i, band);
+        used = offset + band.bytes;
+        lastRow = firstRow + rows;
+        if(rows < rowsLeft) {
+            break;
+        }
+    }
+    if(!mapped && region) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    if(!bands.empty()) {
+        for(const auto& [index, band] : bands) {
+            issue(pending[index], band, reinterpret_cast<const void*>(static_cast<std::uintptr_t>(band.offset)));
+            bytesPending -= band.bytes;
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        nextRegion = (nextRegion + 1) % fences.size();
+    } else {
+        // Nothing went in: the region couldn't be mapped, or a single row is bigger than it. The front upload then
+        // goes the slow way, straight from client memory, so the queue never gets stuck on it.
+        if(!region) {
+            std::cerr << "::TextureUploadQueue:: can't map the staging buffer, uploading from client memory\n";
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        const TextureUpload& upload = pending.front();
+        const int rowHeight{ isCompressed(upload) ? 4 : 1 };
+        const std::size_t skipped{ static_cast<std::size_t>(rowsIssued) * rowBytes(upload) };
+        const Band band{
+            .offset = 0,
+            .y = rowsIssued * rowHeight,
+            .height = upload.height - rowsIssued * rowHeight,
+            .bytes = upload.data.size() - skipped,
+        };
+        issue(upload, band, upload.data.data() + skipped);
+        bytesPending -= band.bytes;
+        bands.emplace_back(0, band);
+        lastRow = rowCount(upload);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    // Every upload before the last one touched is complete, that one only when its last row went in.
+    const std::size_t last{ bands.back().first };
+    const bool lastComplete{ lastRow == rowCount(pending[last]) };
+    rowsIssued = lastComplete ? 0 : lastRow;
+    for(std::size_t i = 0; i < last + (lastComplete ? 1 : 0); ++i) {
+        TextureUpload upload{ std::move(pending.front()) };
+        pending.pop_front();
+        if(upload.onIssued) {
+            upload.onIssued();
+        }
+    }
+
+    return true;
+}
+
+void TextureUploadQueue::issue(const TextureUpload& upload, const Band& band, const void* pixels) {
+    glBindTexture(upload.target == GL_TEXTURE_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, upload.texture);
+    if(isCompressed(upload)) {
+        glCompressedTexSubImage2D(upload.target, upload.level, 0, band.y, upload.width, band.height, upload.format,
+                                  static_cast<GLsizei>(band.bytes), pixels);
+    } else {
+        glTexSubImage2D(upload.target, upload.level, 0, band.y, upload.width, band.height, upload.format, upload.type,
+                        pixels);
+    }
+}
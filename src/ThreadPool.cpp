@@ -0,0 +1,71 @@
+#include <ThreadPool.hpp>
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threads) {
+    if(threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers.reserve(threads);
+    for(unsigned int i = 0; i < threads; ++i) {
+        workers.emplace_back([this]() { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for(auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        const std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+        ++pending;
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock(mutex);
+    allDone.wait(lock, [this]() { return pending == 0; });
+}
+
+void ThreadPool::run() {
+    while(true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if(tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        task();
+
+        bool finished{ false };
+        {
+            const std::lock_guard lock(mutex);
+            finished = --pending == 0;
+        }
+        if(finished) {
+            allDone.notify_all();
+        }
+    }
+}
+
+ThreadPool& workerPool() {
+    static ThreadPool pool;
+    return pool;
+}
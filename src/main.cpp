@@ -1,44 +1,130 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#include <stb_image.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <Shader.hpp>
-#include <Camera.hpp>
+#include <QuaternionCamera.hpp>
 #include <Model.hpp>
-
+#include <AssetPack.hpp>
+#include <TextureLoader.hpp>
+#include <TextureStreamer.hpp>
+#include <TextureManager.hpp>
+#include <GLExtensions.hpp>
+#include <Frustum.hpp>
+#include <FixedTimestep.hpp>
+#include <CameraPath.hpp>
+#include <FrameTimer.hpp>
+#include <DynamicResolution.hpp>
+#include <FrameUniforms.hpp>
+#include <FrameGraph.hpp>
+#include <Bloom.hpp>
+
+#include <algorithm>
 #include <iostream>
 #include <array>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
 
 static void framebuffer_size_callback(GLFWwindow*, int, int);
 static void mouse_callback(GLFWwindow*, double, double);
 static void scroll_callback(GLFWwindow*, double, double);
-static void processInput(GLFWwindow*);
-[[nodiscard]] static unsigned int loadTexture(const std::string&, bool);
+static void processInput(GLFWwindow*, float);
+
+// Reads all of text as a number, false when it isn't one.
+template<typename T>
+static bool parseNumber(const std::string& text, T& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc{} && end == text.data() + text.size();
+}
 
 static constexpr unsigned int WindowWidth{ 1920 };
 static constexpr unsigned int WindowHeight{ 1080 };
+static constexpr std::size_t TextureGpuBudget{ 256 * 1024 * 1024 };
+static constexpr std::size_t TextureCpuBudget{ 64 * 1024 * 1024 };
 
-static Camera camera(glm::vec3(0.f, 0.f, 3.f));
+static QuaternionCamera camera(glm::vec3(0.f, 0.f, 3.f), Yaw, Pitch, static_cast<float>(WindowWidth) / WindowHeight);
+// What the window has to be drawn at, in pixels, as framebuffer_size_callback last heard.
+static int framebufferWidth{ static_cast<int>(WindowWidth) };
+static int framebufferHeight{ static_cast<int>(WindowHeight) };
 static float lastX{ static_cast<float>(WindowWidth) / 2.f };
 static float lastY{ static_cast<float>(WindowHeight) / 2.f };
 static bool firstMouse{ true };
+// Playing back a recorded camera path, with mouse and keyboard left out.
+static bool playingBack{ false };
 static void renderCube();
 static void renderQuad();
+static void requestCubeTextureDetail(const QuaternionCamera& view, unsigned int texture, const glm::mat4& model);
 
-static float deltaTime{ 0.f };
-static float lastFrame{ 0.f };
+static FixedTimestep timestep;
+static double lastFrame{ 0.0 };
 static bool bloom { true };
 static bool bloomKeyPressed{ false };
+static BloomMode bloomMode{ BloomMode::PROGRESSIVE };
+static bool bloomModeKeyPressed{ false };
 static float exposure{ 1.f };
 
-int main() {
+// --record flight.campath records the camera at every simulation step. --play flight.campath flies the recording with
+// no input, one step per frame and no vsync, and writes every frame's CPU and GPU time to flight.campath.timings.csv.
+// --late-latch samples input as late as it can, right before the frame is drawn, and --raw-mouse takes mouse motion
+// without the desktop's acceleration. --gaussian-bloom starts with the full resolution Gaussian bloom rather than the
+// progressive one, B switches between them. --blur-downscale 2 or 4 runs the Gaussian at half or quarter resolution,
+// and --compute-blur runs it in compute shaders where the driver has them. --gpu-budget 8 lowers the scene's resolution
+// when the GPU takes more than 8 ms over a frame rather than the default 16.7, and 0 keeps it at full resolution.
+int main(int argc, char** argv) {
+    std::string recordPath, playPath;
+    bool lateLatch{ false }, rawMouse{ false };
+    int blurDownscale{ 1 };
+    bool computeBlur{ false };
+    double gpuBudgetMs{ 1000.0 / 60.0 };
+    const auto usage = [&]() {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--record path | --play path] [--late-latch] [--raw-mouse] [--gaussian-bloom]"
+                  << " [--blur-downscale 1|2|4] [--compute-blur] [--gpu-budget ms]\n";
+        return EXIT_FAILURE;
+    };
+    for(int i = 1; i < argc; ++i) {
+        const std::string option{ argv[i] };
+        if(option == "--late-latch") {
+            lateLatch = true;
+        } else if(option == "--raw-mouse") {
+            rawMouse = true;
+        } else if(option == "--gaussian-bloom") {
+            bloomMode = BloomMode::GAUSSIAN;
+        } else if(option == "--blur-downscale" && i + 1 < argc) {
+            if(!parseNumber(argv[++i], blurDownscale) ||
+               (blurDownscale != 1 && blurDownscale != 2 && blurDownscale != 4)) {
+                return usage();
+            }
+        } else if(option == "--compute-blur") {
+            computeBlur = true;
+        } else if(option == "--gpu-budget" && i + 1 < argc) {
+            if(!parseNumber(argv[++i], gpuBudgetMs) || gpuBudgetMs < 0.0) {
+                return usage();
+            }
+        } else if((option == "--record" || option == "--play") && i + 1 < argc) {
+            (option == "--record" ? recordPath : playPath) = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+
+    CameraPath cameraPath;
+    if(!playPath.empty()) {
+        if(!readCameraPath(playPath, cameraPath)) {
+            return EXIT_FAILURE;
+        }
+        playingBack = true;
+    } else if(!recordPath.empty()) {
+        cameraPath.stepSeconds = timestep.step();
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -52,78 +138,90 @@ int main() {
     }
 
     glfwMakeContextCurrent(window);
+    // Bigger than the window on high DPI screens.
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if(rawMouse) {
+        if(glfwRawMouseMotionSupported()) {
+            glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+        } else {
+            std::cerr << "Raw mouse motion isn't supported here, using the desktop's\n";
+        }
+    }
+    // Playback is for timing, so frames go out as fast as they are drawn.
+    if(playingBack) {
+        glfwSwapInterval(0);
+    }
 
     if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cout << "Failed to initialize GLAD\n";
         return EXIT_FAILURE;
     }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
 
     glEnable(GL_DEPTH_TEST);
+    // Filters across cube map faces instead of clamping at their edges.
+    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+    // Built by asset_packer. Without it everything is read from the loose files under assets/.
+    std::unique_ptr<AssetPack> assetPack;
+    if(std::filesystem::exists("./assets.pack")) {
+        assetPack = std::make_unique<AssetPack>("./assets.pack");
+        if(assetPack->isOpen()) {
+            mountAssetPack(assetPack.get());
+        }
+    }
 
     // HERE
     Shader shader("./shaders/bloom.vs", "./shaders/bloom.fs");
     Shader shaderLight("./shaders/bloom.vs", "./shaders/lightBox.fs");
-    Shader shaderBlur("./shaders/blur.vs", "./shaders/blur.fs");
     Shader shaderBloomFinal("./shaders/bloomFinal.vs", "./shaders/bloomFinal.fs");
-
-    const auto woodTexture = loadTexture("./assets/wood.png", true);
-    const auto containerTexture = loadTexture("./assets/container2.png", true);
-
-    unsigned int hdrFBO{ 0 };
-    glGenFramebuffers(1, &hdrFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
-
-    // create 2 floating point color buffers (1 for normal rendering, other for brightness threshold values)
-    std::array<unsigned int, 2> colourBuffers;
-    glGenTextures(2, &colourBuffers[0]);
-    for(unsigned int i{ 0 }; i < colourBuffers.size(); ++i) {
-        glBindTexture(GL_TEXTURE_2D, colourBuffers[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, WindowWidth, WindowHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, colourBuffers[i], 0);
-    }
-
-    // Create and attach depth buffer
-    unsigned int rboDepth{ 0 };
-    glGenRenderbuffers(1, &rboDepth);
-    glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, WindowWidth, WindowHeight);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
-    std::array<unsigned int, 2> attachments{ GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
-    glDrawBuffers(attachments.size(), &attachments[0]);
-    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "Framebuffer not complete, bro\n";
-        return EXIT_FAILURE;
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // Ping-pong framebuffer for blurring
-    std::array<unsigned int, 2> pingPongFBO;
-    std::array<unsigned int, 2> pingPongColourBuffers;
-    glGenFramebuffers(2, &pingPongFBO[0]);
-    glGenTextures(2, &pingPongColourBuffers[0]);
-    for(unsigned int i{ 0 }; i < pingPongFBO.size(); ++i) {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingPongFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, pingPongColourBuffers[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, WindowWidth, WindowHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pingPongColourBuffers[i], 0);
-        if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            std::cerr << "Framebuffer not complete, bro, n -> " << i << "\n";
-            return EXIT_FAILURE;
-        }
-    }
+    Shader shaderSkybox("./shaders/skyboxShader.vs", "./shaders/skyboxShader.fs");
+
+    // Every texture below, loaded or rendered to, is owned by the manager and sampled through its samplers.
+    auto textureManager = std::make_unique<TextureManager>();
+    setTextureManager(textureManager.get());
+    // Past these the streamer evicts the textures drawn least recently.
+    textureManager->setBudget(TextureGpuBudget, TextureCpuBudget);
+
+    // Textures come up with their small mips only, the rest streams in as the camera gets close.
+    auto textureStreamer = std::make_unique<TextureStreamer>();
+    setTextureStreamer(textureStreamer.get());
+
+    // Both decode on the worker pool at the same time, we only wait once.
+    TextureBatch textures;
+    const auto woodIndex = textures.add("./assets/wood.png", true);
+    const auto containerIndex = textures.add("./assets/container2.png", true);
+    const auto textureIds = textures.upload();
+    const auto woodTexture = textureIds[woodIndex];
+    const auto containerTexture = textureIds[containerIndex];
+
+    // The first run decodes and filters the faces on the workers and cooks the result, later runs read it straight in.
+    const unsigned int skyboxTexture{ loadCubemap({
+        "./assets/skybox/right.jpg",
+        "./assets/skybox/left.jpg",
+        "./assets/skybox/top.jpg",
+        "./assets/skybox/bottom.jpg",
+        "./assets/skybox/front.jpg",
+        "./assets/skybox/back.jpg",
+    }, true) };
+
+    // Render targets are declared every frame by the passes that draw to them, and come out of the frame graph's pool.
+    // Their size follows the window's, scaled down when the GPU falls behind.
+    auto frameGraph = std::make_unique<FrameGraph>();
+    auto bloomPasses = std::make_unique<Bloom>();
+    bloomPasses->gaussian.downscale = blurDownscale;
+    bloomPasses->gaussian.compute = computeBlur;
+    DynamicResolution dynamicResolution{ gpuBudgetMs };
+    RenderTargetDesc previousHdrTarget{};
+    // Set up by hand, the two scene colour buffers, the two blur buffers and the depth buffer took this much for good.
+    const std::size_t handAllocatedTargetBytes{
+        4 * renderTargetBytes({ static_cast<int>(WindowWidth), static_cast<int>(WindowHeight), GL_RGBA16F }) +
+        renderTargetBytes({ static_cast<int>(WindowWidth), static_cast<int>(WindowHeight), GL_DEPTH_COMPONENT24 }) };
 
     constexpr std::array<glm::vec3, 4> lightPositions{
         glm::vec3( 0.f, 0.5f,  1.5f),
@@ -139,137 +237,270 @@ int main() {
         glm::vec3( 0.f, 5.f,  0.f),
     };
 
+    // The scene never moves, so the world space bounds of every cube are worked out once and culled every frame.
+    // renderCube's cube spans -1 to 1 on every axis.
+    struct SceneCube {
+        glm::mat4 model;
+        unsigned int texture;
+    };
+    std::vector<SceneCube> sceneCubes;
+    // Large cube that acts as a floor
+    glm::mat4 model{ glm::mat4(1.f) };
+    model = glm::translate(model, glm::vec3(0.f, -1.f, 0.f));
+    model = glm::scale(model, glm::vec3(12.5f, .5f, 12.5f));
+    sceneCubes.push_back({ model, woodTexture });
+    // Rest of cubes
+    model = glm::mat4(1.f);
+    model = glm::translate(model, glm::vec3(0.f, 1.5f, 0.f));
+    model = glm::scale(model, glm::vec3(.5f));
+    sceneCubes.push_back({ model, containerTexture });
+
+    model = glm::mat4(1.f);
+    model = glm::translate(model, glm::vec3(2.f, 0.f, 1.f));
+    model = glm::scale(model, glm::vec3(.5f));
+    sceneCubes.push_back({ model, containerTexture });
+
+    model = glm::mat4(1.f);
+    model = glm::translate(model, glm::vec3(-1.f, -1.f, 2.f));
+    model = glm::rotate(model, glm::radians(60.f), glm::normalize(glm::vec3(1.f, 0.f, 1.f)));
+    sceneCubes.push_back({ model, containerTexture });
+
+    model = glm::mat4(1.f);
+    model = glm::translate(model, glm::vec3(-0.f, 2.7f, 4.f));
+    model = glm::rotate(model, glm::radians(23.f), glm::normalize(glm::vec3(1.f, 0.f, 1.f)));
+    model = glm::scale(model, glm::vec3(1.25f));
+    sceneCubes.push_back({ model, containerTexture });
+
+    model = glm::mat4(1.f);
+    model = glm::translate(model, glm::vec3(-2.f, 1.f, -3.f));
+    model = glm::rotate(model, glm::radians(124.f), glm::normalize(glm::vec3(1.f, 0.f, 1.f)));
+    sceneCubes.push_back({ model, containerTexture });
+
+    model = glm::mat4(1.f);
+    model = glm::translate(model, glm::vec3(-3.f, 0.f, 0.f));
+    model = glm::scale(model, glm::vec3(.5f));
+    sceneCubes.push_back({ model, containerTexture });
+
+    const AABB unitCube{ .min = glm::vec3(-1.f), .max = glm::vec3(1.f) };
+    AABBArray sceneCubeBounds;
+    for(const auto& cube : sceneCubes) {
+        sceneCubeBounds.push(transformAABB(unitCube, cube.model));
+    }
+    SphereArray lightBounds;
+    for(const auto& position : lightPositions) {
+        lightBounds.push(BoundingSphere{ .centre = position, .radius = std::sqrt(3.f) * .25f });
+    }
+    std::vector<std::uint32_t> visibleCubes(sceneCubes.size());
+    std::vector<std::uint32_t> visibleLights(lightPositions.size());
+
     // Setting textures for all shaders.
     shader.use();
     shader.setUniformInt("diffuseTexture", 0);
-    shaderBlur.use();
-    shaderBlur.setUniformInt("image", 0);
     shaderBloomFinal.use();
     shaderBloomFinal.setUniformInt("scene", 0);
     shaderBloomFinal.setUniformInt("bloomBlur", 1);
-
+    shaderSkybox.use();
+    shaderSkybox.setUniformInt("skybox", 0);
+    shader.bindUniformBlock("Camera", CameraUniformBinding);
+    shaderLight.bindUniformBlock("Camera", CameraUniformBinding);
+    shaderSkybox.bindUniformBlock("Camera", CameraUniformBinding);
+
+    lastFrame = glfwGetTime();
+    glm::vec3 previousCameraPosition{ camera.position() };
+    // Latching late keeps a single frame in flight: the wait at the top of the frame holds it back until the GPU is
+    // done with the last one, so the input sampled right after is as fresh as it can be when it reaches the screen.
+    auto frameUniforms = std::make_unique<FrameUniforms>(lateLatch ? 1 : 3);
+    // A played back flight writes out every frame's times, otherwise the last few are enough.
+    auto frameTimer = std::make_unique<FrameTimer>(4, playingBack);
+    auto inputSampled = std::chrono::steady_clock::now();
+    std::size_t playbackStep{ 0 };
     while(!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
+        frameUniforms->beginFrame();
+        if(lateLatch) {
+            glfwPollEvents();
+            inputSampled = std::chrono::steady_clock::now();
+        }
+
+        const double currentFrame{ glfwGetTime() };
+        const unsigned int steps{ timestep.advance(currentFrame - lastFrame) };
         lastFrame = currentFrame;
 
-        processInput(window);
+        if(playingBack) {
+            // One recorded step per frame however long frames take, so every run draws the same frames.
+            if(playbackStep == cameraPath.samples.size() || glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+                break;
+            }
+            const CameraSample& sample = cameraPath.samples[playbackStep++];
+            camera.setPose(sample.position, sample.yaw, sample.pitch, sample.zoom);
+            previousCameraPosition = camera.position();
+            inputSampled = std::chrono::steady_clock::now();
+        } else {
+            // Input moves the camera in fixed steps, the frame is drawn from between the last two of them.
+            for(unsigned int i{ 0 }; i < steps; ++i) {
+                previousCameraPosition = camera.position();
+                processInput(window, timestep.step());
+                if(!recordPath.empty()) {
+                    cameraPath.samples.push_back({ camera.position(), camera.yaw(), camera.pitch(), camera.zoom() });
+                }
+            }
+        }
+        frameTimer->beginFrame(inputSampled);
+        const float renderScale{ dynamicResolution.update(*frameTimer) };
+        const RenderTargetDesc hdrTarget{
+            dynamicResolution.scaled({ framebufferWidth, framebufferHeight, GL_RGBA16F }) };
+        const RenderTargetDesc depthTarget{ hdrTarget.width, hdrTarget.height, GL_DEPTH_COMPONENT24 };
+        QuaternionCamera renderCamera{ camera };
+        renderCamera.setPosition(glm::mix(previousCameraPosition, camera.position(), timestep.alpha()));
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glClearColor(.1f, .1f, .1f, 1.f);
 
-        // 1. Render scene into floating point framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Culling and drawing share the camera's matrices, each built at most once this frame.
+        const Frustum& frustum = renderCamera.frustum();
+        // Only what the camera can see is drawn, or has its textures streamed in.
+        const std::size_t visibleCubeCount{ cullAABBs(frustum, sceneCubeBounds, visibleCubes.data()) };
+        const std::size_t visibleLightCount{ cullSpheres(frustum, lightBounds, visibleLights.data()) };
+        // The camera reaches every shader in this one write, right before the first draw that uses it.
+        frameUniforms->write(CameraUniforms{
+            .projection = renderCamera.projection(),
+            .view = renderCamera.view(),
+            .viewPosition = renderCamera.position(),
+        });
+
+        // 1. Render scene into floating point framebuffer, the bright fragments into a second one
+        FrameResource sceneColour{}, brightColour{};
+        frameGraph->addPass("scene", [&](FramePassBuilder& pass) {
+            sceneColour = pass.createColour("scene colour", hdrTarget);
+            brightColour = pass.createColour("bright colour", hdrTarget);
+            pass.createDepth("scene depth", depthTarget);
+        }, [&](const FramePassResources&) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shader.use();
+            // Set lighting positions and colours
+            for(unsigned int i{ 0 }; i < lightPositions.size(); ++i) {
+                shader.setVec3("lights[" + std::to_string(i) + "].position", lightPositions[i]);
+                shader.setVec3("lights[" + std::to_string(i) + "].colour", lightColours[i]);
+            }
+            for(std::size_t i = 0; i < visibleCubeCount; ++i) {
+                const SceneCube& cube = sceneCubes[visibleCubes[i]];
+                bindTexture(0, GL_TEXTURE_2D, cube.texture);
+                shader.setMat4("model", cube.model);
+                requestCubeTextureDetail(renderCamera, cube.texture, cube.model);
+                renderCube();
+            }
 
-        glm::mat4 projection{ glm::perspective(glm::radians(camera.zoom), static_cast<float>(WindowWidth) / WindowHeight, .1f, 100.f) };
-        glm::mat4 view{ camera.getViewMatrix() };
-        shader.use();
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
-        shader.setVec3("viewPosition", camera.position);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, woodTexture);
-        // Set lighting positions and colours
-        for(unsigned int i{ 0 }; i < lightPositions.size(); ++i) {
-            shader.setVec3("lights[" + std::to_string(i) + "].position", lightPositions[i]);
-            shader.setVec3("lights[" + std::to_string(i) + "].colour", lightColours[i]);
-        }
-        // Create large cube that acts as a floor
-        glm::mat4 model{ glm::mat4(1.f) };
-        model = glm::translate(model, glm::vec3(0.f, -1.f, 0.f));
-        model = glm::scale(model, glm::vec3(12.5f, .5f, 12.5f));
-        shader.setMat4("model", model);
-        renderCube();
-        // Rest of cubes
-        glBindTexture(GL_TEXTURE_2D, containerTexture);
-        model = glm::mat4(1.f);
-        model = glm::translate(model, glm::vec3(0.f, 1.5f, 0.f));
-        model = glm::scale(model, glm::vec3(.5f));
-        shader.setMat4("model", model);
-        renderCube();
-
-        model = glm::mat4(1.f);
-        model = glm::translate(model, glm::vec3(2.f, 0.f, 1.f));
-        model = glm::scale(model, glm::vec3(.5f));
-        shader.setMat4("model", model);
-        renderCube();
-
-        model = glm::mat4(1.f);
-        model = glm::translate(model, glm::vec3(-1.f, -1.f, 2.f));
-        model = glm::rotate(model, glm::radians(60.f), glm::normalize(glm::vec3(1.f, 0.f, 1.f)));
-        shader.setMat4("model", model);
-        renderCube();
-
-        model = glm::mat4(1.f);
-        model = glm::translate(model, glm::vec3(-0.f, 2.7f, 4.f));
-        model = glm::rotate(model, glm::radians(23.f), glm::normalize(glm::vec3(1.f, 0.f, 1.f)));
-        model = glm::scale(model, glm::vec3(1.25f));
-        shader.setMat4("model", model);
-        renderCube();
-
-        model = glm::mat4(1.f);
-        model = glm::translate(model, glm::vec3(-2.f, 1.f, -3.f));
-        model = glm::rotate(model, glm::radians(124.f), glm::normalize(glm::vec3(1.f, 0.f, 1.f)));
-        shader.setMat4("model", model);
-        renderCube();
-
-        model = glm::mat4(1.f);
-        model = glm::translate(model, glm::vec3(-3.f, 0.f, 0.f));
-        model = glm::scale(model, glm::vec3(.5f));
-        shader.setMat4("model", model);
-        renderCube();
-
-        // Show all light sources as bright cubes
-        shaderLight.use();
-        shaderLight.setMat4("projection", projection);
-        shaderLight.setMat4("view", view);
-        for(unsigned int i{ 0 }; i < lightPositions.size(); ++i) {
-            model = glm::mat4(1.f);
-            model = glm::translate(model, glm::vec3(lightPositions[i]));
-            model = glm::scale(model, glm::vec3(0.25f));
-            shaderLight.setMat4("model", model);
-            shaderLight.setVec3("lightColour", lightColours[i]);
+            // Show all light sources as bright cubes
+            shaderLight.use();
+            for(std::size_t i = 0; i < visibleLightCount; ++i) {
+                const std::uint32_t light{ visibleLights[i] };
+                model = glm::mat4(1.f);
+                model = glm::translate(model, glm::vec3(lightPositions[light]));
+                model = glm::scale(model, glm::vec3(0.25f));
+                shaderLight.setMat4("model", model);
+                shaderLight.setVec3("lightColour", lightColours[light]);
+                renderCube();
+            }
+
+            // Skybox last so it only shades what nothing else covers. It sits at depth 1, which only passes with
+            // LEQUAL.
+            glDepthFunc(GL_LEQUAL);
+            shaderSkybox.use();
+            bindTexture(0, GL_TEXTURE_CUBE_MAP, skyboxTexture);
             renderCube();
-        }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-        // 2. Blur bright fragments with two-pass Gaussian blur
-        bool horizontal{ true }, firstIteration{ true };
-        constexpr unsigned int passes{ 10 };
-        shaderBlur.use();
-        for(unsigned int i{ 0 }; i < passes; ++i) {
-            glBindFramebuffer(GL_FRAMEBUFFER, pingPongFBO[horizontal]);
-            shaderBlur.setUniformInt("horizontal", horizontal);
-            glBindTexture(GL_TEXTURE_2D, firstIteration ? colourBuffers[1] : pingPongColourBuffers[!horizontal]);
-            renderQuad();
-            horizontal = !horizontal;
-            if(firstIteration) {
-                firstIteration = false;
+            glDepthFunc(GL_LESS);
+        });
+
+        // 2. Blur bright fragments. With bloom off nothing reads the result, and the graph culls the lot.
+        const FrameResource blurred{ bloomPasses->addPasses(*frameGraph, brightColour, hdrTarget, bloomMode) };
+
+        // 3. Now render floating point colour buffer to 2D quad and tonemap HDR colours to default's framebuffer LDR,
+        // upscaling it if it was drawn at a lower resolution
+        frameGraph->addPass("tonemap", [&](FramePassBuilder& pass) {
+            pass.read(sceneColour);
+            if(bloom) {
+                pass.read(blurred);
             }
+            pass.writeBackbuffer();
+        }, [&](const FramePassResources& resources) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shaderBloomFinal.use();
+            bindTexture(0, GL_TEXTURE_2D, resources.texture(sceneColour));
+            bindTexture(1, GL_TEXTURE_2D, bloom ? resources.texture(blurred) : 0);
+            shaderBloomFinal.setUniformBool("bloom", bloom);
+            shaderBloomFinal.setUniformFloat("bloomStrength", Bloom::strength(bloomMode));
+            shaderBloomFinal.setUniformFloat("exposure", exposure);
+            // Bilinear filtering softens what it upscales, the further the more.
+            shaderBloomFinal.setUniformFloat("sharpness", 1.f - renderScale);
+            renderQuad();
+        });
+        frameGraph->execute();
+        // Targets of the size before a rescale or a resize would sit in the pool a while, next to the new ones.
+        if(hdrTarget != previousHdrTarget) {
+            frameGraph->trim();
+            previousHdrTarget = hdrTarget;
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // 3. Now render floating point colour buffer to 2D quad and tonemap HDR colours to default's framebuffer LDR
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        shaderBloomFinal.use();
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, colourBuffers[0]);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, pingPongColourBuffers[!horizontal]);
-        shaderBloomFinal.setUniformBool("bloom", bloom);
-        shaderBloomFinal.setUniformFloat("exposure", exposure);
-        renderQuad();
+        textureStreamer->update();
+        textureManager->nextFrame();
 
+        frameTimer->endFrame();
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        frameTimer->presented();
+        frameUniforms->endFrame();
+        if(!lateLatch) {
+            glfwPollEvents();
+            inputSampled = std::chrono::steady_clock::now();
+        }
+    }
+
+    const TextureMemoryStats& textureMemory = textureManager->stats();
+    std::cout << "Texture memory: peak " << textureMemory.peakGpuBytes / (1024 * 1024) << " MiB GPU, "
+              << textureMemory.peakCpuBytes / (1024 * 1024) << " MiB CPU, " << textureMemory.evictedLevels
+              << " levels and " << textureMemory.evictedTextures << " whole textures evicted\n";
+    const FrameGraphStats& frameGraphStats = frameGraph->stats();
+    std::cout << "Render targets: peak " << frameGraphStats.peakPooledBytes / (1024 * 1024) << " MiB through the frame "
+              << "graph, " << handAllocatedTargetBytes / (1024 * 1024) << " MiB set up by hand. The last frame ran "
+              << frameGraphStats.passes - frameGraphStats.culledPasses << " of " << frameGraphStats.passes
+              << " passes and declared " << frameGraphStats.transientBytes / (1024 * 1024) << " MiB of targets in "
+              << frameGraphStats.pooledBytes / (1024 * 1024) << " MiB\n";
+
+    if(!recordPath.empty() && writeCameraPath(recordPath, cameraPath)) {
+        std::cout << "Recorded " << cameraPath.samples.size() << " steps to " << recordPath << '\n';
+    }
+    frameTimer->finish();
+    const RenderScaleStats& scaleStats = dynamicResolution.stats();
+    if(scaleStats.frames > 0) {
+        std::cout << "Render scale: " << scaleStats.scaleSum / static_cast<double>(scaleStats.frames) << " on average, "
+                  << scaleStats.lowestScale << " at lowest, " << scaleStats.belowFullFrames
+                  << " frames below full resolution for a " << gpuBudgetMs << " ms GPU budget\n";
+    }
+    const FrameTimingTotals& totals = frameTimer->totals();
+    const auto average = [](const double sum, const std::size_t count) {
+        return sum / static_cast<double>(std::max<std::size_t>(1, count));
+    };
+    std::cout << totals.frames << " frames: " << average(totals.cpuMs, totals.frames) << " ms CPU, "
+              << average(totals.gpuMs, totals.gpuFrames) << " ms GPU per frame on average, input to present "
+              << average(totals.latencyMs, totals.latencyFrames) << " ms on average and " << totals.worstLatencyMs
+              << " ms at worst\n";
+    if(playingBack) {
+        static_cast<void>(writeFrameTimings(playPath + ".timings.csv", *frameTimer));
     }
 
+    // These hold GL objects, which have to be deleted while there is still a context.
+    frameTimer.reset();
+    frameUniforms.reset();
+    bloomPasses.reset();
+    frameGraph.reset();
+    setTextureStreamer(nullptr);
+    textureStreamer.reset();
+    setTextureManager(nullptr);
+    textureManager.reset();
+
     glfwTerminate();
     return EXIT_SUCCESS;
 }
 
-void processInput(GLFWwindow *window) {
+void processInput(GLFWwindow *window, const float deltaTime) {
     if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     } else if(glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
@@ -284,6 +515,9 @@ void processInput(GLFWwindow *window) {
         std::cout << "You're getting here\n";
         bloom = !bloom;
         bloomKeyPressed = true;
+    } else if(glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS && !bloomModeKeyPressed) {
+        bloomMode = bloomMode == BloomMode::PROGRESSIVE ? BloomMode::GAUSSIAN : BloomMode::PROGRESSIVE;
+        bloomModeKeyPressed = true;
     } else if(glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
         if(exposure > 0.f) {
             exposure -= .001f;
@@ -297,13 +531,25 @@ void processInput(GLFWwindow *window) {
     if(glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_RELEASE) {
         bloomKeyPressed = false;
     }
+    if(glfwGetKey(window, GLFW_KEY_B) == GLFW_RELEASE) {
+        bloomModeKeyPressed = false;
+    }
 }
 
 void framebuffer_size_callback([[maybe_unused]]GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
+    framebufferWidth = width;
+    framebufferHeight = height;
+    // Minimised windows are 0 high.
+    if(height > 0) {
+        camera.setAspect(static_cast<float>(width) / static_cast<float>(height));
+    }
 }
 
 void mouse_callback([[maybe_unused]]GLFWwindow* window, double xposIn, double yposIn) {
+    if(playingBack) {
+        return;
+    }
     float xpos{ static_cast<float>(xposIn) };
     float ypos{ static_cast<float>(yposIn) };
 
@@ -323,45 +569,10 @@ void mouse_callback([[maybe_unused]]GLFWwindow* window, double xposIn, double yp
 }
 
 void scroll_callback([[maybe_unused]]GLFWwindow* window, [[maybe_unused]]double xoffset, double yoffset) {
-    camera.processMouseScroll(static_cast<float>(yoffset));
-}
-
-unsigned int loadTexture(const std::string& path, const bool gammaCorrection) {
-    unsigned int textureID{ 0 };
-    glGenTextures(1, &textureID);
-
-    int width{ 0 }, height{ 0 }, nrComponents{ 0 };
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
-    if (!data) {
-        std::cerr << "Texture failed to load at path: " << path << '\n';
-        stbi_image_free(data);
-    }
-
-    GLenum format{ GL_RED };
-    GLenum internalFormat{ GL_RED };
-
-    if(nrComponents == 1) {
-        internalFormat = format = GL_RED;
-    } else if(nrComponents == 3) {
-        internalFormat = gammaCorrection ? GL_SRGB : GL_RGB;
-        format = GL_RGB;
-    } else if(nrComponents == 4) {
-        internalFormat = gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
-        format = GL_RGBA;
+    if(playingBack) {
+        return;
     }
-
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    stbi_image_free(data);
-
-    return textureID;
+    camera.processMouseScroll(static_cast<float>(yoffset));
 }
 
 static void renderCube() {
@@ -430,6 +641,15 @@ static void renderCube() {
     glBindVertexArray(0);
 }
 
+// renderCube's cube spans -1 to 1 on every axis. view is the camera the frame is drawn from, not the simulated one.
+static void requestCubeTextureDetail(const QuaternionCamera& view, const unsigned int texture, const glm::mat4& model) {
+    static const BoundingSphere cube{ glm::vec3(0.f), std::sqrt(3.f) };
+    if(TextureStreamer* streamer = activeTextureStreamer()) {
+        const float screenHeight{ static_cast<float>(framebufferHeight) };
+        streamer->request(texture, view.projectedSize(transformSphere(cube, model), screenHeight));
+    }
+}
+
 static void renderQuad() {
     static unsigned int quadVAO{ 0 }, quadVBO{ 0 };
     if(quadVAO == 0) {
@@ -0,0 +1,3 @@
+// stb_image is header only, its implementation lives here so tools can link it without main.cpp.
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
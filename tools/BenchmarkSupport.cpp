@@ -0,0 +1,81 @@
+#include "BenchmarkSupport.hpp"
+
+#include <EGL/eglext.h>
+
+#include <array>
+#include <cstdio>
+#include <iostream>
+
+// Control characters can't appear raw in a JSON string.
+std::string escapeJson(const std::string& text) {
+    std::string result;
+    for(const char c : text) {
+        const auto byte{ static_cast<unsigned char>(c) };
+        if(c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if(c == '\n') {
+            result += "\\n";
+        } else if(c == '\t') {
+            result += "\\t";
+        } else if(byte < 0x20) {
+            std::array<char, 7> escaped{};
+            std::snprintf(escaped.data(), escaped.size(), "\\u%04x", static_cast<unsigned int>(byte));
+            result += escaped.data();
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+double secondsSince(const std::chrono::steady_clock::time_point start) {
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+bool createHeadlessContext(HeadlessContext& headless) {
+    const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    headless.display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                                          : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(headless.display == EGL_NO_DISPLAY || !eglInitialize(headless.display, nullptr, nullptr)) {
+        std::cerr << "Failed to initialize EGL\n";
+        return false;
+    }
+
+    // No surface type, the default asks for window surfaces, which the surfaceless platform has none of.
+    const EGLint configAttributes[]{ EGL_SURFACE_TYPE, 0, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config{ nullptr };
+    EGLint configs{ 0 };
+    if(!eglChooseConfig(headless.display, configAttributes, &config, 1, &configs) || configs == 0 ||
+       !eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "No EGL config for desktop OpenGL\n";
+        return false;
+    }
+
+    const EGLint contextAttributes[]{
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE,
+    };
+    headless.context = eglCreateContext(headless.display, config, EGL_NO_CONTEXT, contextAttributes);
+    if(headless.context == EGL_NO_CONTEXT ||
+       !eglMakeCurrent(headless.display, EGL_NO_SURFACE, EGL_NO_SURFACE, headless.context)) {
+        std::cerr << "Failed to create a surfaceless OpenGL 3.3 context\n";
+        return false;
+    }
+    return true;
+}
+
+void destroyHeadlessContext(const HeadlessContext& headless) {
+    if(headless.display == EGL_NO_DISPLAY) {
+        return;
+    }
+    eglMakeCurrent(headless.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if(headless.context != EGL_NO_CONTEXT) {
+        eglDestroyContext(headless.display, headless.context);
+    }
+    eglTerminate(headless.display);
+}
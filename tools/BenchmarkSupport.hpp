@@ -0,0 +1,24 @@
+#pragma once
+
+#include <EGL/egl.h>
+
+#include <chrono>
+#include <string>
+
+// Helpers the benchmarks and the import profiler share. Tools linking BenchmarkSupport.o link EGL too.
+
+// text escaped for use inside a JSON string.
+[[nodiscard]] std::string escapeJson(const std::string& text);
+
+[[nodiscard]] double secondsSince(std::chrono::steady_clock::time_point start);
+
+struct HeadlessContext {
+    EGLDisplay display{ EGL_NO_DISPLAY };
+    EGLContext context{ EGL_NO_CONTEXT };
+};
+
+// Makes a desktop OpenGL 3.3 core context current on Mesa's surfaceless platform, which needs neither a display server
+// nor a window. There is no surface, so anything drawn has to go into a framebuffer of the caller's. Load GL through
+// eglGetProcAddress afterwards. On failure, whatever was created is still in headless for destroyHeadlessContext.
+bool createHeadlessContext(HeadlessContext& headless);
+void destroyHeadlessContext(const HeadlessContext& headless);
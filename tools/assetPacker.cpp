@@ -0,0 +1,149 @@
+// Builds a pack out of every file under an assets directory, see AssetPack.hpp for the layout.
+//
+// Usage: asset_packer [assetsDirectory] [output]
+// Defaults to ./assets and ./assets.pack, which is where the app looks for it.
+
+#include <AssetPack.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Entries this big start on a page of their own, so the mapping of one never drags in the tail of another.
+static constexpr std::size_t PageAlignedBytes{ 64 * 1024 };
+static constexpr std::uint16_t PageAlignmentLog2{ 12 };
+// Enough for SIMD loads over the start of any entry.
+static constexpr std::uint16_t DefaultAlignmentLog2{ 4 };
+// Compression has to save at least an eighth to be worth inflating at load time. JPEG and PNG data rarely do.
+static constexpr std::size_t MinCompressionSaving{ 8 };
+
+struct PackedFile {
+    std::string path;
+    PackEntry entry;
+    std::vector<char> data;
+};
+
+static bool readFile(const std::filesystem::path& path, std::vector<char>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open()) {
+        std::cerr << "Could not open " << path << '\n';
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static void compressIfSmaller(PackedFile& packed) {
+    uLongf compressedSize{ compressBound(static_cast<uLong>(packed.data.size())) };
+    std::vector<char> compressed(compressedSize);
+    if(compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize,
+                 reinterpret_cast<const Bytef*>(packed.data.data()), static_cast<uLong>(packed.data.size()),
+                 Z_BEST_COMPRESSION) != Z_OK) {
+        return;
+    }
+
+    if(compressedSize > packed.data.size() - packed.data.size() / MinCompressionSaving) {
+        return;
+    }
+
+    compressed.resize(compressedSize);
+    packed.data = std::move(compressed);
+    packed.entry.flags |= PACK_COMPRESSED;
+}
+
+static void writePadding(std::ofstream& out, const std::uint16_t alignmentLog2) {
+    const auto alignment = static_cast<std::uint64_t>(1) << alignmentLog2;
+    const auto position = static_cast<std::uint64_t>(out.tellp());
+    const auto padding = (alignment - position % alignment) % alignment;
+    static constexpr char zeros[4096]{};
+    out.write(zeros, static_cast<std::streamsize>(padding));
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path assetsDirectory{ argc > 1 ? argv[1] : "./assets" };
+    const std::string outputPath{ argc > 2 ? argv[2] : "./assets.pack" };
+
+    std::vector<std::filesystem::path> paths;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(assetsDirectory)) {
+        if(entry.is_regular_file()) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if(!out.is_open()) {
+        std::cerr << "Could not create " << outputPath << '\n';
+        return EXIT_FAILURE;
+    }
+
+    PackHeader header{};
+    std::memcpy(header.magic, PackMagic, sizeof(PackMagic));
+    header.version = PackVersion;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::printf("%-52s %12s %12s %6s\n", "path", "bytes", "stored", "align");
+
+    // Files are written one at a time, only the index is kept until the end.
+    std::vector<PackedFile> index;
+    std::uint64_t totalBytes{ 0 };
+    for(const auto& path : paths) {
+        PackedFile packed;
+        packed.path = normaliseAssetPath(path.string());
+        if(!readFile(path, packed.data)) {
+            return EXIT_FAILURE;
+        }
+
+        packed.entry = {};
+        packed.entry.size = packed.data.size();
+        compressIfSmaller(packed);
+        packed.entry.storedSize = packed.data.size();
+        packed.entry.pathLength = static_cast<std::uint32_t>(packed.path.size());
+        packed.entry.alignmentLog2 = !(packed.entry.flags & PACK_COMPRESSED) && packed.entry.size >= PageAlignedBytes ?
+                                     PageAlignmentLog2 : DefaultAlignmentLog2;
+
+        writePadding(out, packed.entry.alignmentLog2);
+        packed.entry.offset = static_cast<std::uint64_t>(out.tellp());
+        out.write(packed.data.data(), static_cast<std::streamsize>(packed.data.size()));
+
+        std::printf("%-52s %12llu %12llu %6u%s\n", packed.path.c_str(),
+                    static_cast<unsigned long long>(packed.entry.size),
+                    static_cast<unsigned long long>(packed.entry.storedSize), 1u << packed.entry.alignmentLog2,
+                    packed.entry.flags & PACK_COMPRESSED ? " zlib" : "");
+
+        totalBytes += packed.entry.size;
+        packed.data.clear();
+        packed.data.shrink_to_fit();
+        index.push_back(std::move(packed));
+    }
+
+    writePadding(out, DefaultAlignmentLog2);
+    header.indexOffset = static_cast<std::uint64_t>(out.tellp());
+    header.entryCount = static_cast<std::uint32_t>(index.size());
+    for(const auto& packed : index) {
+        out.write(reinterpret_cast<const char*>(&packed.entry), sizeof(packed.entry));
+        out.write(packed.path.data(), static_cast<std::streamsize>(packed.path.size()));
+    }
+    header.indexSize = static_cast<std::uint64_t>(out.tellp()) - header.indexOffset;
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if(!out) {
+        std::cerr << "Could not write " << outputPath << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::printf("\n%u files, %.1f MiB of assets into %.1f MiB: %s\n", header.entryCount,
+                static_cast<double>(totalBytes) / (1024.0 * 1024.0),
+                static_cast<double>(std::filesystem::file_size(outputPath)) / (1024.0 * 1024.0), outputPath.c_str());
+    return EXIT_SUCCESS;
+}
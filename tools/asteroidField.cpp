@@ -0,0 +1,229 @@
+// Renders the planet inside a ring of instanced rocks and reports frame times for each instance count, as a table and
+// then as JSON. Vsync is off and the camera orbits on its own, so runs are comparable between machines and builds.
+//
+// Usage: asteroid_field [--pack-textures] [frames] [instances...]
+// Defaults to 600 frames each for 100000, 250000, 500000 and 1000000 rocks. --pack-textures moves each model's
+// textures into texture arrays and draws them with shaders/modelPacked.fs instead.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <Model.hpp>
+#include <Shader.hpp>
+#include <GLExtensions.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static constexpr unsigned int WindowWidth{ 1920 };
+static constexpr unsigned int WindowHeight{ 1080 };
+// Frames rendered before timing starts, so buffer uploads and shader compilation don't count.
+static constexpr unsigned int WarmupFrames{ 30 };
+// Timer queries are read back this many frames late so we never wait on the GPU.
+static constexpr unsigned int QueryLatency{ 4 };
+
+struct FieldStats {
+    unsigned int instances;
+    double averageMs;
+    double medianMs;
+    double worstPercentileMs;
+    double gpuMs;
+};
+
+// Rocks are scattered around a ring, the ring gets wider with the count so the density stays about the same.
+static std::vector<glm::mat4> makeRing(const unsigned int count) {
+    std::mt19937 random{ count };
+    std::uniform_real_distribution<float> unit{ 0.f, 1.f };
+
+    const float radius{ 50.f + std::sqrt(static_cast<float>(count)) * 0.15f };
+    const float offset{ 2.5f + std::sqrt(static_cast<float>(count)) * 0.02f };
+
+    std::vector<glm::mat4> transforms(count);
+    for(unsigned int i = 0; i < count; ++i) {
+        const float angle{ static_cast<float>(i) / static_cast<float>(count) * 360.f };
+        const float x{ std::sin(glm::radians(angle)) * radius + (unit(random) * 2.f - 1.f) * offset };
+        const float y{ (unit(random) * 2.f - 1.f) * offset * 0.4f };
+        const float z{ std::cos(glm::radians(angle)) * radius + (unit(random) * 2.f - 1.f) * offset };
+
+        glm::mat4 model{ glm::translate(glm::mat4(1.f), glm::vec3(x, y, z)) };
+        model = glm::scale(model, glm::vec3(0.05f + unit(random) * 0.2f));
+        model = glm::rotate(model, unit(random) * glm::two_pi<float>(), glm::vec3(0.4f, 0.6f, 0.8f));
+        transforms[i] = model;
+    }
+
+    return transforms;
+}
+
+static double percentile(std::vector<double> values, const double fraction) {
+    std::sort(values.begin(), values.end());
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+int main(int argc, char** argv) {
+    bool packTextures{ false };
+    std::vector<std::string> arguments;
+    for(int i = 1; i < argc; ++i) {
+        const std::string argument{ argv[i] };
+        if(argument == "--pack-textures") {
+            packTextures = true;
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+
+    const unsigned int frames{ !arguments.empty() ? static_cast<unsigned int>(std::stoul(arguments[0])) : 600 };
+    std::vector<unsigned int> counts;
+    for(std::size_t i = 1; i < arguments.size(); ++i) {
+        counts.push_back(static_cast<unsigned int>(std::stoul(arguments[i])));
+    }
+    if(counts.empty()) {
+        counts = { 100'000, 250'000, 500'000, 1'000'000 };
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    auto* window = glfwCreateWindow(WindowWidth, WindowHeight, "asteroid_field", nullptr, nullptr);
+    if(!window) {
+        std::cerr << "Failed to create GLFW window\n";
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        return EXIT_FAILURE;
+    }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    glEnable(GL_DEPTH_TEST);
+
+    Model planet("./assets/planet/planet.obj");
+    Model rock("./assets/rock/rock.obj");
+
+    // A model that can't be packed keeps its plain shader, the vertex shaders stay the same either way.
+    const bool planetPacked{ packTextures && planet.packTextures() };
+    const bool rockPacked{ packTextures && rock.packTextures() };
+    if(packTextures && !(planetPacked && rockPacked)) {
+        std::cerr << "Could not pack the " << (planetPacked ? "rock's" : "planet's") << " textures\n";
+    }
+    const ShaderDefines unlit{ "#define UNLIT\n" };
+    Shader planetShader{ planetPacked ? Shader("./shaders/planetShader.vs", "./shaders/modelPacked.fs", unlit)
+                                      : Shader("./shaders/planetShader.vs", "./shaders/planetShader.fs") };
+    Shader asteroidShader{ rockPacked ? Shader("./shaders/asteroidShader.vs", "./shaders/modelPacked.fs", unlit)
+                                      : Shader("./shaders/asteroidShader.vs", "./shaders/asteroidShader.fs") };
+
+    std::array<unsigned int, QueryLatency> queries;
+    glGenQueries(QueryLatency, queries.data());
+
+    std::vector<FieldStats> results;
+    for(const unsigned int count : counts) {
+        const auto transforms = makeRing(count);
+        rock.setInstanceTransforms(transforms);
+
+        const float radius{ 50.f + std::sqrt(static_cast<float>(count)) * 0.15f };
+        const glm::mat4 projection{ glm::perspective(glm::radians(45.f), static_cast<float>(WindowWidth) / WindowHeight,
+                                                     0.1f, radius * 4.f) };
+
+        std::vector<double> frameMs;
+        std::vector<double> gpuMs;
+        frameMs.reserve(frames);
+        gpuMs.reserve(frames);
+
+        auto previous = std::chrono::steady_clock::now();
+        for(unsigned int frame = 0; frame < WarmupFrames + frames && !glfwWindowShouldClose(window); ++frame) {
+            const unsigned int query{ queries[frame % QueryLatency] };
+            if(frame >= WarmupFrames + QueryLatency) {
+                GLuint64 nanoseconds{ 0 };
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+                gpuMs.push_back(static_cast<double>(nanoseconds) / 1e6);
+            }
+
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            glClearColor(0.05f, 0.05f, 0.05f, 1.f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            const float orbit{ static_cast<float>(frame) * 0.002f };
+            const glm::vec3 eye{ std::sin(orbit) * radius * 1.6f, radius * 0.35f, std::cos(orbit) * radius * 1.6f };
+            const glm::mat4 view{ glm::lookAt(eye, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f)) };
+
+            planetShader.use();
+            planetShader.setMat4("projection", projection);
+            planetShader.setMat4("view", view);
+            planetShader.setMat4("model", glm::scale(glm::mat4(1.f), glm::vec3(4.f + radius * 0.05f)));
+            planet.draw(planetShader);
+
+            asteroidShader.use();
+            asteroidShader.setMat4("projection", projection);
+            asteroidShader.setMat4("view", view);
+            rock.drawInstanced(asteroidShader);
+            glEndQuery(GL_TIME_ELAPSED);
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+
+            const auto now = std::chrono::steady_clock::now();
+            if(frame >= WarmupFrames) {
+                frameMs.push_back(std::chrono::duration<double, std::milli>(now - previous).count());
+            }
+            previous = now;
+        }
+
+        if(frameMs.empty()) {
+            break;
+        }
+
+        double total{ 0.0 };
+        for(const double ms : frameMs) {
+            total += ms;
+        }
+        double gpuTotal{ 0.0 };
+        for(const double ms : gpuMs) {
+            gpuTotal += ms;
+        }
+
+        results.push_back({
+            .instances = count,
+            .averageMs = total / static_cast<double>(frameMs.size()),
+            .medianMs = percentile(frameMs, 0.5),
+            .worstPercentileMs = percentile(frameMs, 0.99),
+            .gpuMs = gpuMs.empty() ? 0.0 : gpuTotal / static_cast<double>(gpuMs.size()),
+        });
+    }
+
+    glDeleteQueries(QueryLatency, queries.data());
+
+    std::printf("%12s %10s %10s %10s %10s %10s\n", "instances", "avg ms", "p50 ms", "p99 ms", "gpu ms", "fps");
+    for(const auto& result : results) {
+        std::printf("%12u %10.3f %10.3f %10.3f %10.3f %10.1f\n", result.instances, result.averageMs, result.medianMs,
+                    result.worstPercentileMs, result.gpuMs, 1000.0 / result.averageMs);
+    }
+
+    std::printf("\n[\n");
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::printf("  { \"instances\": %u, \"avgMs\": %.4f, \"p50Ms\": %.4f, \"p99Ms\": %.4f, \"gpuMs\": %.4f }%s\n",
+                    result.instances, result.averageMs, result.medianMs, result.worstPercentileMs, result.gpuMs,
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("]\n");
+
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+// Runs the bloom passes on a synthetic HDR frame, a dim background with bright rectangles of a few sizes, once per
+// bloom mode, Gaussian kernel, resolution and fragment or compute shader blur, and once with bloom off, on a headless
+// Mesa context through EGL. Prints the GPU time per frame from timer queries, the texture fetches and what the frame
+// graph moved to and from render targets, and writes every mode's tonemapped frame as a PPM so they can be compared by
+// eye, along with how much light each one spreads next to the Gaussian bloom.
+//
+// Usage: bloom_benchmark [width] [height] [frames]
+// Defaults to 1920x1080 and 10 frames. Pass 3840 2160 for 4K.
+
+#include <glad/glad.h>
+
+#include <Bloom.hpp>
+#include <FrameGraph.hpp>
+#include <GLExtensions.hpp>
+#include <Shader.hpp>
+#include <TextureManager.hpp>
+
+#include "BenchmarkSupport.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct BenchmarkMode {
+    const char* name;
+    bool bloom;
+    BloomMode mode;
+    GaussianBlurSettings gaussian;
+};
+
+struct ModeResult {
+    double gpuMs{ 0.0 };
+    double energy{ 0.0 };
+    std::size_t fetches{ 0 };
+    FrameGraphStats stats;
+    std::vector<unsigned char> pixels;
+};
+
+// The Gaussian with a tap per texel at full resolution is the bloom as it always was, the rest are measured against it.
+// The compute blurs use the same kernel as the Gaussian, so their frames should match its.
+static constexpr std::array<BenchmarkMode, 8> Modes{ {
+    { "off", false, BloomMode::GAUSSIAN, {} },
+    { "gaussian", true, BloomMode::GAUSSIAN,
+      { .radius = 4, .linearSampling = false, .compute = false, .downscale = 1 } },
+    { "linear", true, BloomMode::GAUSSIAN, { .radius = 4, .linearSampling = true, .compute = false, .downscale = 1 } },
+    { "linear-half", true, BloomMode::GAUSSIAN,
+      { .radius = 4, .linearSampling = true, .compute = false, .downscale = 2 } },
+    { "linear-quarter", true, BloomMode::GAUSSIAN,
+      { .radius = 4, .linearSampling = true, .compute = false, .downscale = 4 } },
+    { "compute", true, BloomMode::GAUSSIAN, { .radius = 4, .linearSampling = false, .compute = true, .downscale = 1 } },
+    { "compute-half", true, BloomMode::GAUSSIAN,
+      { .radius = 4, .linearSampling = false, .compute = true, .downscale = 2 } },
+    { "progressive", true, BloomMode::PROGRESSIVE, {} },
+} };
+static constexpr int WarmUpFrames{ 3 };
+
+static void renderQuad() {
+    static unsigned int quadVAO{ 0 }, quadVBO{ 0 };
+    if(quadVAO == 0) {
+        constexpr std::array<float, 20> quadVertices{
+            -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+            -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+             1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+             1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+        };
+        glGenVertexArrays(1, &quadVAO);
+        glGenBuffers(1, &quadVBO);
+        glBindVertexArray(quadVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    }
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+}
+
+// Lights as rectangles cleared into both targets, from a few pixels to a tenth of the frame across, so the bloom has
+// both small hot spots and larger areas to spread.
+static void drawSyntheticScene(const int width, const int height) {
+    constexpr std::array<float, 4> background{ .05f, .05f, .06f, 1.f };
+    constexpr std::array<float, 4> black{ 0.f, 0.f, 0.f, 1.f };
+    glClearBufferfv(GL_COLOR, 0, background.data());
+    glClearBufferfv(GL_COLOR, 1, black.data());
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    struct Light {
+        float x, y, size;
+        std::array<float, 4> colour;
+    };
+    constexpr std::array<Light, 6> lights{ {
+        { .2f, .3f, .005f, { 20.f, 20.f, 20.f, 1.f } },
+        { .5f, .5f, .1f, { 4.f, 1.f, .5f, 1.f } },
+        { .75f, .25f, .02f, { 1.f, 8.f, 1.f, 1.f } },
+        { .8f, .7f, .05f, { 1.f, 1.f, 6.f, 1.f } },
+        { .3f, .8f, .002f, { 50.f, 30.f, 10.f, 1.f } },
+        { .1f, .1f, .03f, { 3.f, 3.f, 3.f, 1.f } },
+    } };
+    glEnable(GL_SCISSOR_TEST);
+    for(const auto& light : lights) {
+        const int size{ std::max(1, static_cast<int>(light.size * static_cast<float>(height))) };
+        glScissor(static_cast<int>(light.x * static_cast<float>(width)) - size / 2,
+                  static_cast<int>(light.y * static_cast<float>(height)) - size / 2, size, size);
+        glClearBufferfv(GL_COLOR, 0, light.colour.data());
+        glClearBufferfv(GL_COLOR, 1, light.colour.data());
+    }
+    glDisable(GL_SCISSOR_TEST);
+}
+
+static bool writePpm(const std::string& path, const std::vector<unsigned char>& rgba, const int width,
+                     const int height) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if(!file) {
+        std::cerr << "::writePpm:: could not create " << path << '\n';
+        return false;
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    // GL's rows start at the bottom.
+    for(int y = height - 1; y >= 0; --y) {
+        for(int x = 0; x < width; ++x) {
+            std::fwrite(&rgba[(static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+                               static_cast<std::size_t>(x)) * 4], 1, 3, file);
+        }
+    }
+    const bool written{ std::ferror(file) == 0 };
+    std::fclose(file);
+    return written;
+}
+
+// What the blurred target adds to the scene, summed over every texel and channel and scaled to full resolution.
+static double bloomEnergy(const unsigned int texture, const float strength, const int width, const int height) {
+    int blurredWidth{ 0 }, blurredHeight{ 0 };
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &blurredWidth);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &blurredHeight);
+    std::vector<float> texels(static_cast<std::size_t>(blurredWidth) * static_cast<std::size_t>(blurredHeight) * 4);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, texels.data());
+
+    double sum{ 0.0 };
+    for(std::size_t i = 0; i < texels.size(); ++i) {
+        if(i % 4 != 3) {
+            sum += static_cast<double>(texels[i]);
+        }
+    }
+    const double texelArea{ static_cast<double>(width) * height / (static_cast<double>(blurredWidth) * blurredHeight) };
+    return sum * strength * texelArea;
+}
+
+static int maxDifference(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b) {
+    int difference{ 0 };
+    for(std::size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        difference = std::max(difference, std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+    return difference;
+}
+
+static double mebibytes(const std::size_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+int main(int argc, char** argv) {
+    const int width{ argc > 1 ? std::stoi(argv[1]) : 1920 };
+    const int height{ argc > 2 ? std::stoi(argv[2]) : 1080 };
+    const int frames{ argc > 3 ? std::max(1, std::stoi(argv[3])) : 10 };
+
+    HeadlessContext headless;
+    if(!createHeadlessContext(headless)) {
+        destroyHeadlessContext(headless);
+        return EXIT_FAILURE;
+    }
+    if(!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        destroyHeadlessContext(headless);
+        return EXIT_FAILURE;
+    }
+    loadGLExtensions((GLADloadproc)eglGetProcAddress);
+
+    if(!dispatchCompute) {
+        std::cerr << "No compute shaders in this context, the compute modes fall back to the fragment shader blur\n";
+    }
+
+    std::vector<ModeResult> results(Modes.size());
+    {
+        auto textureManager = std::make_unique<TextureManager>();
+        setTextureManager(textureManager.get());
+        Bloom bloom;
+        Shader shaderBloomFinal("./shaders/bloomFinal.vs", "./shaders/bloomFinal.fs");
+        shaderBloomFinal.use();
+        shaderBloomFinal.setUniformInt("scene", 0);
+        shaderBloomFinal.setUniformInt("bloomBlur", 1);
+        shaderBloomFinal.setUniformFloat("exposure", 1.f);
+
+        // Stands in for the default framebuffer, which a surfaceless context doesn't have.
+        unsigned int output{ 0 }, outputFBO{ 0 };
+        glGenTextures(1, &output);
+        glBindTexture(GL_TEXTURE_2D, output);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glGenFramebuffers(1, &outputFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output, 0);
+        glViewport(0, 0, width, height);
+        glEnable(GL_DEPTH_TEST);
+
+        unsigned int query{ 0 };
+        glGenQueries(1, &query);
+        const RenderTargetDesc hdrTarget{ width, height, GL_RGBA16F };
+        const RenderTargetDesc depthTarget{ width, height, GL_DEPTH_COMPONENT24 };
+        for(std::size_t m = 0; m < Modes.size(); ++m) {
+            const BenchmarkMode& mode = Modes[m];
+            ModeResult& result = results[m];
+            // A graph of its own, so its pool only holds what this mode needs.
+            FrameGraph frameGraph;
+            unsigned int blurredTexture{ 0 };
+            for(int frame = -WarmUpFrames; frame < frames; ++frame) {
+                FrameResource sceneColour{}, brightColour{};
+                frameGraph.addPass("scene", [&](FramePassBuilder& pass) {
+                    sceneColour = pass.createColour("scene colour", hdrTarget);
+                    brightColour = pass.createColour("bright colour", hdrTarget);
+                    pass.createDepth("scene depth", depthTarget);
+                }, [&](const FramePassResources&) { drawSyntheticScene(width, height); });
+                bloom.gaussian = mode.gaussian;
+                const FrameResource blurred{ bloom.addPasses(frameGraph, brightColour, hdrTarget, mode.mode) };
+                frameGraph.addPass("tonemap", [&](FramePassBuilder& pass) {
+                    pass.read(sceneColour);
+                    if(mode.bloom) {
+                        pass.read(blurred);
+                    }
+                    pass.writeBackbuffer();
+                }, [&](const FramePassResources& resources) {
+                    glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+                    shaderBloomFinal.use();
+                    bindTexture(0, GL_TEXTURE_2D, resources.texture(sceneColour));
+                    blurredTexture = mode.bloom ? resources.texture(blurred) : 0;
+                    bindTexture(1, GL_TEXTURE_2D, blurredTexture);
+                    shaderBloomFinal.setUniformBool("bloom", mode.bloom);
+                    shaderBloomFinal.setUniformFloat("bloomStrength", Bloom::strength(mode.mode));
+                    renderQuad();
+                });
+
+                glBeginQuery(GL_TIME_ELAPSED, query);
+                frameGraph.execute();
+                glEndQuery(GL_TIME_ELAPSED);
+                glFinish();
+                GLuint64 nanoseconds{ 0 };
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+                textureManager->nextFrame();
+                if(frame >= 0) {
+                    result.gpuMs += static_cast<double>(nanoseconds) / 1e6 / frames;
+                }
+            }
+            result.stats = frameGraph.stats();
+            result.fetches = mode.bloom ? bloom.fetches() : 0;
+            // The pool keeps the texture past the frame, nothing has drawn over it since.
+            if(blurredTexture != 0) {
+                result.energy = bloomEnergy(blurredTexture, Bloom::strength(mode.mode), width, height);
+            }
+
+            result.pixels.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+            glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, result.pixels.data());
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            static_cast<void>(writePpm(std::string("bloom_") + mode.name + ".ppm", result.pixels, width, height));
+        }
+
+        glDeleteQueries(1, &query);
+        glDeleteFramebuffers(1, &outputFBO);
+        glDeleteTextures(1, &output);
+        setTextureManager(nullptr);
+    }
+    destroyHeadlessContext(headless);
+
+    std::printf("%dx%d, %d frames, GPU time from timer queries\n\n", width, height, frames);
+    std::printf("%-15s %7s %10s %10s %11s %11s %11s %10s %8s\n", "bloom", "passes", "GPU ms", "bloom ms", "pooled MiB",
+                "written MiB", "read MiB", "Mfetches", "energy");
+    const ModeResult& off = results[0];
+    const ModeResult& gaussian = results[1];
+    for(std::size_t m = 0; m < Modes.size(); ++m) {
+        const ModeResult& result = results[m];
+        std::printf("%-15s %7zu %10.3f %10.3f %11.1f %11.1f %11.1f %10.1f %8.3f\n", Modes[m].name,
+                    result.stats.passes - result.stats.culledPasses, result.gpuMs, result.gpuMs - off.gpuMs,
+                    mebibytes(result.stats.pooledBytes), mebibytes(result.stats.transientBytes),
+                    mebibytes(result.stats.readBytes), static_cast<double>(result.fetches) / 1e6,
+                    result.energy / gaussian.energy);
+    }
+    std::printf("\n");
+    for(std::size_t m = 0; m < Modes.size(); ++m) {
+        if(Modes[m].bloom && Modes[m].gaussian.compute && Modes[m].gaussian.downscale == 1 &&
+           Modes[m].mode == BloomMode::GAUSSIAN) {
+            std::printf("%s differs from gaussian by up to %d/255 per channel\n", Modes[m].name,
+                        maxDifference(results[m].pixels, gaussian.pixels));
+        }
+    }
+    std::printf("\nMfetches are the bloom passes' texture fetches, energy is the light the bloom adds to the HDR frame "
+                "next to the Gaussian bloom's. The frames are in bloom_*.ppm\n");
+    return EXIT_SUCCESS;
+}
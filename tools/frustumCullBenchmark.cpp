@@ -0,0 +1,124 @@
+// Culls a million boxes and a million spheres scattered around the camera against its frustum every frame, once one at
+// a time through intersects() and once through the batched kernels, while the camera turns a full circle. Checks both
+// agree on every frame and prints the time per frame.
+//
+// Usage: frustum_cull_benchmark [count] [frames]
+
+#include <Frustum.hpp>
+
+#include "BenchmarkSupport.hpp"
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+struct CullTimes {
+    double seconds{ 0.0 };
+    std::size_t visible{ 0 };
+};
+
+// The same frustum as the app's, turned yaw degrees about the vertical axis.
+static Frustum frustumAt(const float yaw) {
+    const glm::mat4 projection{ glm::perspective(glm::radians(45.f), 1920.f / 1080.f, .1f, 100.f) };
+    const glm::vec3 front{ std::cos(glm::radians(yaw)), 0.f, std::sin(glm::radians(yaw)) };
+    const glm::mat4 view{ glm::lookAt(glm::vec3(0.f), front, glm::vec3(0.f, 1.f, 0.f)) };
+    return extractFrustum(projection * view);
+}
+
+static void printRow(const char* name, const CullTimes& times, const std::size_t count, const std::size_t frames) {
+    const double msPerFrame{ times.seconds * 1000.0 / static_cast<double>(frames) };
+    std::printf("%-20s %12.3f %14.2f %12.1f%%\n", name, msPerFrame,
+                static_cast<double>(count) / (msPerFrame * 1000.0),
+                100.0 * static_cast<double>(times.visible) / static_cast<double>(count * frames));
+}
+
+int main(int argc, char** argv) {
+    const std::size_t count{ argc > 1 ? std::stoul(argv[1]) : 1'000'000 };
+    const std::size_t frames{ argc > 2 ? std::stoul(argv[2]) : 120 };
+
+    // Boxes and spheres from half a unit to four across, out to twice the far plane so plenty of them straddle it.
+    std::mt19937 random{ 42 };
+    std::uniform_real_distribution<float> position{ -200.f, 200.f };
+    std::uniform_real_distribution<float> size{ .25f, 2.f };
+    std::vector<AABB> boxes(count);
+    std::vector<BoundingSphere> spheres(count);
+    AABBArray boxArray;
+    SphereArray sphereArray;
+    for(std::size_t i = 0; i < count; ++i) {
+        const glm::vec3 centre{ position(random), position(random) * .25f, position(random) };
+        const glm::vec3 extents{ size(random), size(random), size(random) };
+        boxes[i] = AABB{ .min = centre - extents, .max = centre + extents };
+        spheres[i] = BoundingSphere{ .centre = centre, .radius = size(random) };
+        boxArray.push(boxes[i]);
+        sphereArray.push(spheres[i]);
+    }
+
+    std::vector<std::uint32_t> expected, visible(count);
+    expected.reserve(count);
+    CullTimes boxesOneByOne, boxesBatched, spheresOneByOne, spheresBatched;
+    for(std::size_t frame = 0; frame < frames; ++frame) {
+        const Frustum frustum{ frustumAt(360.f * static_cast<float>(frame) / static_cast<float>(frames)) };
+
+        auto start = std::chrono::steady_clock::now();
+        expected.clear();
+        for(std::size_t i = 0; i < count; ++i) {
+            if(intersects(frustum, boxes[i])) {
+                expected.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        boxesOneByOne.seconds += secondsSince(start);
+        boxesOneByOne.visible += expected.size();
+
+        start = std::chrono::steady_clock::now();
+        std::size_t visibleCount{ cullAABBs(frustum, boxArray, visible.data()) };
+        boxesBatched.seconds += secondsSince(start);
+        boxesBatched.visible += visibleCount;
+        if(visibleCount != expected.size() || !std::equal(expected.begin(), expected.end(), visible.begin())) {
+            std::fprintf(stderr, "Box culling disagrees on frame %zu\n", frame);
+            return EXIT_FAILURE;
+        }
+
+        start = std::chrono::steady_clock::now();
+        expected.clear();
+        for(std::size_t i = 0; i < count; ++i) {
+            if(intersects(frustum, spheres[i])) {
+                expected.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        spheresOneByOne.seconds += secondsSince(start);
+        spheresOneByOne.visible += expected.size();
+
+        start = std::chrono::steady_clock::now();
+        visibleCount = cullSpheres(frustum, sphereArray, visible.data());
+        spheresBatched.seconds += secondsSince(start);
+        spheresBatched.visible += visibleCount;
+        if(visibleCount != expected.size() || !std::equal(expected.begin(), expected.end(), visible.begin())) {
+            std::fprintf(stderr, "Sphere culling disagrees on frame %zu\n", frame);
+            return EXIT_FAILURE;
+        }
+    }
+
+#if defined(__AVX__)
+    const char* kernel{ "AVX" };
+#elif defined(__SSE__)
+    const char* kernel{ "SSE" };
+#else
+    const char* kernel{ "scalar" };
+#endif
+    std::printf("%zu bounds, %zu frames, %s kernel\n\n", count, frames, kernel);
+    std::printf("%-20s %12s %14s %13s\n", "culler", "ms/frame", "bounds/us", "visible");
+    printRow("boxes one by one", boxesOneByOne, count, frames);
+    printRow("boxes batched", boxesBatched, count, frames);
+    printRow("spheres one by one", spheresOneByOne, count, frames);
+    printRow("spheres batched", spheresBatched, count, frames);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+// Loads every model under assets/ with the import profiler enabled and prints where the time and memory went, first as
+// a table and then as JSON so runs can be diffed.
+//
+// Usage: import_profiler [assetsDirectory]
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <Model.hpp>
+#include <ImportProfiler.hpp>
+#include <GLExtensions.hpp>
+
+#include "BenchmarkSupport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void printTable(const ImportProfile& profile) {
+    std::printf("\n%s\n", profile.path.c_str());
+    std::printf("  %-34s %8s %12s %14s\n", "stage", "calls", "ms", "allocated KiB");
+    for(const auto& stage : profile.stages) {
+        std::printf("  %-34s %8u %12.3f %14.1f\n", stage.name.c_str(), stage.calls, stage.seconds * 1000.0,
+                    static_cast<double>(stage.allocatedBytes) / 1024.0);
+    }
+    std::printf("  %-34s %8s %12.3f %14.1f\n", "total", "", profile.totalSeconds * 1000.0,
+                static_cast<double>(profile.totalAllocatedBytes) / 1024.0);
+}
+
+static void printJson(const std::vector<ImportProfile>& profiles) {
+    std::printf("[\n");
+    for(std::size_t i = 0; i < profiles.size(); ++i) {
+        const auto& profile = profiles[i];
+        std::printf("  {\n    \"path\": \"%s\",\n    \"totalMs\": %.4f,\n    \"totalAllocatedBytes\": %zu,\n    \"stages\": [\n",
+                    escapeJson(profile.path).c_str(), profile.totalSeconds * 1000.0, profile.totalAllocatedBytes);
+        for(std::size_t j = 0; j < profile.stages.size(); ++j) {
+            const auto& stage = profile.stages[j];
+            std::printf("      { \"name\": \"%s\", \"calls\": %u, \"ms\": %.4f, \"allocatedBytes\": %zu }%s\n",
+                        escapeJson(stage.name).c_str(), stage.calls, stage.seconds * 1000.0, stage.allocatedBytes,
+                        j + 1 < profile.stages.size() ? "," : "");
+        }
+        std::printf("    ]\n  }%s\n", i + 1 < profiles.size() ? "," : "");
+    }
+    std::printf("]\n");
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path assetsDirectory{ argc > 1 ? argv[1] : "./assets" };
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // Textures are uploaded as part of the import, so we need a context, but nobody has to see it.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    auto* window = glfwCreateWindow(64, 64, "import_profiler", nullptr, nullptr);
+    if(!window) {
+        std::cerr << "Failed to create GLFW window\n";
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        return EXIT_FAILURE;
+    }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    std::vector<std::string> paths;
+    const Assimp::Importer importer;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(assetsDirectory)) {
+        if(entry.is_regular_file() && importer.IsExtensionSupported(entry.path().extension().string())) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    if(paths.empty()) {
+        std::cerr << "No model files found under " << assetsDirectory << '\n';
+    }
+
+    std::vector<ImportProfile> profiles(paths.size());
+    for(std::size_t i = 0; i < paths.size(); ++i) {
+        const Model model(paths[i], &profiles[i]);
+        printTable(profiles[i]);
+    }
+
+    std::printf("\n");
+    printJson(profiles);
+
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
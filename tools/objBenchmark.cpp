@@ -0,0 +1,188 @@
+// Compares the native OBJ loader against Assimp on a generated grid mesh. Both sides produce the same thing Model
+// needs: triangulated Vertex and index arrays with smooth normals and flipped UVs. No GL involved.
+//
+// Usage: obj_benchmark [triangles] [path]
+// The file is generated on the first run (10 million triangles is close to 1 GB) and reused afterwards.
+
+#include <ObjLoader.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void appendFloat(std::string& out, const float value) {
+    std::array<char, 32> buffer;
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, 6);
+    out.append(buffer.data(), result.ptr);
+}
+
+static void appendInt(std::string& out, const std::size_t value) {
+    std::array<char, 24> buffer;
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    out.append(buffer.data(), result.ptr);
+}
+
+// A wavy (side + 1) x (side + 1) grid, two triangles per cell, every corner written as v/vt/vn.
+static bool generateObj(const std::string& path, const std::size_t triangles) {
+    const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(triangles) / 2.0)));
+    std::ofstream file(path, std::ios::binary);
+    if(!file.is_open()) {
+        std::cerr << "Could not create " << path << '\n';
+        return false;
+    }
+
+    std::string buffer;
+    auto flush = [&](const bool force) {
+        if(force || buffer.size() > (1 << 22)) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    };
+
+    buffer += "# obj_benchmark grid\n";
+    for(std::size_t z = 0; z <= side; ++z) {
+        for(std::size_t x = 0; x <= side; ++x) {
+            const float fx{ static_cast<float>(x) / static_cast<float>(side) };
+            const float fz{ static_cast<float>(z) / static_cast<float>(side) };
+            buffer += "v ";
+            appendFloat(buffer, fx * 100.f);
+            buffer += ' ';
+            appendFloat(buffer, std::sin(fx * 40.f) * std::cos(fz * 40.f));
+            buffer += ' ';
+            appendFloat(buffer, fz * 100.f);
+            buffer += "\nvt ";
+            appendFloat(buffer, fx);
+            buffer += ' ';
+            appendFloat(buffer, fz);
+            buffer += "\nvn 0.000000 1.000000 0.000000\n";
+            flush(false);
+        }
+    }
+
+    std::size_t written{ 0 };
+    for(std::size_t z = 0; z < side && written < triangles; ++z) {
+        for(std::size_t x = 0; x < side && written < triangles; ++x) {
+            const std::size_t a{ z * (side + 1) + x + 1 };
+            const std::size_t b{ a + 1 };
+            const std::size_t c{ a + side + 1 };
+            const std::size_t d{ c + 1 };
+            for(const auto& face : { std::array<std::size_t, 3>{ a, c, b }, std::array<std::size_t, 3>{ b, c, d } }) {
+                buffer += 'f';
+                for(const auto index : face) {
+                    buffer += ' ';
+                    appendInt(buffer, index);
+                    buffer += '/';
+                    appendInt(buffer, index);
+                    buffer += '/';
+                    appendInt(buffer, index);
+                }
+                buffer += '\n';
+            }
+            written += 2;
+            flush(false);
+        }
+    }
+
+    flush(true);
+    return true;
+}
+
+template<typename Function>
+static double timeSeconds(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    const std::size_t triangles{ argc > 1 ? std::stoul(argv[1]) : 10'000'000 };
+    const std::string path{ argc > 2 ? argv[2] : "/tmp/obj_benchmark_" + std::to_string(triangles) + ".obj" };
+
+    if(!std::filesystem::exists(path)) {
+        std::cout << "Generating " << path << " with " << triangles << " triangles...\n";
+        const double seconds = timeSeconds([&]() { generateObj(path, triangles); });
+        std::cout << "  done in " << seconds << " s\n";
+    }
+
+    const auto bytes = std::filesystem::file_size(path);
+    std::printf("%s: %.1f MiB\n\n", path.c_str(), static_cast<double>(bytes) / (1024.0 * 1024.0));
+    std::printf("%-24s %10s %12s %14s\n", "loader", "seconds", "MiB/s", "vertices");
+
+    auto report = [&](const char* name, const double seconds, const std::size_t vertices) {
+        std::printf("%-24s %10.3f %12.1f %14zu\n", name, seconds,
+                    static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds, vertices);
+    };
+
+    const unsigned int hardwareThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+    std::vector<unsigned int> threadCounts{ 1 };
+    if(hardwareThreads > 1) {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    for(const unsigned int threads : threadCounts) {
+        ObjModel model;
+        bool ok{ false };
+        const double seconds = timeSeconds([&]() { ok = loadObj(path, model, threads); });
+        if(!ok) {
+            return EXIT_FAILURE;
+        }
+
+        std::size_t vertices{ 0 };
+        for(const auto& mesh : model.meshes) {
+            vertices += mesh.vertices.size();
+        }
+        const std::string name{ "native, " + std::to_string(threads) + " thread(s)" };
+        report(name.c_str(), seconds, vertices);
+    }
+
+    // Same conversion as Model::processMesh. Model::loadModel also asks for CalcTangentSpace, but Vertex has nowhere to
+    // keep tangents and the native loader doesn't compute them, so only the steps both sides do are timed here.
+    std::size_t vertices{ 0 };
+    const double seconds = timeSeconds([&]() {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_FlipUVs | aiProcess_Triangulate |
+                                                       aiProcess_GenSmoothNormals);
+        if(!scene) {
+            std::cerr << "ERROR reading file in ASSIMP! " << importer.GetErrorString() << '\n';
+            return;
+        }
+
+        for(unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+            const aiMesh* mesh = scene->mMeshes[m];
+            std::vector<Vertex> meshVertices(mesh->mNumVertices);
+            for(unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+                meshVertices[i].position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+                meshVertices[i].normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+                if(mesh->mTextureCoords[0]) {
+                    meshVertices[i].textureCoordinates = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+                }
+            }
+
+            std::vector<unsigned int> indices;
+            indices.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 3);
+            for(unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+                for(unsigned int j = 0; j < mesh->mFaces[i].mNumIndices; ++j) {
+                    indices.push_back(mesh->mFaces[i].mIndices[j]);
+                }
+            }
+            vertices += meshVertices.size();
+        }
+    });
+    report("Assimp", seconds, vertices);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+// Measures the startup I/O the pack saves: reads every packed asset once the way the loaders used to (fopen and fread
+// of the loose file, as stbi_load and Assimp's default file system do) and once through the mounted pack. Runs are
+// repeated with the page cache dropped for the files involved (cold, like a first launch) and with it warm.
+//
+// Usage: pack_benchmark [pack] [runs]
+
+#include <AssetPack.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Asks the kernel to forget the cached pages of path. Only clean pages are dropped, which is all a reader leaves.
+static void evictFromPageCache(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+// Touches every byte so both sides actually fault the data in.
+static std::uint64_t checksum(const char* data, const std::size_t size) {
+    std::uint64_t sum{ 0 };
+    for(std::size_t i = 0; i < size; ++i) {
+        sum += static_cast<unsigned char>(data[i]);
+    }
+    return sum;
+}
+
+static double readLoose(const std::vector<std::string>& paths, std::uint64_t& sum) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<char> buffer;
+    for(const auto& path : paths) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if(!file) {
+            std::cerr << "Could not open " << path << '\n';
+            continue;
+        }
+        std::fseek(file, 0, SEEK_END);
+        buffer.resize(static_cast<std::size_t>(std::ftell(file)));
+        std::fseek(file, 0, SEEK_SET);
+        const std::size_t read = std::fread(buffer.data(), 1, buffer.size(), file);
+        std::fclose(file);
+        sum += checksum(buffer.data(), read);
+    }
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+static double readPacked(const std::string& packPath, const std::vector<std::string>& paths, std::uint64_t& sum) {
+    const auto start = std::chrono::steady_clock::now();
+    const AssetPack pack(packPath);
+    mountAssetPack(&pack);
+    for(const auto& path : paths) {
+        std::span<const char> bytes;
+        if(findAsset(path, bytes)) {
+            sum += checksum(bytes.data(), bytes.size());
+        }
+    }
+    mountAssetPack(nullptr);
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    const std::string packPath{ argc > 1 ? argv[1] : "./assets.pack" };
+    const int runs{ argc > 2 ? std::max(1, std::stoi(argv[2])) : 5 };
+
+    std::vector<std::string> paths;
+    {
+        const AssetPack pack(packPath);
+        if(!pack.isOpen()) {
+            std::cerr << "Build the pack with asset_packer first\n";
+            return EXIT_FAILURE;
+        }
+        paths = pack.paths();
+    }
+
+    std::uint64_t bytes{ 0 };
+    for(const auto& path : paths) {
+        bytes += std::filesystem::file_size(path);
+    }
+    std::printf("%zu assets, %.1f MiB loose, %.1f MiB packed\n\n", paths.size(),
+                static_cast<double>(bytes) / (1024.0 * 1024.0),
+                static_cast<double>(std::filesystem::file_size(packPath)) / (1024.0 * 1024.0));
+
+    std::vector<double> looseCold, packedCold, looseWarm, packedWarm;
+    std::uint64_t looseSum{ 0 }, packedSum{ 0 };
+    for(int run = 0; run < runs; ++run) {
+        for(const auto& path : paths) {
+            evictFromPageCache(path);
+        }
+        looseCold.push_back(readLoose(paths, looseSum));
+        looseWarm.push_back(readLoose(paths, looseSum));
+
+        evictFromPageCache(packPath);
+        packedCold.push_back(readPacked(packPath, paths, packedSum));
+        packedWarm.push_back(readPacked(packPath, paths, packedSum));
+    }
+
+    if(looseSum != packedSum) {
+        std::cerr << "Pack contents differ from the loose files, rebuild it\n";
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%-8s %14s %14s %10s\n", "cache", "loose ms", "packed ms", "saved");
+    auto report = [](const char* name, const std::vector<double>& loose, const std::vector<double>& packed) {
+        const double looseMs{ median(loose) * 1000.0 };
+        const double packedMs{ median(packed) * 1000.0 };
+        std::printf("%-8s %14.3f %14.3f %9.1f%%\n", name, looseMs, packedMs, (1.0 - packedMs / looseMs) * 100.0);
+    };
+    report("cold", looseCold, packedCold);
+    report("warm", looseWarm, packedWarm);
+
+    return EXIT_SUCCESS;
+}
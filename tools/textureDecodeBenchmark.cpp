@@ -0,0 +1,123 @@
+// Loads the skybox faces, mars.png and the backpack AO map the old way (decode then upload, one image at a time on the
+// context thread) and through a TextureBatch (decodes spread over the worker pool, uploads on the context thread).
+//
+// Usage: texture_decode_benchmark [runs]
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <TextureLoader.hpp>
+#include <ThreadPool.hpp>
+#include <GLExtensions.hpp>
+
+#include "BenchmarkSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const std::array<std::string, 8> Images{
+    "./assets/skybox/right.jpg",
+    "./assets/skybox/left.jpg",
+    "./assets/skybox/top.jpg",
+    "./assets/skybox/bottom.jpg",
+    "./assets/skybox/front.jpg",
+    "./assets/skybox/back.jpg",
+    "./assets/planet/mars.png",
+    "./assets/backpack/ao.jpg",
+};
+
+struct LoadTimes {
+    double decodeSeconds{ 0.0 };
+    double totalSeconds{ 0.0 };
+};
+
+static LoadTimes loadSerial(std::vector<unsigned int>& ids) {
+    LoadTimes times;
+    const auto start = std::chrono::steady_clock::now();
+    for(const auto& path : Images) {
+        DecodedImage image;
+        const auto decodeStart = std::chrono::steady_clock::now();
+        static_cast<void>(decodeImage(path, image));
+        times.decodeSeconds += secondsSince(decodeStart);
+
+        ids.push_back(uploadTexture(image, true));
+        freeImage(image);
+    }
+    glFinish();
+    times.totalSeconds = secondsSince(start);
+    return times;
+}
+
+static double loadBatched(std::vector<unsigned int>& ids) {
+    const auto start = std::chrono::steady_clock::now();
+    TextureBatch batch;
+    for(const auto& path : Images) {
+        batch.add(path, true);
+    }
+
+    const auto batchIds = batch.upload();
+    glFinish();
+    ids.insert(ids.end(), batchIds.begin(), batchIds.end());
+    return secondsSince(start);
+}
+
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    const int runs{ argc > 1 ? std::max(1, std::stoi(argv[1])) : 5 };
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    auto* window = glfwCreateWindow(64, 64, "texture_decode_benchmark", nullptr, nullptr);
+    if(!window) {
+        std::cerr << "Failed to create GLFW window\n";
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        return EXIT_FAILURE;
+    }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    std::printf("%zu images, %zu worker threads, %d runs (median)\n\n", Images.size(), workerPool().size(), runs);
+
+    std::vector<double> serialTotal, serialDecode, batchedTotal;
+    for(int run = 0; run < runs; ++run) {
+        std::vector<unsigned int> ids;
+        const LoadTimes serial = loadSerial(ids);
+        const double batched = loadBatched(ids);
+        glDeleteTextures(static_cast<int>(ids.size()), ids.data());
+
+        serialTotal.push_back(serial.totalSeconds);
+        serialDecode.push_back(serial.decodeSeconds);
+        batchedTotal.push_back(batched);
+    }
+
+    const double serialMs{ median(serialTotal) * 1000.0 };
+    const double decodeMs{ median(serialDecode) * 1000.0 };
+    const double batchedMs{ median(batchedTotal) * 1000.0 };
+    std::printf("%-36s %10.2f ms\n", "serial decode + upload", serialMs);
+    std::printf("%-36s %10.2f ms\n", "  of which decode", decodeMs);
+    std::printf("%-36s %10.2f ms\n", "  of which upload and mips", serialMs - decodeMs);
+    std::printf("%-36s %10.2f ms\n", "batched decode on pool + upload", batchedMs);
+    std::printf("%-36s %10.2fx\n", "speedup", serialMs / batchedMs);
+
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
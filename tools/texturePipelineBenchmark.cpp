@@ -0,0 +1,253 @@
+// Runs every JPG and PNG under assets/ through the texture pipeline one stage at a time, timing decode, mip generation,
+// block compression and upload separately. The CPU stages run once on a single worker and once on threads workers,
+// uploads run on a headless Mesa context through EGL, so no display or window is needed. Prints a table and writes
+// everything as JSON so runs can be diffed as the loaders change.
+//
+// Usage: texture_pipeline_benchmark [output.json] [threads] [assetsDirectory]
+// Defaults to texture_pipeline_benchmark.json, one thread per hardware thread and ./assets.
+
+#include <glad/glad.h>
+
+#include <TextureLoader.hpp>
+#include <ImportProfiler.hpp>
+#include <ThreadPool.hpp>
+#include <GLExtensions.hpp>
+
+#include "BenchmarkSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// In pipeline order. All but the upload run on the workers.
+static constexpr std::array<const char*, 3> CpuStages{ "image decode", "mip generation", "block compression" };
+static constexpr const char* UploadStage{ "GL upload" };
+
+struct Image {
+    std::string path;
+    TextureUsage usage{ TextureUsage::COLOUR };
+    int width{ 0 };
+    int height{ 0 };
+    KtxTexture prepared;
+};
+
+struct Variant {
+    unsigned int threads{ 0 };
+    double wallSeconds{ 0.0 };
+    // One profile per image, recorded on whichever worker prepared it.
+    std::vector<ImportProfile> profiles;
+};
+
+static double stageMs(const ImportProfile& profile, const char* name) {
+    for(const auto& stage : profile.stages) {
+        if(stage.name == name) {
+            return stage.seconds * 1000.0;
+        }
+    }
+    return 0.0;
+}
+
+static double totalStageMs(const std::vector<ImportProfile>& profiles, const char* name) {
+    double ms{ 0.0 };
+    for(const auto& profile : profiles) {
+        ms += stageMs(profile, name);
+    }
+    return ms;
+}
+
+// Decodes and prepares every image on a pool of its own, so the variants don't share workers with anything else.
+// Colour is taken to be sRGB, like the app loads it.
+static Variant prepareAll(std::vector<Image>& images, const unsigned int threads, const bool s3tcSupported) {
+    Variant variant{ .threads = threads, .wallSeconds = 0.0, .profiles = std::vector<ImportProfile>(images.size()) };
+    ThreadPool pool(threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < images.size(); ++i) {
+        pool.submit([&images, &variant, i, s3tcSupported]() {
+            Image& image = images[i];
+            ImportProfile& profile = variant.profiles[i];
+            profile.path = image.path;
+            beginImportProfile(&profile);
+
+            DecodedImage decoded;
+            bool ok{ false };
+            {
+                ScopedImportStage stage(CpuStages[0]);
+                ok = decodeImage(image.path, decoded);
+            }
+            if(ok) {
+                image.width = decoded.width;
+                image.height = decoded.height;
+                image.prepared = prepareTexture(decoded, image.usage, image.usage == TextureUsage::COLOUR,
+                                                s3tcSupported);
+                freeImage(decoded);
+            }
+
+            endImportProfile();
+        });
+    }
+    pool.wait();
+    variant.wallSeconds = secondsSince(start);
+
+    return variant;
+}
+
+// One image at a time, each finished before the next starts, so every upload is timed on its own.
+static std::vector<ImportProfile> uploadAll(const std::vector<Image>& images) {
+    std::vector<ImportProfile> profiles(images.size());
+    for(std::size_t i = 0; i < images.size(); ++i) {
+        if(images[i].prepared.levels.empty()) {
+            continue;
+        }
+        profiles[i].path = images[i].path;
+        beginImportProfile(&profiles[i]);
+        const unsigned int texture{ uploadPreparedTexture(images[i].prepared, images[i].usage == TextureUsage::COLOUR) };
+        endImportProfile();
+        glDeleteTextures(1, &texture);
+    }
+    return profiles;
+}
+
+static std::size_t preparedBytes(const KtxTexture& texture) {
+    std::size_t bytes{ 0 };
+    for(const auto& level : texture.levels) {
+        bytes += level.size();
+    }
+    return bytes;
+}
+
+static void printTable(const std::vector<Image>& images, const std::vector<Variant>& variants,
+                       const std::vector<ImportProfile>& uploads) {
+    const std::vector<ImportProfile>& serial = variants.front().profiles;
+    std::printf("%-44s %11s %9s %9s %9s %9s\n", "image", "size", "decode", "mips", "compress", "upload");
+    for(std::size_t i = 0; i < images.size(); ++i) {
+        const std::string size{ std::to_string(images[i].width) + "x" + std::to_string(images[i].height) };
+        std::printf("%-44s %11s %9.2f %9.2f %9.2f %9.2f\n", images[i].path.c_str(), size.c_str(),
+                    stageMs(serial[i], CpuStages[0]), stageMs(serial[i], CpuStages[1]),
+                    stageMs(serial[i], CpuStages[2]), stageMs(uploads[i], UploadStage));
+    }
+
+    std::printf("\n%-20s %12s", "threads", "wall ms");
+    for(const char* stage : CpuStages) {
+        std::printf(" %18s", stage);
+    }
+    std::printf("\n");
+    for(const auto& variant : variants) {
+        std::printf("%-20u %12.2f", variant.threads, variant.wallSeconds * 1000.0);
+        for(const char* stage : CpuStages) {
+            std::printf(" %18.2f", totalStageMs(variant.profiles, stage));
+        }
+        std::printf("\n");
+    }
+    std::printf("%-20s %12.2f\n", "upload", totalStageMs(uploads, UploadStage));
+}
+
+static bool writeJson(const std::string& path, const std::vector<Image>& images, const std::vector<Variant>& variants,
+                      const std::vector<ImportProfile>& uploads) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if(!file) {
+        std::cerr << "Could not write " << path << '\n';
+        return false;
+    }
+
+    const auto* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    std::fprintf(file, "{\n  \"renderer\": \"%s\",\n  \"uploadMs\": %.4f,\n  \"variants\": [\n",
+                 escapeJson(renderer ? renderer : "").c_str(), totalStageMs(uploads, UploadStage));
+    for(std::size_t v = 0; v < variants.size(); ++v) {
+        const Variant& variant = variants[v];
+        std::fprintf(file, "    {\n      \"threads\": %u,\n      \"wallMs\": %.4f,\n      \"stagesMs\": {", variant.threads,
+                     variant.wallSeconds * 1000.0);
+        for(std::size_t s = 0; s < CpuStages.size(); ++s) {
+            std::fprintf(file, " \"%s\": %.4f%s", CpuStages[s], totalStageMs(variant.profiles, CpuStages[s]),
+                         s + 1 < CpuStages.size() ? "," : " ");
+        }
+        std::fprintf(file, "},\n      \"images\": [\n");
+        for(std::size_t i = 0; i < images.size(); ++i) {
+            const ImportProfile& profile = variant.profiles[i];
+            std::fprintf(file, "        { \"path\": \"%s\", \"width\": %d, \"height\": %d, \"internalFormat\": %u, "
+                               "\"preparedBytes\": %zu, \"decodeMs\": %.4f, \"mipsMs\": %.4f, \"compressMs\": %.4f, "
+                               "\"uploadMs\": %.4f }%s\n",
+                         escapeJson(images[i].path).c_str(), images[i].width, images[i].height,
+                         images[i].prepared.internalFormat, preparedBytes(images[i].prepared),
+                         stageMs(profile, CpuStages[0]), stageMs(profile, CpuStages[1]), stageMs(profile, CpuStages[2]),
+                         stageMs(uploads[i], UploadStage), i + 1 < images.size() ? "," : "");
+        }
+        std::fprintf(file, "      ]\n    }%s\n", v + 1 < variants.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+
+    const bool written{ std::ferror(file) == 0 };
+    std::fclose(file);
+    if(!written) {
+        std::cerr << "Could not write " << path << '\n';
+    }
+    return written;
+}
+
+int main(int argc, char** argv) {
+    const std::string outputPath{ argc > 1 ? argv[1] : "texture_pipeline_benchmark.json" };
+    const unsigned int threads{ argc > 2 ? static_cast<unsigned int>(std::max(1, std::stoi(argv[2])))
+                                         : std::max(1u, std::thread::hardware_concurrency()) };
+    const std::filesystem::path assetsDirectory{ argc > 3 ? argv[3] : "./assets" };
+
+    HeadlessContext headless;
+    if(!createHeadlessContext(headless)) {
+        destroyHeadlessContext(headless);
+        return EXIT_FAILURE;
+    }
+    if(!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        destroyHeadlessContext(headless);
+        return EXIT_FAILURE;
+    }
+    loadGLExtensions((GLADloadproc)eglGetProcAddress);
+
+    std::vector<Image> images;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(assetsDirectory)) {
+        std::string extension{ entry.path().extension().string() };
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](const unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        if(entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png")) {
+            Image image;
+            image.path = entry.path().string();
+            image.usage = inferTextureUsage(image.path);
+            images.push_back(std::move(image));
+        }
+    }
+    std::sort(images.begin(), images.end(), [](const Image& a, const Image& b) { return a.path < b.path; });
+    if(images.empty()) {
+        std::cerr << "No JPG or PNG files found under " << assetsDirectory << '\n';
+        destroyHeadlessContext(headless);
+        return EXIT_FAILURE;
+    }
+
+    // The S3TC extensions can only be asked about here, on the context thread.
+    const bool s3tcSupported{ hasGLExtension("GL_EXT_texture_compression_s3tc") &&
+                              hasGLExtension("GL_EXT_texture_sRGB") };
+    std::printf("%zu images on %s, S3TC %s\n\n", images.size(), glGetString(GL_RENDERER),
+                s3tcSupported ? "on" : "off");
+
+    std::vector<Variant> variants;
+    variants.push_back(prepareAll(images, 1, s3tcSupported));
+    if(threads > 1) {
+        variants.push_back(prepareAll(images, threads, s3tcSupported));
+    }
+    const std::vector<ImportProfile> uploads{ uploadAll(images) };
+
+    printTable(images, variants, uploads);
+    const bool written{ writeJson(outputPath, images, variants, uploads) };
+    if(written) {
+        std::printf("\nWrote %s\n", outputPath.c_str());
+    }
+
+    images.clear();
+    destroyHeadlessContext(headless);
+    return written ? EXIT_SUCCESS : EXIT_FAILURE;
+}
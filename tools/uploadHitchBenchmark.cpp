@@ -0,0 +1,273 @@
+// Flies the camera around an empty sky and, partway through, loads the six 2048x2048 skybox faces, once uploading them
+// all in the frame their decode finishes and once through a TextureUploadQueue. Decoding runs on the worker pool both
+// times, so the difference is the upload alone. Reports how long the worst frames took and how many frames it was
+// before the skybox was complete. Vsync is off.
+//
+// Usage: upload_hitch_benchmark [frames] [queue MiB per frame]
+// Defaults to at least 600 frames, more when the skybox isn't complete by then, and 4 MiB.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <Shader.hpp>
+#include <TextureLoader.hpp>
+#include <TextureManager.hpp>
+#include <TextureUploadQueue.hpp>
+#include <ThreadPool.hpp>
+#include <GLExtensions.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static constexpr unsigned int WindowWidth{ 1280 };
+static constexpr unsigned int WindowHeight{ 720 };
+// Frames flown before the skybox starts loading, so the baseline is settled.
+static constexpr unsigned int LoadFrame{ 120 };
+// A frame longer than this would have been dropped at 60 Hz.
+static constexpr double HitchMs{ 1000.0 / 60.0 };
+// Skybox faces are this size, their storage is allocated before flying so only the uploads land in a frame.
+static constexpr int FaceSize{ 2048 };
+
+// In the order of the GL_TEXTURE_CUBE_MAP_POSITIVE_X + i faces.
+static const std::array<std::string, 6> Faces{
+    "./assets/skybox/right.jpg",
+    "./assets/skybox/left.jpg",
+    "./assets/skybox/top.jpg",
+    "./assets/skybox/bottom.jpg",
+    "./assets/skybox/front.jpg",
+    "./assets/skybox/back.jpg",
+};
+
+struct FlythroughStats {
+    double medianMs;
+    double worstMs;
+    // Frames longer than HitchMs.
+    unsigned int hitches;
+    // From the frame the decodes finished until every face was issued.
+    unsigned int framesToComplete;
+};
+
+static double percentile(std::vector<double> values, const double fraction) {
+    std::sort(values.begin(), values.end());
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+static unsigned int skyboxVAO() {
+    static unsigned int vao{ 0 };
+    if(vao != 0) {
+        return vao;
+    }
+
+    const float vertices[]{
+        -1.f,  1.f, -1.f,  -1.f, -1.f, -1.f,   1.f, -1.f, -1.f,   1.f, -1.f, -1.f,   1.f,  1.f, -1.f,  -1.f,  1.f, -1.f,
+        -1.f, -1.f,  1.f,  -1.f, -1.f, -1.f,  -1.f,  1.f, -1.f,  -1.f,  1.f, -1.f,  -1.f,  1.f,  1.f,  -1.f, -1.f,  1.f,
+         1.f, -1.f, -1.f,   1.f, -1.f,  1.f,   1.f,  1.f,  1.f,   1.f,  1.f,  1.f,   1.f,  1.f, -1.f,   1.f, -1.f, -1.f,
+        -1.f, -1.f,  1.f,  -1.f,  1.f,  1.f,   1.f,  1.f,  1.f,   1.f,  1.f,  1.f,   1.f, -1.f,  1.f,  -1.f, -1.f,  1.f,
+        -1.f,  1.f, -1.f,   1.f,  1.f, -1.f,   1.f,  1.f,  1.f,   1.f,  1.f,  1.f,  -1.f,  1.f,  1.f,  -1.f,  1.f, -1.f,
+        -1.f, -1.f, -1.f,  -1.f, -1.f,  1.f,   1.f, -1.f, -1.f,   1.f, -1.f, -1.f,  -1.f, -1.f,  1.f,   1.f, -1.f,  1.f,
+    };
+    unsigned int vbo{ 0 };
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glBindVertexArray(0);
+    return vao;
+}
+
+// Storage for every face up front, so both runs only differ in how the pixels get there. Some drivers clear new
+// storage, which would otherwise show up as a hitch of its own.
+static unsigned int createCubemap(const int size) {
+    unsigned int texture{ 0 };
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    if(texStorage2D) {
+        texStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_RGB8, size, size);
+    } else {
+        for(unsigned int face = 0; face < Faces.size(); ++face) {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB8, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE,
+                         nullptr);
+        }
+    }
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, 0);
+    manageTexture(texture, GL_TEXTURE_CUBE_MAP, static_cast<std::size_t>(size) * static_cast<std::size_t>(size) * 4 *
+                  Faces.size(), TextureSampler::CLAMP_TO_EDGE);
+    return texture;
+}
+
+static FlythroughStats flythrough(GLFWwindow* window, Shader& shader, const unsigned int frames,
+                                  TextureUploadQueue* queue) {
+    // Faces are copied out of stb_image's memory on the workers too, so the queue can take them without a copy here.
+    std::array<std::vector<unsigned char>, 6> pixels;
+    std::atomic<unsigned int> decoded{ 0 };
+    const unsigned int texture{ createCubemap(FaceSize) };
+    glFinish();
+    bool uploaded{ false };
+    unsigned int readyFrame{ 0 };
+    unsigned int completeFrame{ 0 };
+    bool complete{ false };
+
+    const glm::mat4 projection{ glm::perspective(glm::radians(60.f), static_cast<float>(WindowWidth) / WindowHeight,
+                                                 0.1f, 10.f) };
+
+    std::vector<double> frameMs;
+    frameMs.reserve(frames);
+    auto previous = std::chrono::steady_clock::now();
+    // Flies on past frames until the skybox is up, however long its decodes take.
+    for(unsigned int frame = 0; (frame < frames || !complete) && !glfwWindowShouldClose(window); ++frame) {
+        if(frame == LoadFrame) {
+            for(std::size_t face = 0; face < Faces.size(); ++face) {
+                workerPool().submit([&pixels, &decoded, face]() {
+                    DecodedImage image;
+                    if(decodeImage(Faces[face], image) && image.width == FaceSize && image.height == FaceSize &&
+                       image.components == 3) {
+                        const auto bytes = static_cast<std::size_t>(image.width) *
+                                           static_cast<std::size_t>(image.height) *
+                                           static_cast<std::size_t>(image.components);
+                        pixels[face].assign(image.pixels, image.pixels + bytes);
+                    }
+                    freeImage(image);
+                    ++decoded;
+                });
+            }
+        }
+
+        if(!uploaded && decoded == Faces.size()) {
+            uploaded = true;
+            readyFrame = frame;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            for(unsigned int face = 0; face < Faces.size(); ++face) {
+                if(pixels[face].empty()) {
+                    continue;
+                }
+                if(queue) {
+                    queue->push({
+                        .texture = texture,
+                        .target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
+                        .level = 0,
+                        .width = FaceSize,
+                        .height = FaceSize,
+                        .format = GL_RGB,
+                        .type = GL_UNSIGNED_BYTE,
+                        .data = std::move(pixels[face]),
+                        .onIssued = {},
+                    });
+                } else {
+                    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+                    glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, FaceSize, FaceSize, GL_RGB,
+                                    GL_UNSIGNED_BYTE, pixels[face].data());
+                }
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+        if(queue) {
+            queue->update();
+        }
+        if(uploaded && !complete && (!queue || queue->idle())) {
+            complete = true;
+            completeFrame = frame;
+        }
+
+        glClearColor(0.05f, 0.05f, 0.05f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const float yaw{ static_cast<float>(frame) * 0.01f };
+        const glm::mat4 view{ glm::lookAt(glm::vec3(0.f), glm::vec3(std::sin(yaw), 0.2f, std::cos(yaw)),
+                                          glm::vec3(0.f, 1.f, 0.f)) };
+        shader.use();
+        shader.setMat4("projection", projection);
+        shader.setMat4("view", view);
+        bindTexture(0, GL_TEXTURE_CUBE_MAP, texture);
+        glBindVertexArray(skyboxVAO());
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+
+        const auto now = std::chrono::steady_clock::now();
+        frameMs.push_back(std::chrono::duration<double, std::milli>(now - previous).count());
+        previous = now;
+    }
+
+    workerPool().wait();
+    releaseTexture(texture);
+
+    // The first frames include shader compilation and VAO setup.
+    frameMs.erase(frameMs.begin(), frameMs.begin() + std::min<std::ptrdiff_t>(10, std::ssize(frameMs)));
+    const double median{ percentile(frameMs, 0.5) };
+    return {
+        .medianMs = median,
+        .worstMs = percentile(frameMs, 1.0),
+        .hitches = static_cast<unsigned int>(std::count_if(frameMs.begin(), frameMs.end(), [](const double ms) {
+            return ms > HitchMs;
+        })),
+        .framesToComplete = complete ? completeFrame - readyFrame + 1 : 0,
+    };
+}
+
+int main(int argc, char** argv) {
+    const unsigned int frames{ argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 600 };
+    const std::size_t frameBytes{ (argc > 2 ? std::stoul(argv[2]) : 4) * 1024 * 1024 };
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    auto* window = glfwCreateWindow(WindowWidth, WindowHeight, "upload_hitch_benchmark", nullptr, nullptr);
+    if(!window) {
+        std::cerr << "Failed to create GLFW window\n";
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        return EXIT_FAILURE;
+    }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    glDepthFunc(GL_LEQUAL);
+
+    FlythroughStats direct;
+    FlythroughStats queued;
+    bool persistent{ false };
+    {
+        Shader shader("./shaders/skyboxShader.vs", "./shaders/skyboxShader.fs");
+        shader.use();
+        shader.setUniformInt("skybox", 0);
+
+        direct = flythrough(window, shader, frames, nullptr);
+        TextureUploadQueue queue(frameBytes);
+        persistent = queue.persistentlyMapped();
+        queued = flythrough(window, shader, frames, &queue);
+    }
+
+    std::printf("%zu MiB per frame, %s staging buffer\n\n", frameBytes / (1024 * 1024),
+                persistent ? "persistently mapped" : "mapped per frame");
+    std::printf("%-24s %10s %10s %10s %12s\n", "", "p50 ms", "worst ms", ">16.7 ms", "frames");
+    std::printf("%-24s %10.3f %10.3f %10u %12u\n", "glTexSubImage2D", direct.medianMs, direct.worstMs, direct.hitches,
+                direct.framesToComplete);
+    std::printf("%-24s %10.3f %10.3f %10u %12u\n", "TextureUploadQueue", queued.medianMs, queued.worstMs,
+                queued.hitches, queued.framesToComplete);
+
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}